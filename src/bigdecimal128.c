@@ -47,6 +47,24 @@ static inline UInt oom_estimation_(UInt base, UInt corr_step, UInt prec, const B
 static inline UInt oom_lb_(UInt prec, const BigUInt128 *val);
 static inline UInt oom_ub_(UInt prec, const BigUInt128 *val);
 static buint_bool tune_prec_(BigUInt128 *a, UInt *aprec, UInt trg_prec, buint_bool *has_remainder);
+/**
+ * Checks if a exceeds the largest value whose tenfold is still a non-negative BigInt128, i.e. (2^128 - 1) / 20.
+ * That limit is 0x0CC..CC: every cell is 0xCC..CC, except the most significant one, which is 0x0CC..CC.
+ * The cells are compared against the pattern directly, thus no lazily initialized limit value is needed.
+ * @param a
+ * @return 1 if 20 * a does not fit into 128 bits, 0 otherwise
+ */
+static inline buint_bool mul20_overflows_(const BigUInt128 *a) {
+ static const UInt CELL_PATTERN = ((UInt)-1) / 5u * 4u;
+ buint_size_t i = BIGUINT128_CELLS - 1;
+ UInt lim = CELL_PATTERN >> 4;
+ while (a->dat[i] == lim && 0 < i) {
+  lim = CELL_PATTERN;
+  --i;
+ }
+ return lim < a->dat[i];
+}
+
 static buint_bool compare_(const BigDecimal128 *a, const BigDecimal128 *b, buint_bool lt);
 static inline buint_bool addsub_safe_(BigDecimal128 *dest, const BigDecimal128 *a, const BigDecimal128 *b, buint_bool add);
 
@@ -118,7 +136,7 @@ static inline UInt oom_ub_(UInt prec, const BigUInt128 *val) {
  * @return
  */
 static buint_bool tune_prec_(BigUInt128 *a, UInt *aprec, UInt trg_prec, buint_bool *has_remainder) {
- static BigUInt128 divs[] = {
+ static const BigUInt128 divs[] = {
   {{10}},
   {{100}}
  };
@@ -226,7 +244,7 @@ static buint_bool compare_(const BigDecimal128 *a, const BigDecimal128 *b, buint
 static inline buint_bool addsub_safe_(BigDecimal128 *dest, const BigDecimal128 *a, const BigDecimal128 *b, buint_bool add) {
  buint_bool carry = 0;
  buint_bool retv = 1;
- static void (*fun[])(BigUInt128 *dest, const BigUInt128 *a, const BigUInt128 *b, buint_bool * carry) = {
+ static void (*const fun[])(BigUInt128 *dest, const BigUInt128 *a, const BigUInt128 *b, buint_bool * carry) = {
   biguint128_adc_replace,
   biguint128_sbc_replace
  };
@@ -380,14 +398,6 @@ BigDecimal128 bigdecimal128_div(const BigDecimal128 *a, const BigDecimal128 *b,
 }
 
 buint_bool bigdecimal128_div_safe(BigDecimal128 *dest, const BigDecimal128 *a, const BigDecimal128 *b, UInt prec) {
- static buint_bool first = 1;
- static BigUInt128 max;
- if (first) {
-  BigUInt128 minusone = bigint128_value_of_uint(-1);
-  BigUInt128 maxx = biguint128_div5(&minusone).first;
-  max = biguint128_shr(&maxx, 2);
- first = 0;
- }
  buint_bool ainv, binv;
  BigUInt128 av = bigint128_abs(&a->val, &ainv);
  BigUInt128 bv = bigint128_abs(&b->val, &binv);
@@ -405,7 +415,7 @@ buint_bool bigdecimal128_div_safe(BigDecimal128 *dest, const BigDecimal128 *a, c
    av = qq.second;
    if (i == prec + b->prec) break;
    ++i;
-   if (biguint128_lt(&max, &dest->val)) return 0;
+   if (mul20_overflows_(&dest->val)) return 0;
    dest->val = biguint128_mul10(&dest->val);
    av = biguint128_mul10(&av);
   }
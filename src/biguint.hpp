@@ -0,0 +1,977 @@
+/*****************************************************************************
+
+    Copyright 2020 SZIGETI János
+
+    This file is part of biguint library (Big Unsigned Integers).
+
+    Biguint is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Biguint is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+*****************************************************************************/
+#ifndef _BIGUINT_HPP_
+#define _BIGUINT_HPP_
+
+#include <charconv>
+#include <type_traits>
+
+extern "C" {
+#include "biguint128.h"
+#include "biguintn.h"
+#include "bigdecimal128.h"
+}
+
+/**
+ C++ wrapper of the BigUInt types (header-only, C++17).
+
+ biguint::UInt<Bits> stores its value in the C struct of the width (BigUInt128, or BigUInt256, ...
+ if its header is included before this header), otherwise in a struct of the same layout.
+ The struct is the only member of the class, so the conversions to and from the C structs are zero-copy
+ (c(), view()), and the C functions can be called on the values directly.
+
+ All the operations are constexpr: in constant expressions they run generic code that the compiler folds
+ (multiplication by the schoolbook method, division bit by bit). At runtime, the arithmetic operations,
+ the shifts and the relation 'less than' call the C functions of the width
+ (multiplication and division of the widths without C type call the runtime-length biguintn functions),
+ the fused expressions (see MulExpr, ShlExpr) and the other operations are inline loops over the cells.
+ to_chars() and from_chars() format and parse the values (UInt, Int, and the C structs) as their std:: counterparts.
+*/
+
+#if defined(__cpp_lib_is_constant_evaluated)
+#define BIGUINT_IS_CONSTANT_EVALUATED() std::is_constant_evaluated()
+#elif defined(__has_builtin)
+#if __has_builtin(__builtin_is_constant_evaluated)
+#define BIGUINT_IS_CONSTANT_EVALUATED() __builtin_is_constant_evaluated()
+#endif
+#endif
+#ifndef BIGUINT_IS_CONSTANT_EVALUATED
+// the constexpr code is used at runtime as well
+#define BIGUINT_IS_CONSTANT_EVALUATED() true
+#endif
+
+#if defined(__GNUC__)
+// keeps the register allocation of the long kernels independent of the calling expression
+#define BIGUINT_NOINLINE_ __attribute__((noinline))
+#else
+#define BIGUINT_NOINLINE_
+#endif
+
+namespace biguint {
+
+using Cell = ::UInt;
+
+template <unsigned int Bits> class UInt;
+template <typename U> class MulExpr;
+template <typename U> class ShlExpr;
+
+namespace detail {
+
+constexpr buint_size_t cell_bits = 8u * sizeof(Cell);
+
+/**
+ @brief Cell array of the widths without C type (same layout as the C structs).
+*/
+template <unsigned int Bits>
+struct Cells {
+ Cell dat[Bits / cell_bits];
+};
+
+/**
+ @brief The C type and functions of a width (available for the types whose headers are included).
+*/
+template <unsigned int Bits>
+struct CApi {
+ static constexpr bool available = false;
+ using type = Cells<Bits>;
+};
+
+#define BIGUINT_CXX_CAPI_(W) \
+template <> \
+struct CApi<W> { \
+ static constexpr bool available = true; \
+ using type = BigUInt##W; \
+ using pair_type = BigUIntPair##W; \
+ static type add(const type &a, const type &b) { return biguint##W##_add(&a, &b); } \
+ static type sub(const type &a, const type &b) { return biguint##W##_sub(&a, &b); } \
+ static type mul(const type &a, const type &b) { return biguint##W##_mul(&a, &b); } \
+ static pair_type div(const type &a, const type &b) { return biguint##W##_div(&a, &b); } \
+ static type shl(const type &a, buint_size_t shift) { return biguint##W##_shl(&a, shift); } \
+ static type shr(const type &a, buint_size_t shift) { return biguint##W##_shr(&a, shift); } \
+ static bool lt(const type &a, const type &b) { return biguint##W##_lt(&a, &b); } \
+};
+
+/**
+ @brief Unsigned type to load an integral type from: unsigned long long, or the unsigned type of a wider T (e.g., __int128).
+*/
+template <typename T>
+struct LoadType {
+ using type = std::conditional_t<(sizeof(T) > sizeof(unsigned long long)), std::make_unsigned_t<T>, unsigned long long>;
+};
+
+template <>
+struct LoadType<bool> {
+ using type = unsigned long long;
+};
+
+BIGUINT_CXX_CAPI_(128)
+#ifdef _BIGUINT256_H_
+BIGUINT_CXX_CAPI_(256)
+#endif
+#ifdef _BIGUINT384_H_
+BIGUINT_CXX_CAPI_(384)
+#endif
+#ifdef _BIGUINT512_H_
+BIGUINT_CXX_CAPI_(512)
+#endif
+
+/**
+ @brief Product of two cells, by the double-width type if there is one, otherwise by half-cell products
+ (usable in constant expressions).
+ @param hi Output: high cell of the product.
+ @return Low cell of the product.
+*/
+constexpr Cell mul_cell(Cell a, Cell b, Cell &hi) noexcept {
+#ifdef HAVE_DUINT
+ DUInt p = DUInt(a) * b;
+ hi = Cell(p >> cell_bits);
+ return Cell(p);
+#else
+ constexpr buint_size_t h = cell_bits / 2;
+ constexpr Cell mask = (Cell(1) << h) - 1;
+ Cell ll = (a & mask) * (b & mask);
+ Cell lh = (a & mask) * (b >> h);
+ Cell hl = (a >> h) * (b & mask);
+ Cell hh = (a >> h) * (b >> h);
+ Cell mid = (ll >> h) + (lh & mask) + (hl & mask);
+ hi = hh + (lh >> h) + (hl >> h) + (mid >> h);
+ return (mid << h) | (ll & mask);
+#endif
+}
+
+/**
+ @brief Multiply-add by cells: a = a * m + c.
+ @return Carry out (the cell over the length of a).
+*/
+template <buint_size_t N>
+constexpr Cell muladd_cell(Cell (&a)[N], Cell m, Cell c) noexcept {
+ for (buint_size_t i = 0; i < N; ++i) {
+  Cell hi = 0;
+  Cell lo = mul_cell(a[i], m, hi);
+  lo += c;
+  hi += lo < c;
+  a[i] = lo;
+  c = hi;
+ }
+ return c;
+}
+
+/**
+ @brief Addition with carry: r = a + b + c (r may be the same as a or b).
+ @return Carry out.
+*/
+template <buint_size_t N>
+constexpr bool add(Cell (&r)[N], const Cell (&a)[N], const Cell (&b)[N], bool c) noexcept {
+ for (buint_size_t i = 0; i < N; ++i) {
+  Cell s = a[i] + b[i];
+  bool c1 = s < b[i];
+  Cell t = s + c;
+  c = c1 | (t < s);
+  r[i] = t;
+ }
+ return c;
+}
+
+/**
+ @brief Subtraction with borrow: r = a - b - c (r may be the same as a or b).
+ @return Borrow out.
+*/
+template <buint_size_t N>
+constexpr bool sub(Cell (&r)[N], const Cell (&a)[N], const Cell (&b)[N], bool c) noexcept {
+ for (buint_size_t i = 0; i < N; ++i) {
+  Cell d = a[i] - b[i];
+  bool c1 = a[i] < b[i];
+  Cell t = d - c;
+  c = c1 | (d < Cell(c));
+  r[i] = t;
+ }
+ return c;
+}
+
+/**
+ @brief 'Less than' relation.
+*/
+template <buint_size_t N>
+constexpr bool lt(const Cell (&a)[N], const Cell (&b)[N]) noexcept {
+ for (buint_size_t i = N; 0 < i--;) {
+  if (a[i] != b[i]) return a[i] < b[i];
+ }
+ return false;
+}
+
+/**
+ @brief Shift left by any amount (r may be the same as a: the cells are written downwards).
+*/
+template <buint_size_t N>
+constexpr void shl(Cell (&r)[N], const Cell (&a)[N], buint_size_t shift) noexcept {
+ buint_size_t cells = shift / cell_bits;
+ buint_size_t bits = shift % cell_bits;
+ for (buint_size_t i = N; 0 < i--;) {
+  Cell hi = cells <= i ? a[i - cells] : 0;
+  Cell lo = cells < i ? a[i - cells - 1] : 0;
+  r[i] = bits ? (hi << bits) | (lo >> (cell_bits - bits)) : hi;
+ }
+}
+
+/**
+ @brief Shift right by any amount (r may be the same as a: the cells are written upwards).
+*/
+template <buint_size_t N>
+constexpr void shr(Cell (&r)[N], const Cell (&a)[N], buint_size_t shift) noexcept {
+ buint_size_t cells = shift / cell_bits;
+ buint_size_t bits = shift % cell_bits;
+ for (buint_size_t i = 0; i < N; ++i) {
+  Cell lo = cells < N - i ? a[i + cells] : 0;
+  Cell hi = cells + 1 < N - i ? a[i + cells + 1] : 0;
+  r[i] = bits ? (lo >> bits) | (hi << (cell_bits - bits)) : lo;
+ }
+}
+
+/**
+ @brief Shift left and bitwise or in a single pass: r = (a << shift) | b
+ (r may be the same as a or b: the cells are written downwards).
+*/
+template <buint_size_t N>
+constexpr void shl_or(Cell (&r)[N], const Cell (&a)[N], buint_size_t shift, const Cell (&b)[N]) noexcept {
+ buint_size_t cells = shift / cell_bits;
+ buint_size_t bits = shift % cell_bits;
+ for (buint_size_t i = N; 0 < i--;) {
+  Cell hi = cells <= i ? a[i - cells] : 0;
+  Cell lo = cells < i ? a[i - cells - 1] : 0;
+  r[i] = (hi << bits) | ((lo >> 1) >> (cell_bits - 1 - bits)) | b[i];
+ }
+}
+
+/**
+ @brief Multiply-accumulate step of the product scanning: (acc2:acc1:acc0) += a * b.
+*/
+constexpr void mac(Cell &acc0, Cell &acc1, Cell &acc2, Cell a, Cell b) noexcept {
+#if defined(HAVE_DUINT) && defined(USE_CARRY_BUILTINS) && defined(HAVE_BUILTIN_ADD_OVERFLOW)
+ DUInt acc = (DUInt(acc1) << cell_bits) | acc0;
+ acc2 += __builtin_add_overflow(acc, DUInt(a) * b, &acc);
+ acc0 = Cell(acc);
+ acc1 = Cell(acc >> cell_bits);
+#else
+ Cell hi = 0;
+ Cell lo = mul_cell(a, b, hi);
+ acc0 += lo;
+ hi += acc0 < lo;
+ acc1 += hi;
+ acc2 += acc1 < hi;
+#endif
+}
+
+/**
+ @brief Truncated product scanning multiply-add: r = a * b + c (lowest N cells).
+ Cell k of c is added to the accumulator of column k, thus the product is not stored separately
+ (r may be the same as a, b or c).
+*/
+template <buint_size_t N>
+BIGUINT_NOINLINE_ constexpr void mul_add(Cell (&r)[N], const Cell (&a)[N], const Cell (&b)[N], const Cell (&c)[N]) noexcept {
+ Cell t[N] = {};
+ Cell acc0 = 0;
+ Cell acc1 = 0;
+ Cell acc2 = 0;
+ for (buint_size_t k = 0; k < N; ++k) {
+  acc0 += c[k];
+  acc1 += acc0 < c[k];
+  for (buint_size_t i = 0; i <= k; ++i) mac(acc0, acc1, acc2, a[i], b[k - i]);
+  t[k] = acc0;
+  acc0 = acc1;
+  acc1 = acc2;
+  acc2 = 0;
+ }
+ for (buint_size_t i = 0; i < N; ++i) r[i] = t[i];
+}
+
+/**
+ @brief Truncated multiply-subtract: r = c - a * b (lowest N cells).
+ Computed as ~(~c + a * b) by the multiply-add (r may be the same as a, b or c).
+*/
+template <buint_size_t N>
+constexpr void mul_sub(Cell (&r)[N], const Cell (&a)[N], const Cell (&b)[N], const Cell (&c)[N]) noexcept {
+ Cell t[N] = {};
+ for (buint_size_t i = 0; i < N; ++i) t[i] = ~c[i];
+ mul_add(t, a, b, t);
+ for (buint_size_t i = 0; i < N; ++i) r[i] = ~t[i];
+}
+
+/**
+ @brief Truncated product scanning multiplication: r = a * b (lowest N cells; r may be the same as a or b).
+*/
+template <buint_size_t N>
+constexpr void mul(Cell (&r)[N], const Cell (&a)[N], const Cell (&b)[N]) noexcept {
+ Cell z[N] = {};
+ mul_add(r, a, b, z);
+}
+
+/**
+ @brief Division bit by bit (restoring method): q = a / b, r = a % b.
+ If b is 0, the quotient is 0 and the remainder is a (as in the C functions).
+*/
+template <buint_size_t N>
+constexpr void divmod(Cell (&q)[N], Cell (&r)[N], const Cell (&a)[N], const Cell (&b)[N]) noexcept {
+ Cell qq[N] = {};
+ Cell rr[N] = {};
+ bool bz = true;
+ for (buint_size_t i = 0; i < N; ++i) bz &= b[i] == 0;
+ if (bz) {
+  for (buint_size_t i = 0; i < N; ++i) rr[i] = a[i];
+ } else {
+  for (buint_size_t bit = N * cell_bits; 0 < bit--;) {
+   bool top = rr[N - 1] >> (cell_bits - 1);
+   shl(rr, rr, 1);
+   rr[0] |= (a[bit / cell_bits] >> (bit % cell_bits)) & 1u;
+   if (top || !lt(rr, b)) {
+    sub(rr, rr, b, false);
+    qq[bit / cell_bits] |= Cell(1) << (bit % cell_bits);
+   }
+  }
+ }
+ for (buint_size_t i = 0; i < N; ++i) {
+  q[i] = qq[i];
+  r[i] = rr[i];
+ }
+}
+
+} // namespace detail
+
+/**
+ @brief Unsigned integer of Bits bits (a multiple of the cell width).
+*/
+template <unsigned int Bits>
+class UInt {
+ static_assert(0 < Bits && Bits % detail::cell_bits == 0, "Bits must be a positive multiple of the cell width");
+ template <unsigned int> friend class UInt;
+ template <typename> friend class MulExpr;
+
+public:
+ /// The C struct storing the value.
+ using c_type = typename detail::CApi<Bits>::type;
+ /// Number of bits.
+ static constexpr unsigned int bits = Bits;
+ /// Number of cells.
+ static constexpr buint_size_t cells = Bits / detail::cell_bits;
+
+ constexpr UInt() noexcept : val_{} {}
+
+ /**
+  @brief Conversion from built-in integer types (modulo 2^Bits, as the conversions of the built-in types).
+  The value is loaded cell by cell, types wider than a cell (e.g., __int128) are not truncated,
+  negative values are sign-extended.
+ */
+ template <typename T, std::enable_if_t<std::is_integral<T>::value, int> = 0>
+ constexpr UInt(T v) noexcept : val_{} {
+  using U = typename detail::LoadType<T>::type;
+  U x = static_cast<U>(v);
+  Cell fill = v < T(0) ? ~Cell(0) : Cell(0);
+  for (buint_size_t i = 0; i < cells; ++i) {
+   val_.dat[i] = i * detail::cell_bits < 8u * sizeof(U) ? Cell(x >> (i * detail::cell_bits)) : fill;
+  }
+ }
+
+ /**
+  @brief Conversion from other widths (zero-extension or truncation).
+ */
+ template <unsigned int B2>
+ constexpr explicit UInt(const UInt<B2> &a) noexcept : val_{} {
+  for (buint_size_t i = 0; i < cells && i < UInt<B2>::cells; ++i) val_.dat[i] = a.val_.dat[i];
+ }
+
+ /**
+  @brief Conversion from the C struct (copy).
+ */
+ constexpr explicit UInt(const c_type &c) noexcept : val_(c) {}
+
+ /**
+  @brief The C struct of the value (zero-copy).
+ */
+ constexpr const c_type &c() const noexcept { return val_; }
+ constexpr c_type &c() noexcept { return val_; }
+
+ /**
+  @brief The C struct as UInt (zero-copy: the struct is the only member of the class).
+ */
+ static UInt &view(c_type &c) noexcept {
+  static_assert(std::is_standard_layout<UInt>::value && sizeof(UInt) == sizeof(c_type), "UInt must be layout-compatible with its C struct");
+  return reinterpret_cast<UInt &>(c);
+ }
+ static const UInt &view(const c_type &c) noexcept {
+  static_assert(std::is_standard_layout<UInt>::value && sizeof(UInt) == sizeof(c_type), "UInt must be layout-compatible with its C struct");
+  return reinterpret_cast<const UInt &>(c);
+ }
+
+ /**
+  @brief Cell i of the value (least significant cell at index 0).
+ */
+ constexpr Cell cell(buint_size_t i) const noexcept { return val_.dat[i]; }
+
+ constexpr explicit operator bool() const noexcept {
+  Cell d = 0;
+  for (buint_size_t i = 0; i < cells; ++i) d |= val_.dat[i];
+  return d != 0;
+ }
+
+ // ### Arithmetic
+ constexpr UInt &operator+=(const UInt &b) noexcept { return *this = *this + b; }
+ constexpr UInt &operator-=(const UInt &b) noexcept { return *this = *this - b; }
+ constexpr UInt &operator*=(const UInt &b) noexcept { return *this = *this * b; }
+ constexpr UInt &operator/=(const UInt &b) noexcept {
+  UInt r;
+  divmod_(*this, r, *this, b);
+  return *this;
+ }
+ constexpr UInt &operator%=(const UInt &b) noexcept {
+  UInt q;
+  divmod_(q, *this, *this, b);
+  return *this;
+ }
+ constexpr UInt &operator++() noexcept { return *this += UInt(1); }
+ constexpr UInt &operator--() noexcept { return *this -= UInt(1); }
+ constexpr UInt operator++(int) noexcept {
+  UInt retv = *this;
+  ++*this;
+  return retv;
+ }
+ constexpr UInt operator--(int) noexcept {
+  UInt retv = *this;
+  --*this;
+  return retv;
+ }
+
+ /**
+  @brief Division with remainder.
+  If b is 0, the quotient is 0 and the remainder is a (as in the C functions).
+ */
+ static constexpr void divmod(UInt &q, UInt &r, const UInt &a, const UInt &b) noexcept {
+  divmod_(q, r, a, b);
+ }
+
+ // ### Bitwise
+ constexpr UInt &operator<<=(buint_size_t shift) noexcept { return *this = *this << shift; }
+ constexpr UInt &operator>>=(buint_size_t shift) noexcept { return *this = *this >> shift; }
+ constexpr UInt &operator&=(const UInt &b) noexcept {
+  for (buint_size_t i = 0; i < cells; ++i) val_.dat[i] &= b.val_.dat[i];
+  return *this;
+ }
+ constexpr UInt &operator|=(const UInt &b) noexcept {
+  for (buint_size_t i = 0; i < cells; ++i) val_.dat[i] |= b.val_.dat[i];
+  return *this;
+ }
+ constexpr UInt &operator^=(const UInt &b) noexcept {
+  for (buint_size_t i = 0; i < cells; ++i) val_.dat[i] ^= b.val_.dat[i];
+  return *this;
+ }
+ friend constexpr UInt operator~(const UInt &a) noexcept {
+  UInt retv;
+  for (buint_size_t i = 0; i < cells; ++i) retv.val_.dat[i] = ~a.val_.dat[i];
+  return retv;
+ }
+ friend constexpr UInt operator-(const UInt &a) noexcept { return UInt() - a; }
+
+ friend constexpr UInt operator+(const UInt &a, const UInt &b) noexcept {
+  if constexpr (detail::CApi<Bits>::available) {
+   if (!BIGUINT_IS_CONSTANT_EVALUATED()) return UInt(detail::CApi<Bits>::add(a.val_, b.val_));
+  }
+  UInt retv;
+  detail::add(retv.val_.dat, a.val_.dat, b.val_.dat, false);
+  return retv;
+ }
+ friend constexpr UInt operator-(const UInt &a, const UInt &b) noexcept {
+  if constexpr (detail::CApi<Bits>::available) {
+   if (!BIGUINT_IS_CONSTANT_EVALUATED()) return UInt(detail::CApi<Bits>::sub(a.val_, b.val_));
+  }
+  UInt retv;
+  detail::sub(retv.val_.dat, a.val_.dat, b.val_.dat, false);
+  return retv;
+ }
+ friend constexpr MulExpr<UInt> operator*(const UInt &a, const UInt &b) noexcept { return MulExpr<UInt>(a, b); }
+ // temporary operands are multiplied immediately (the expression object would outlive them)
+ friend constexpr UInt operator*(UInt &&a, const UInt &b) noexcept { return MulExpr<UInt>(a, b).eval(); }
+ friend constexpr UInt operator*(const UInt &a, UInt &&b) noexcept { return MulExpr<UInt>(a, b).eval(); }
+ friend constexpr UInt operator*(UInt &&a, UInt &&b) noexcept { return MulExpr<UInt>(a, b).eval(); }
+ friend constexpr UInt operator/(UInt a, const UInt &b) noexcept { return a /= b; }
+ friend constexpr UInt operator%(UInt a, const UInt &b) noexcept { return a %= b; }
+ friend constexpr ShlExpr<UInt> operator<<(const UInt &a, buint_size_t shift) noexcept { return ShlExpr<UInt>(a, shift); }
+ friend constexpr UInt operator<<(UInt &&a, buint_size_t shift) noexcept { return ShlExpr<UInt>(a, shift).eval(); }
+ friend constexpr UInt operator>>(const UInt &a, buint_size_t shift) noexcept {
+  if constexpr (detail::CApi<Bits>::available) {
+   if (!BIGUINT_IS_CONSTANT_EVALUATED()) return UInt(detail::CApi<Bits>::shr(a.val_, shift));
+  }
+  UInt retv;
+  detail::shr(retv.val_.dat, a.val_.dat, shift);
+  return retv;
+ }
+ friend constexpr UInt operator&(UInt a, const UInt &b) noexcept { return a &= b; }
+ friend constexpr UInt operator|(UInt a, const UInt &b) noexcept { return a |= b; }
+ friend constexpr UInt operator^(UInt a, const UInt &b) noexcept { return a ^= b; }
+
+ // ### Relations
+ friend constexpr bool operator==(const UInt &a, const UInt &b) noexcept {
+  Cell d = 0;
+  for (buint_size_t i = 0; i < cells; ++i) d |= a.val_.dat[i] ^ b.val_.dat[i];
+  return d == 0;
+ }
+ friend constexpr bool operator!=(const UInt &a, const UInt &b) noexcept { return !(a == b); }
+ friend constexpr bool operator<(const UInt &a, const UInt &b) noexcept {
+  if constexpr (detail::CApi<Bits>::available) {
+   if (!BIGUINT_IS_CONSTANT_EVALUATED()) return detail::CApi<Bits>::lt(a.val_, b.val_);
+  }
+  return detail::lt(a.val_.dat, b.val_.dat);
+ }
+ friend constexpr bool operator>(const UInt &a, const UInt &b) noexcept { return b < a; }
+ friend constexpr bool operator<=(const UInt &a, const UInt &b) noexcept { return !(b < a); }
+ friend constexpr bool operator>=(const UInt &a, const UInt &b) noexcept { return !(a < b); }
+
+private:
+ c_type val_;
+
+ static constexpr void divmod_(UInt &q, UInt &r, const UInt &a, const UInt &b) noexcept {
+  if (BIGUINT_IS_CONSTANT_EVALUATED()) {
+   detail::divmod(q.val_.dat, r.val_.dat, a.val_.dat, b.val_.dat);
+  } else {
+   divmod_rt_(q, r, a, b);
+  }
+ }
+
+ static void mul_rt_(UInt &r, const UInt &a, const UInt &b) noexcept {
+  if constexpr (detail::CApi<Bits>::available) {
+   r.val_ = detail::CApi<Bits>::mul(a.val_, b.val_);
+  } else {
+   Cell prod[2 * cells];
+   Cell scratch[BIGUINTN_MUL_SCRATCH(cells, cells)];
+   buint_size_t na = biguintn_lzc(a.val_.dat, cells);
+   buint_size_t nb = biguintn_lzc(b.val_.dat, cells);
+   biguintn_mul(prod, a.val_.dat, na, b.val_.dat, nb, scratch);
+   for (buint_size_t i = 0; i < cells; ++i) r.val_.dat[i] = i < na + nb ? prod[i] : 0;
+  }
+ }
+
+ static void divmod_rt_(UInt &q, UInt &r, const UInt &a, const UInt &b) noexcept {
+  if constexpr (detail::CApi<Bits>::available) {
+   typename detail::CApi<Bits>::pair_type qr = detail::CApi<Bits>::div(a.val_, b.val_);
+   q.val_ = qr.first;
+   r.val_ = qr.second;
+  } else {
+   Cell qc[cells];
+   Cell rc[cells];
+   Cell scratch[BIGUINTN_DIV_SCRATCH(cells, cells)];
+   if (!biguintn_div(qc, rc, a.val_.dat, cells, b.val_.dat, cells, scratch)) {
+    for (buint_size_t i = 0; i < cells; ++i) {
+     qc[i] = 0;
+     rc[i] = a.val_.dat[i];
+    }
+   }
+   for (buint_size_t i = 0; i < cells; ++i) {
+    q.val_.dat[i] = qc[i];
+    r.val_.dat[i] = rc[i];
+   }
+  }
+ }
+};
+
+/**
+ Expression templates.
+
+ a * b and a << k are not evaluated immediately: they yield expression objects referring to the operands,
+ which are evaluated when they are converted to UInt, or fused with the next operation:
+ a * b + c, c + a * b (multiply-add) and c - a * b (multiply-subtract) accumulate the product into c
+ (in constant expressions, and below the Karatsuba cutoff; wider products are calculated by the C functions
+ and added separately), (a << k) | b shifts and combines the cells in the same pass;
+ the product or the shifted value is not stored as intermediate UInt.
+ Other operations convert the expression objects to UInt (e.g., a * b * c, (a << k) >> j).
+ Temporary operands are evaluated immediately (e.g., (a + b) * c is UInt), so that no expression object refers to them.
+ The expression objects are not copyable, but C++17 can not reject auto x = a * b; (x refers to a and b),
+ thus they are not to be stored: U x = a * b; is evaluated.
+*/
+
+/**
+ @brief Product a * b (not evaluated yet).
+*/
+template <typename U>
+class MulExpr {
+public:
+ constexpr MulExpr(const U &a, const U &b) noexcept : a_(a), b_(b) {}
+ MulExpr(const MulExpr &) = delete;
+ MulExpr &operator=(const MulExpr &) = delete;
+
+ /**
+  @brief Value of the product.
+ */
+ constexpr U eval() const noexcept {
+  U retv;
+  if (BIGUINT_IS_CONSTANT_EVALUATED()) {
+   detail::mul(retv.c().dat, a_.c().dat, b_.c().dat);
+  } else {
+   U::mul_rt_(retv, a_, b_);
+  }
+  return retv;
+ }
+ constexpr operator U() const noexcept { return eval(); }
+ constexpr explicit operator bool() const noexcept { return static_cast<bool>(eval()); }
+
+ /**
+  @brief Multiply-add: a * b + c.
+ */
+ friend constexpr U operator+(const MulExpr &x, const U &c) noexcept {
+  if (!fused_ && !BIGUINT_IS_CONSTANT_EVALUATED()) return x.eval() + c;
+  U retv;
+  detail::mul_add(retv.c().dat, x.a_.c().dat, x.b_.c().dat, c.c().dat);
+  return retv;
+ }
+ friend constexpr U operator+(const U &c, const MulExpr &x) noexcept { return x + c; }
+ friend constexpr U operator+(const MulExpr &x, const MulExpr &y) noexcept { return x + y.eval(); }
+
+ /**
+  @brief Multiply-subtract: c - a * b.
+ */
+ friend constexpr U operator-(const U &c, const MulExpr &x) noexcept {
+  if (!fused_ && !BIGUINT_IS_CONSTANT_EVALUATED()) return c - x.eval();
+  U retv;
+  detail::mul_sub(retv.c().dat, x.a_.c().dat, x.b_.c().dat, c.c().dat);
+  return retv;
+ }
+
+private:
+ /// The quadratic fused loop is used at runtime below the Karatsuba cutoff of the C functions.
+ static constexpr bool fused_ = U::cells < BIGUINTN_KARATSUBA_CELLS;
+
+ const U &a_;
+ const U &b_;
+};
+
+/**
+ @brief Shifted value a << shift (not evaluated yet).
+*/
+template <typename U>
+class ShlExpr {
+public:
+ constexpr ShlExpr(const U &a, buint_size_t shift) noexcept : a_(a), shift_(shift) {}
+ ShlExpr(const ShlExpr &) = delete;
+ ShlExpr &operator=(const ShlExpr &) = delete;
+
+ /**
+  @brief Value of the shifted value.
+ */
+ constexpr U eval() const noexcept {
+  if constexpr (detail::CApi<U::bits>::available) {
+   if (!BIGUINT_IS_CONSTANT_EVALUATED()) return U(detail::CApi<U::bits>::shl(a_.c(), shift_));
+  }
+  U retv;
+  detail::shl(retv.c().dat, a_.c().dat, shift_);
+  return retv;
+ }
+ constexpr operator U() const noexcept { return eval(); }
+ constexpr explicit operator bool() const noexcept { return static_cast<bool>(eval()); }
+
+ /**
+  @brief Shift and bitwise or: (a << shift) | b.
+ */
+ friend constexpr U operator|(const ShlExpr &x, const U &b) noexcept {
+  U retv;
+  detail::shl_or(retv.c().dat, x.a_.c().dat, x.shift_, b.c().dat);
+  return retv;
+ }
+ friend constexpr U operator|(const U &b, const ShlExpr &x) noexcept { return x | b; }
+ friend constexpr U operator|(const ShlExpr &x, const ShlExpr &y) noexcept { return x | y.eval(); }
+
+private:
+ const U &a_;
+ buint_size_t shift_;
+};
+
+namespace detail {
+
+/**
+ @brief Value of a parsed literal.
+*/
+template <unsigned int Bits>
+struct Parsed {
+ UInt<Bits> value;
+ buint_size_t prec;	///< Number of digits after the decimal point.
+ bool valid;	///< The literal is well-formed and its value fits into the type.
+};
+
+/**
+ @brief Value of a digit character in base 36 (36 if c is not a digit).
+*/
+constexpr unsigned int digit_value(char c) noexcept {
+ return '0' <= c && c <= '9' ? unsigned(c - '0')
+  : 'a' <= c && c <= 'z' ? unsigned(c - 'a' + 10)
+  : 'A' <= c && c <= 'Z' ? unsigned(c - 'A' + 10) : 36u;
+}
+
+/**
+ @brief Parses the characters of a numeric literal (digit separators are skipped).
+ @param decimal False: integer literal (decimal, 0x hexadecimal, 0b binary or 0 octal).
+ True: decimal fraction with optional exponent (e.g., 1.25, 5e-3), whose value must fit into Bits - 1 bits.
+*/
+template <unsigned int Bits>
+constexpr Parsed<Bits> parse_literal(const char *s, buint_size_t len, bool decimal) noexcept {
+ Parsed<Bits> retv{UInt<Bits>(), 0, true};
+ Cell base = 10;
+ buint_size_t i = 0;
+ buint_size_t digits = 0;
+ bool frac = false;
+ if (!decimal && 2 < len && s[0] == '0' && (s[1] == 'x' || s[1] == 'X')) {
+  base = 16;
+  i = 2;
+ } else if (!decimal && 2 < len && s[0] == '0' && (s[1] == 'b' || s[1] == 'B')) {
+  base = 2;
+  i = 2;
+ } else if (!decimal && 1 < len && s[0] == '0') {
+  base = 8;
+  i = 1;
+ }
+ for (; i < len && retv.valid; ++i) {
+  if (s[i] == '\'') continue;
+  if (decimal && s[i] == '.' && !frac) {
+   frac = true;
+   continue;
+  }
+  if (decimal && (s[i] == 'e' || s[i] == 'E')) break;
+  unsigned int d = digit_value(s[i]);
+  retv.valid = d < base && muladd_cell(retv.value.c().dat, base, d) == 0;
+  retv.prec += frac;
+  ++digits;
+ }
+ retv.valid &= 0 < digits;
+ if (decimal && i < len && retv.valid) {
+  ++i;
+  bool neg = i < len && s[i] == '-';
+  buint_size_t exp = 0;
+  i += neg || (i < len && s[i] == '+');
+  retv.valid = i < len;
+  for (; i < len && retv.valid; ++i) {
+   unsigned int d = digit_value(s[i]);
+   exp = exp * 10 + d;
+   retv.valid = d < 10 && exp <= Bits;
+  }
+  if (neg) {
+   retv.prec += exp;
+  } else if (exp <= retv.prec) {
+   retv.prec -= exp;
+  } else {
+   for (exp -= retv.prec; 0 < exp && retv.valid; --exp) {
+    retv.valid = muladd_cell(retv.value.c().dat, 10, 0) == 0;
+   }
+   retv.prec = 0;
+  }
+ }
+ if (decimal) retv.valid &= !(retv.value >> (Bits - 1)) && retv.prec <= Cell(-1);
+ return retv;
+}
+
+/**
+ @brief The value of a literal, parsed at compile time.
+*/
+template <unsigned int Bits, bool Decimal, char... Cs>
+struct Literal {
+ static constexpr char str[sizeof...(Cs)] = {Cs...};
+ static constexpr Parsed<Bits> parsed = parse_literal<Bits>(str, sizeof...(Cs), Decimal);
+ static_assert(parsed.valid, "invalid literal, or its value does not fit into the type");
+};
+
+} // namespace detail
+
+/**
+ User-defined literals of the standard widths (using namespace biguint::literals):
+ _u128, _u256, _u384, _u512 yield UInt values (decimal, 0x hexadecimal, 0b binary and 0 octal literals),
+ _d128 (and _d256, ... if their headers are included before this header) yields BigDecimal values
+ (e.g., 3.14159_d128, 1e-20_d128, 12.5e3_d128).
+ The literals are parsed by the compiler: a literal that does not fit into the type does not compile.
+*/
+namespace literals {
+
+#define BIGUINT_CXX_LITERAL_(W) \
+template <char... Cs> \
+constexpr UInt<W> operator"" _u##W() noexcept { return detail::Literal<W, false, Cs...>::parsed.value; }
+
+#define BIGUINT_CXX_DEC_LITERAL_(W) \
+template <char... Cs> \
+constexpr BigDecimal##W operator"" _d##W() noexcept { \
+ return BigDecimal##W{detail::Literal<W, true, Cs...>::parsed.value.c(), Cell(detail::Literal<W, true, Cs...>::parsed.prec)}; \
+}
+
+BIGUINT_CXX_LITERAL_(128)
+BIGUINT_CXX_LITERAL_(256)
+BIGUINT_CXX_LITERAL_(384)
+BIGUINT_CXX_LITERAL_(512)
+BIGUINT_CXX_DEC_LITERAL_(128)
+#ifdef _BIGDECIMAL256_H_
+BIGUINT_CXX_DEC_LITERAL_(256)
+#endif
+#ifdef _BIGDECIMAL384_H_
+BIGUINT_CXX_DEC_LITERAL_(384)
+#endif
+#ifdef _BIGDECIMAL512_H_
+BIGUINT_CXX_DEC_LITERAL_(512)
+#endif
+
+} // namespace literals
+
+/**
+ @brief Signed (two's complement) interpretation of a UInt value, as BigInt of the C API
+ (selects the signed overloads of to_chars() and from_chars()).
+*/
+template <unsigned int Bits>
+struct Int {
+ UInt<Bits> val;
+};
+
+namespace detail {
+
+/**
+ @brief Writes the value (after a minus sign if neg) with point digits after the decimal point.
+*/
+template <unsigned int Bits>
+std::to_chars_result print_chars(char *first, char *last, const UInt<Bits> &a, bool neg, int base, buint_size_t point) noexcept {
+ Cell scratch[BIGUINTN_PRINT_SCRATCH(UInt<Bits>::cells)];
+ if (neg) {
+  if (first == last) return {last, std::errc::value_too_large};
+  *first++ = '-';
+ }
+ buint_size_t len = biguintn_print_base(a.c().dat, UInt<Bits>::cells, unsigned(base), point, first, buint_size_t(last - first), scratch);
+ if (len == 0) return {last, std::errc::value_too_large};
+ return {first + len, std::errc()};
+}
+
+/**
+ @brief Parses [-]digits (signed) or digits, and [.digits] if prec is not NULL (base 10 only).
+ Signed values are stored in two's complement, their magnitude must not exceed 2^(Bits - 1).
+ @param prec Output: number of digits after the decimal point.
+*/
+template <unsigned int Bits>
+std::from_chars_result parse_chars(const char *first, const char *last, UInt<Bits> &a, bool is_signed, int base, buint_size_t *prec) noexcept {
+ bool neg = is_signed && first != last && *first == '-';
+ const char *p = first + neg;
+ const char *int_end = p;
+ while (int_end != last && digit_value(*int_end) < unsigned(base)) ++int_end;
+ const char *frac = int_end;
+ const char *end = int_end;
+ if (prec && end != last && *end == '.') {
+  for (end = ++frac; end != last && digit_value(*end) < 10u; ++end) {}
+ }
+ if (p == int_end && frac == end) return {first, std::errc::invalid_argument};
+
+ UInt<Bits> v;
+ bool oflow = biguintn_ctor_basecstream(v.c().dat, UInt<Bits>::cells, unsigned(base), p, buint_size_t(int_end - p));
+ // the digits after the decimal point in groups fitting into 32 bits
+ for (const char *g = frac; g != end && !oflow;) {
+  Cell px = 0;
+  Cell pm = 1;
+  for (unsigned int gi = 0; gi < 9u && g != end; ++gi, ++g) {
+   px = px * 10u + digit_value(*g);
+   pm *= 10u;
+  }
+  oflow = biguintn_muladd_uint(v.c().dat, UInt<Bits>::cells, pm, px) != 0;
+ }
+ if (is_signed && !oflow) {
+  // the magnitude of a negative value may be 2^(Bits - 1)
+  oflow = bool(v >> (Bits - 1)) && (!neg || bool(UInt<Bits>(v << 1)));
+  if (neg) v = -v;
+ }
+ if (oflow) return {end, std::errc::result_out_of_range};
+ a = v;
+ if (prec) *prec = buint_size_t(end - frac);
+ return {end, std::errc()};
+}
+
+} // namespace detail
+
+/**
+ Formatting and parsing with the contract of std::to_chars() and std::from_chars() of <charconv>,
+ base in range [2, 36], without prefix, digits greater than 9 are written in lower case (read in either case),
+ minus sign for the signed values (Int, BigDecimal) only.
+ Nothing is allocated, the digits are written in place (see biguintn_print_base()).
+ to_chars() returns {last, std::errc::value_too_large} if the characters do not fit into [first, last).
+ from_chars() returns {first, std::errc::invalid_argument} if there are no digits,
+ and {end of the digits, std::errc::result_out_of_range} if the value does not fit into the type;
+ on error, the value is not modified.
+ BigDecimal values are written and read in base 10, fixed format (e.g., -12.50: prec digits after the decimal point).
+*/
+template <unsigned int Bits>
+std::to_chars_result to_chars(char *first, char *last, const UInt<Bits> &a, int base = 10) noexcept {
+ return detail::print_chars(first, last, a, false, base, 0);
+}
+
+template <unsigned int Bits>
+std::to_chars_result to_chars(char *first, char *last, const Int<Bits> &a, int base = 10) noexcept {
+ bool neg = bool(a.val >> (Bits - 1));
+ return detail::print_chars(first, last, neg ? -a.val : a.val, neg, base, 0);
+}
+
+template <unsigned int Bits>
+std::from_chars_result from_chars(const char *first, const char *last, UInt<Bits> &a, int base = 10) noexcept {
+ return detail::parse_chars(first, last, a, false, base, nullptr);
+}
+
+template <unsigned int Bits>
+std::from_chars_result from_chars(const char *first, const char *last, Int<Bits> &a, int base = 10) noexcept {
+ return detail::parse_chars(first, last, a.val, true, base, nullptr);
+}
+
+#define BIGUINT_CXX_CHARCONV_(W) \
+inline std::to_chars_result to_chars(char *first, char *last, const BigUInt##W &a, int base = 10) noexcept { \
+ return to_chars(first, last, UInt<W>::view(a), base); \
+} \
+inline std::from_chars_result from_chars(const char *first, const char *last, BigUInt##W &a, int base = 10) noexcept { \
+ return from_chars(first, last, UInt<W>::view(a), base); \
+}
+
+#define BIGUINT_CXX_DEC_CHARCONV_(W) \
+inline std::to_chars_result to_chars(char *first, char *last, const BigDecimal##W &a) noexcept { \
+ const UInt<W> &v = UInt<W>::view(a.val); \
+ bool neg = bool(v >> (W - 1)); \
+ return detail::print_chars(first, last, neg ? -v : v, neg, 10, a.prec); \
+} \
+inline std::from_chars_result from_chars(const char *first, const char *last, BigDecimal##W &a) noexcept { \
+ buint_size_t prec = 0; \
+ std::from_chars_result retv = detail::parse_chars(first, last, UInt<W>::view(a.val), true, 10, &prec); \
+ if (retv.ec == std::errc()) a.prec = Cell(prec); \
+ return retv; \
+}
+
+BIGUINT_CXX_CHARCONV_(128)
+BIGUINT_CXX_DEC_CHARCONV_(128)
+#ifdef _BIGUINT256_H_
+BIGUINT_CXX_CHARCONV_(256)
+#endif
+#ifdef _BIGUINT384_H_
+BIGUINT_CXX_CHARCONV_(384)
+#endif
+#ifdef _BIGUINT512_H_
+BIGUINT_CXX_CHARCONV_(512)
+#endif
+#ifdef _BIGDECIMAL256_H_
+BIGUINT_CXX_DEC_CHARCONV_(256)
+#endif
+#ifdef _BIGDECIMAL384_H_
+BIGUINT_CXX_DEC_CHARCONV_(384)
+#endif
+#ifdef _BIGDECIMAL512_H_
+BIGUINT_CXX_DEC_CHARCONV_(512)
+#endif
+
+} // namespace biguint
+
+#endif
+
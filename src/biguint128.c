@@ -19,9 +19,16 @@
 
 *****************************************************************************/
 #include "biguint128.h"
-#include "intio.h"
+#include "biguintn.h"
+#include "cells.h"
+#include "mul_kernel.h"
+#include "ntt.h"
 #include "string.h"
 #include "uint.h"
+#if defined(__STDC_VERSION__) && (__STDC_VERSION__ >= 201112L) && !defined(__STDC_NO_ATOMICS__)
+#include <stdatomic.h>
+#define HAVE_NTT_SCRATCH
+#endif
 
 // Local definitions
 #define FORRANGE(i, LO, HI) for (buint_size_t i=(LO); i<(HI); ++i)
@@ -31,52 +38,117 @@
 #define FOREACHCELL(i) FORRANGE(i, 0U, BIGUINT128_CELLS)
 #define FOREACHCELLREV(i) FORRANGEREV(i,BIGUINT128_CELLS)
 
+// Cell loops of the shifts are unrolled, so that the funnel shifts of the cells are independent.
+#if defined(__clang__)
+#define UNROLL_CELLS _Pragma("unroll")
+#elif defined(__GNUC__) && (__GNUC__ >= 8)
+#define UNROLL_CELLS _Pragma("GCC unroll 16")
+#else
+#define UNROLL_CELLS
+#endif
+
 #define UINT_BYTES sizeof(UInt)
 #define UINT_BITS (8 * UINT_BYTES)
 #define MINUS_SIGN '-'
 
+/**
+ * Whole-width operations (add, sub, compare, shifts) emit straight-line code for at most this many cells (see cells.h).
+ * It can be overridden for each width (at most CELLS_STRAIGHT_MAX).
+ */
+#ifndef BIGUINT128_STRAIGHT_CELLS
+#define BIGUINT128_STRAIGHT_CELLS CELLS_STRAIGHT_DEFAULT
+#endif
+#if BIGUINT128_STRAIGHT_CELLS > CELLS_STRAIGHT_MAX
+#error "BIGUINT128_STRAIGHT_CELLS is greater than CELLS_STRAIGHT_MAX"
+#endif
+
+/**
+ * Operands of at least this many cells are multiplied with Karatsuba's method.
+ * The best value depends on the platform, it can be overridden for each width.
+ */
+#ifndef BIGUINT128_KARATSUBA_CELLS
+#define BIGUINT128_KARATSUBA_CELLS 32u
+#endif
+// Scratch space of the Karatsuba multiplication: at most 3n + 4 cells on each recursion level (n halves each time).
+#define KARATSUBA_SCRATCH_CELLS CELLS_KARATSUBA_SCRATCH(BIGUINT128_CELLS)
+/**
+ * Operands of at least this many cells are multiplied by number-theoretic transforms (see ntt.h).
+ * The transforms work on 32-bit digits, so they pay off later if the cells are wider.
+ * It can be overridden for each width, like the Karatsuba cutoff.
+ */
+#ifndef BIGUINT128_NTT_CELLS
+#define BIGUINT128_NTT_CELLS ((UINT_BITS < 64u ? 40960u : 163840u) / UINT_BITS)
+#endif
+
+#ifdef HAVE_NTT_SCRATCH
+/**
+ * Scratch space of the transforms, kept off the stack (several hundred kilobytes at the widths of the NTT cutoff,
+ * more than the stack of a thread may have).
+ * The buffer is shared by the threads: a thread that finds it in use multiplies by Karatsuba's method instead
+ * (same result). Without C11 atomics the transforms are not used.
+ */
+static uint32_t ntt_scratch_[NTT_SCRATCH_WORDS(BIGUINT128_CELLS * UINT_BYTES)];
+static atomic_flag ntt_scratch_busy_ = ATOMIC_FLAG_INIT;
+#endif
+
 // Assertions
 // SIZEOF_UINT checked by configure script
 #if (SIZEOF_UINT < 2)
 #error Current implementation requires UInt basic storage type being at least 2 bytes wide.
 #endif
 
-// Local types
-typedef struct {
- buint_bool ready;
- BigUInt128 val;
- BigUInt128 invpre;
- BigUInt128 inv;
-} BigUInt128DivAsMul;
+/**
+ * Native implementation of the whole-width arithmetic (configure --enable-native-uint128).
+ * The value of the two 64 bit cells is loaded into the double-width type of the compiler (DUInt),
+ * so that the compiler emits its own instruction sequences instead of the cell loops.
+ * The layout of the struct does not change.
+ * (The other widths are generated with USE_NATIVE_BIGUINT<width> macro names, which are never defined.)
+ */
+#if defined(USE_NATIVE_BIGUINT128) && defined(USE_STD_TYPES) && defined(USE_UINT64_T) && defined(HAVE_DUINT)
+#define NATIVE_DUINT
+#endif
 
 // Static function declarations
 static inline buint_size_p bitpos_(buint_size_t a);
 static inline buint_bool is_bigint_negative_(const BigUInt128 *a);
 static inline BigUInt128 *clrall_(BigUInt128 *a);
 static inline void fast_div_phase2_(BigUIntPair128 *res, UInt divisor);
-static inline BigUInt128 divmax_tiny_(UInt divisor);
-static inline void init_divasmul_(UInt divisor, BigUInt128DivAsMul *a);
-static inline void tune_remainder_(BigUIntTinyPair128 *res, const BigUInt128DivAsMul *a);
-static inline buint_size_t msbnxt_(const BigUInt128 *a, buint_size_t last);
-static inline BigUInt128 *shr_tiny_crng_(BigUInt128 *a, buint_size_t shift, buint_size_t clo, buint_size_t chi);
+static void dmul_cells_(UInt *res, const UInt *a, buint_size_t na, const UInt *b, buint_size_t nb, buint_size_t ncols);
+static void dsqr_cells_(UInt *res, const UInt *a, buint_size_t na, buint_size_t ncols);
+static inline uint32_t *ntt_scratch_acquire_(void);
+static inline void ntt_scratch_release_(void);
+static inline UInt shl_cell_(const UInt *src, buint_size_t i, buint_size_t cells, buint_size_t bits);
+static inline void ror_long_(UInt *restrict dest, const UInt *restrict src, buint_size_t n, buint_size_t shift);
+static inline buint_size_t msbnxt_(const BigUInt128 *a, buint_size_t bit);
+static inline UInt bits_(const BigUInt128 *a, buint_size_t lo, buint_size_t n);
+static inline BigUInt128 mont_redc_(const MontCtx128 *ctx, UInt *t);
+static inline void barrett_step_(UInt *r, const UInt *x, const BarrettCtx128 *ctx);
 
-static inline BigUInt128 *sbc_crng_(BigUInt128 *a, const BigUInt128 *b, buint_size_t clo, buint_size_t chi, buint_bool *carry);
 static inline BigUInt128 *sub_carry_crng_(BigUInt128 *a, buint_size_t clo, buint_bool *carry);
 
 
-static buint_size_t print_dec_anywhere_(const BigUInt128 *a, char *buf, buint_size_t buf_len, buint_size_t *offset);
 static BigUIntTinyPair128 div_special_tiny_(const BigUInt128 *a, UInt b);
-static BigUInt128 *shr_tiny_brng_(BigUInt128 *a, buint_size_t shift, buint_size_t lsb, buint_size_t msb);
-static BigUInt128 *sub_assign_brng_(BigUInt128 *a, const BigUInt128 *b, buint_size_t lsb, buint_size_t msb);
-static buint_bool lt_brng_(const BigUInt128 *a, const BigUInt128 *b, buint_size_t msb);
-static void max_uint_10pow_(UInt *val, buint_size_t *pow);
-static buint_size_t print_dec_anywhere_(const BigUInt128 *a, char *buf, buint_size_t buf_len, buint_size_t *offset);
+#ifdef NATIVE_DUINT
+static inline DUInt native_load_(const BigUInt128 *a);
+static inline void native_store_(BigUInt128 *a, DUInt x);
+#endif
 
 // Implementations
 
 /////////////////////
 // internal functions
 
+#ifdef NATIVE_DUINT
+static inline DUInt native_load_(const BigUInt128 *a) {
+ return (DUInt)a->dat[1] << UINT_BITS | a->dat[0];
+}
+
+static inline void native_store_(BigUInt128 *a, DUInt x) {
+ a->dat[0] = (UInt)x;
+ a->dat[1] = (UInt)(x >> UINT_BITS);
+}
+#endif
+
 /**
  * Splits a bit position into pair of byte index [0..UINT_BYTES) and internal bit position [0,8)
  * @param a Bit position in BigUInt.
@@ -119,112 +191,79 @@ static inline void fast_div_phase2_(BigUIntPair128 *res, UInt divisor) {
 }
 
 /**
- * Performs division on the maximal BigUInt128 number.
- * Only the quotient is returned, i.e., we do not store the remainder.
- * @param divisor
- * @return Quotient.
+ * Takes the scratch space of the transforms.
+ * @return The static scratch buffer, or NULL if another thread is using it (or there is no buffer).
  */
-static inline BigUInt128 divmax_tiny_(UInt divisor) {
- BigUInt128 max = biguint128_ctor_default();
- biguint128_dec(&max);
- BigUInt128 d = biguint128_value_of_uint(divisor);
- return biguint128_div(&max, &d).first;
+static inline uint32_t *ntt_scratch_acquire_(void) {
+#ifdef HAVE_NTT_SCRATCH
+ return atomic_flag_test_and_set_explicit(&ntt_scratch_busy_, memory_order_acquire) ? NULL : ntt_scratch_;
+#else
+ return NULL;
+#endif
 }
 
 /**
- * If we know the modular multiplicative inverse number (inv_a) of a certain number a,
- * the division with a can be carried out as multiplication with inv_a.
- * In order to do multiplication with mod mul inv. value,
- *  we have to define some values (and store them in BigUInt128DivAsMul struct).
- * This method finds the mod mul inv value for numbers that are divisors of the
- * maximal BigUInt128 value (e.g., 3, 5, 15, etc.).
- * @param divisor
- * @param a Mod mul inv and other useful values are written here.
+ * Gives back the scratch space taken by ntt_scratch_acquire_().
  */
-static inline void init_divasmul_(UInt divisor, BigUInt128DivAsMul *a) {
- a->val = biguint128_value_of_uint(divisor);
- a->invpre = divmax_tiny_(divisor);
- a->inv = bigint128_negate(&a->invpre);
- a->ready = 1;
+static inline void ntt_scratch_release_(void) {
+#ifdef HAVE_NTT_SCRATCH
+ atomic_flag_clear_explicit(&ntt_scratch_busy_, memory_order_release);
+#endif
 }
 
 /**
- * Division carried out as multiplication with the mod mul inv value does
- * not give the quotient and the remainder directly.
- * This method transforms the result of the multiplication into quotient and remainder.
- * @param res Subject of operation. res->first contains the raw result,
- * res->second should be the initial remainder (0).
- * As output, res->first will contain the quotient, wherease res->second will contain the remainder.
- * @param a Mod mul inv values and others.
+ * Multiplication of cell arrays, choosing the algorithm by the size of the factors.
+ * @param res Output: ncols cells of the product.
+ * @param a First factor (at least na cells, the cells above na up to nb are 0).
+ * @param na Number of significant cells of a.
+ * @param b Second factor (at least nb cells, the cells above nb up to na are 0).
+ * @param nb Number of significant cells of b.
+ * @param ncols Number of product cells (na + nb <= ncols unless the product scanning method is used).
  */
-static inline void tune_remainder_(BigUIntTinyPair128 *res, const BigUInt128DivAsMul *a) {
- while (biguint128_lt(&a->invpre, &res->first)) {
-  ++res->second;
-  biguint128_sub_assign(&res->first, &a->inv);
+static void dmul_cells_(UInt *res, const UInt *a, buint_size_t na, const UInt *b, buint_size_t nb, buint_size_t ncols) {
+ if (na < BIGUINT128_KARATSUBA_CELLS || nb < BIGUINT128_KARATSUBA_CELLS) {
+  cells_mul_base(res, a, na, b, nb, ncols);
+  return;
  }
-}
-
-/**
- * Accelerated search for most significant set bit.
- * We assume that all the bits above last are 0.
- * @param a Subject of operation.
- * @param last begin bit of search.
- * @return MSB not hiher than last.
- */
-static inline buint_size_t msbnxt_(const BigUInt128 *a, buint_size_t last) {
- for (buint_size_t i = last; 0 < i; --i) {
-  if (biguint128_gbit(a, i-1)) return i-1;
+ buint_size_t n = na < nb ? nb : na;
+ UInt prod[2 * BIGUINT128_CELLS];
+ uint32_t *nt = (na < BIGUINT128_NTT_CELLS || nb < BIGUINT128_NTT_CELLS) ? NULL : ntt_scratch_acquire_();
+ if (nt == NULL) {
+  UInt t[KARATSUBA_SCRATCH_CELLS];
+  cells_kara_mul(prod, a, b, n, t, BIGUINT128_KARATSUBA_CELLS);
+ } else {
+  ntt_mul(prod, a, n, b, n, nt);
+  ntt_scratch_release_();
  }
- return 0;
+ buint_size_t ncopy = 2 * n < ncols ? 2 * n : ncols;
+ memcpy(res, prod, ncopy * UINT_BYTES);
+ memset(res + ncopy, 0, (ncols - ncopy) * UINT_BYTES);
 }
 
 /**
- * Shift right in a range of cells.
- * This function works as SHR_TINY if the cells outside the range are all 0.
- * @param a Subject of operation
- * @param shift Amount of shifting (less than UINT_BITS).
- * @param clo Lower bound of cell range (inclusive).
- * @param chi Upper bound of cell range (exclusive).
- * @return a.
+ * Squaring of a cell array, choosing the algorithm by the size of the value.
+ * @param res Output: ncols cells of the square.
+ * @param a Value to square.
+ * @param na Number of significant cells of a.
+ * @param ncols Number of calculated cells.
  */
-static inline BigUInt128 *shr_tiny_crng_(BigUInt128 *a, buint_size_t shift, buint_size_t clo, buint_size_t chi) {
- FORRANGE(i,clo, chi) {
-  UIntPair x = uint_split_shift(a->dat[i], shift);
-  if (0 < i) a->dat[i - 1] |= x.second;
-  a->dat[i] = x.first;
+static void dsqr_cells_(UInt *res, const UInt *a, buint_size_t na, buint_size_t ncols) {
+ if (na < BIGUINT128_KARATSUBA_CELLS) {
+  cells_sqr_base(res, a, na, ncols);
+  return;
  }
- return a;
-}
-
-/**
- * Shift right in a range of bits.
- * This function works as SHR_TINY if the bits outside the range are all 0.
- * @param a Subject of operation
- * @param shift Amount of shifting (less than UINT_BITS).
- * @param lsb Lower bound of bit range (inclusive).
- * @param msb Upper bound of bit range (inclusive!).
- * @return a.
- */
-static BigUInt128 *shr_tiny_brng_(BigUInt128 *a, buint_size_t shift, buint_size_t lsb, buint_size_t msb) {
- buint_size_t clo = bitpos_(lsb).byte_sel;
- buint_size_t chi = bitpos_(msb).byte_sel + 1;
- return shr_tiny_crng_(a, shift, clo, chi);
-}
-
-/**
- * Subtraction with carry in a cell range.
- * @param a Subject of the operation.
- * @param b This number will be (partially) subtracted from a.
- * @param clo Lower bound of cell range (inclusive).
- * @param chi Upper bound of cell range (exclusive).
- * @param carry carry flag (input/output)
- * @return a.
- */
-static inline BigUInt128 *sbc_crng_(BigUInt128 *a, const BigUInt128 *b, buint_size_t clo, buint_size_t chi, buint_bool *carry){
- FORRANGE(i, clo, chi) {
-  uint_sub_assign(&a->dat[i], b->dat[i], carry);
+ UInt prod[2 * BIGUINT128_CELLS];
+ uint32_t *nt = na < BIGUINT128_NTT_CELLS ? NULL : ntt_scratch_acquire_();
+ if (nt == NULL) {
+  UInt t[KARATSUBA_SCRATCH_CELLS];
+  cells_kara_sqr(prod, a, na, t, BIGUINT128_KARATSUBA_CELLS);
+ } else {
+  ntt_mul(prod, a, na, a, na, nt);
+  ntt_scratch_release_();
  }
- return a;
+ buint_size_t ncopy = 2 * na < ncols ? 2 * na : ncols;
+ memcpy(res, prod, ncopy * UINT_BYTES);
+ memset(res + ncopy, 0, (ncols - ncopy) * UINT_BYTES);
 }
 
 /**
@@ -242,130 +281,142 @@ static inline BigUInt128 *sub_carry_crng_(BigUInt128 *a, buint_size_t clo, buint
 }
 
 /**
- * Performs subtraction with assignment in a given bit range.
- * This functions gives the same result as biguint128_sub_assign
- * if the bits of b are 0 outside the interval [lsb, msb].
- * @param a
- * @param b
- * @param lsb Lower bound of bit range (inclusive).
- * @param msb Upper bound of bit range (inclusive).
- * @return a.
+ * One cell of a left shift: the funnel shift of two source cells
+ * (the move of whole cells and the shift of the bits together).
+ * @param src Value to shift.
+ * @param i Index of the output cell.
+ * @param cells Amount of shifting, whole cells.
+ * @param bits Amount of shifting, bits [0, UINT_BITS).
+ * @return Cell i of src << (cells * UINT_BITS + bits).
  */
-static BigUInt128 *sub_assign_brng_(BigUInt128 *a, const BigUInt128 *b, buint_size_t lsb, buint_size_t msb){
- buint_size_t clo = bitpos_(lsb).byte_sel;
- buint_size_t chi = bitpos_(msb).byte_sel + 1;
- buint_bool carry = 0;
-
- sbc_crng_(a,b,clo,chi,&carry);
- return sub_carry_crng_(a,chi,&carry);
+static inline UInt shl_cell_(const UInt *src, buint_size_t i, buint_size_t cells, buint_size_t bits) {
+ UInt hi = cells_src(src, i - cells, cells <= i);
+ UInt lo = cells_src(src, i - cells - 1, cells < i);
+ return (hi << bits) | ((lo >> 1) >> (UINT_BITS - 1 - bits));
 }
 
 /**
- * Constrainted ``less than'' check.
- * It assumes that a end b equal at bits higher than msb.
- * @param a Reference to left hand side argument of the operator.
- * @param b Reference to right hand side argument of the operator.
- * @param msb MSB to check.
- * @return *a is less than *b in bit range [0,msb].
+ * Rotate right of a cell array: each output cell is a funnel shift of two source cells
+ * (the indices wrap around after the highest cell).
+ * @param dest Output: n cells of the rotated value (must not overlap with src).
+ * @param src Value to rotate (n cells).
+ * @param n Number of cells.
+ * @param shift Amount of rotation [0, n * UINT_BITS).
  */
-static buint_bool lt_brng_(const BigUInt128 *a, const BigUInt128 *b, buint_size_t msb) {
- FORRANGEREV(j, msb / UINT_BITS+1) {
-  if (a->dat[j] < b->dat[j]) return 1;
-  if (b->dat[j] < a->dat[j]) return 0;
+static inline void ror_long_(UInt *restrict dest, const UInt *restrict src, buint_size_t n, buint_size_t shift) {
+ buint_size_t cells = shift / UINT_BITS;
+ buint_size_t bits = shift % UINT_BITS;
+ UNROLL_CELLS
+ FORRANGE(i, 0, n) {
+  buint_size_t lo = i + cells < n ? i + cells : i + cells - n;
+  buint_size_t hi = lo + 1 < n ? lo + 1 : 0;
+  dest[i] = cells_funnel(src[hi], src[lo], bits);
  }
- return 0;
 }
 
 /**
- * Returns the highest power of 10 that can be represented in UInt type.
- * @param val Output: the highest power of 10.
- * @param pow Output: the power itself.
+ * Next set bit downwards, scanning cell by cell.
+ * @param a Value to examine.
+ * @param bit Upper bound (exclusive) of the bits to examine.
+ * @return Index of the highest bit set to 1 below bit, plus 1 (0 if there is none).
  */
-static void max_uint_10pow_(UInt *val, buint_size_t *pow) {
- // some constants
- static const UInt m10 = 10U;
- static UInt limit = ((UInt)-1) / m10;
- // init
- *val = 1;
- *pow = 0;
- // iterate
- while (1) {
-  *val*= m10;
-  ++*pow;
-  if (limit < *val) return;
+static inline buint_size_t msbnxt_(const BigUInt128 *a, buint_size_t bit) {
+ if (bit == 0) return 0;
+ buint_size_t i = (bit - 1) / UINT_BITS;
+ buint_size_t top = bit - i * UINT_BITS; // bits of cell i to examine (1 .. UINT_BITS)
+ UInt c = top < UINT_BITS ? a->dat[i] & (((UInt)1 << top) - 1) : a->dat[i];
+ while (c == 0) {
+  if (i == 0) return 0;
+  c = a->dat[--i];
  }
+ return i * UINT_BITS + uint_msb(c) + 1;
 }
 
 /**
- * It is complicated to determine in advance the number of digits of a BigUInt128 value.
- * This function writes the decimal digits of the value to the end of the given buffer,
- * beginning with the least significant digit at the very end of the buffer.
- * @param a Value to print.
- * @param buf Output: Here to write the value.
- * @param buf_len length of buf. The value must be written in the range [buf, buf+buf_len).
- * @param offset Output: the written digits can be read out from the buffer beginning at this offset.
- * @return Number of digits that can be read out of the buffer beginning at buffer[offset].
- * If the value does not fit into the buffer, 0 is returned.
+ * Bit field extraction.
+ * @param a Value to examine.
+ * @param lo Index of the lowest bit of the field.
+ * @param n Width of the field (less than UINT_BITS).
+ * @return Bits [lo, lo + n) of a, at the bottom bits.
  */
-static buint_size_t print_dec_anywhere_(const BigUInt128 *a, char *buf, buint_size_t buf_len, buint_size_t *offset) {
- // static values
- static const UInt BASE = 10U;
- static buint_bool fstrun = 1;
- static UInt div10u;
- static buint_size_t pow;
- static BigUInt128 div10pow;
- if (fstrun) {
-  max_uint_10pow_(&div10u, &pow);
-  div10pow = biguint128_value_of_uint(div10u);
-  fstrun = 0;
- }
+static inline UInt bits_(const BigUInt128 *a, buint_size_t lo, buint_size_t n) {
+ buint_size_t i = lo / UINT_BITS;
+ buint_size_t sh = lo % UINT_BITS;
+ UInt v = a->dat[i] >> sh;
+ if (UINT_BITS < sh + n && i + 1 < BIGUINT128_CELLS) v |= a->dat[i + 1] << (UINT_BITS - sh);
+ return v & (((UInt)1 << n) - 1);
+}
 
- // variables
- buint_bool ready = 0;
- BigUInt128 zero = biguint128_value_of_uint(0);
- BigUInt128 temp = biguint128_ctor_copy(a);
-
- for (buint_size_t i= 0; !ready && i < buf_len; i+= pow) {
-  BigUIntPair128 res= biguint128_div(&temp, &div10pow);
-  UInt d= res.second.dat[0];
-  buint_bool no_more_div10pow = (biguint128_eq(&zero, &res.first));
-  for (buint_size_t pi=0; !ready && pi < pow; ++pi) {
-   buint_size_t buf_idx_pi= buf_len - i - pi - 1;
-   char di = d%BASE;
-   set_decdigit(buf + buf_idx_pi, di);
-   d/= BASE;
-   if (no_more_div10pow && d == 0) {
-    *offset = buf_idx_pi;
-    ready = 1;
-   }
-   if (buf_idx_pi==0) {	// this was the last writeable digit
-    break;
-   }
+/**
+ * Montgomery reduction (REDC) of a double-width value.
+ * @param ctx Montgomery context.
+ * @param t Value to reduce (less than n*R) of 2 * BIGUINT128_CELLS + 1 cells,
+ * the highest cell must be 0. Overwritten.
+ * @return t*R^(-1) mod n.
+ */
+static inline BigUInt128 mont_redc_(const MontCtx128 *ctx, UInt *t) {
+ BigUInt128 retv;
+ FORRANGE(i, 0, BIGUINT128_CELLS) {
+  UInt m = t[i] * ctx->ninv; // t + m*n is divisible by 2^UINT_BITS
+  buint_bool carry = 0;
+  UInt *hi = t + i + BIGUINT128_CELLS;
+  *hi = uint_add(*hi, cells_addmul_1(t + i, ctx->n.dat, BIGUINT128_CELLS, m), &carry);
+  while (carry) {
+   ++hi;
+   *hi = uint_add(*hi, 0, &carry);
   }
-  temp = res.first;
  }
- if (!ready) *offset = buf_len;
- return buf_len - *offset;
+ // t/R is less than 2n
+ memcpy(retv.dat, t + BIGUINT128_CELLS, BIGUINT128_CELLS * UINT_BYTES);
+ if (t[2 * BIGUINT128_CELLS] || !biguint128_lt(&retv, &ctx->n)) {
+  biguint128_sub_assign(&retv, &ctx->n);
+ }
+ return retv;
+}
+
+/**
+ * Barrett reduction of a value of 2k cells (Menezes et al.: Handbook of Applied Cryptography, 14.42).
+ * The quotient estimation q3 = floor(floor(x / b^(k-1)) * mu / b^(k+1)) is at most 2 less
+ * than the quotient, so the remainder needs at most two correction subtractions.
+ * @param r Output: x mod m (k cells).
+ * @param x Value to reduce (2k cells), less than b^(2k).
+ * @param ctx Barrett context (m of k cells).
+ */
+static inline void barrett_step_(UInt *r, const UInt *x, const BarrettCtx128 *ctx) {
+ const buint_size_t k = ctx->cells;
+ UInt q2[2 * BIGUINT128_CELLS + 3];
+ UInt r1[BIGUINT128_CELLS + 1];
+ UInt r2[BIGUINT128_CELLS + 1];
+ UInt m[BIGUINT128_CELLS + 1];
+ // q3 = (q1 * mu) / b^(k+1), where q1 = x / b^(k-1) (k + 1 cells)
+ buint_size_t nq1 = k + 1;
+ while (0 < nq1 && x[k - 2 + nq1] == 0) --nq1;
+ cells_mul_base(q2, x + k - 1, nq1, ctx->mu, ctx->mucells, 2 * k + 3);
+ // r = (x - q3 * m) mod b^(k+1)
+ cells_mul_base(r2, q2 + k + 1, k + 1, ctx->m.dat, k, k + 1);
+ memcpy(r1, x, (k + 1) * UINT_BYTES);
+ cells_sub_n(r1, r2, k + 1);
+ // corrections
+ memcpy(m, ctx->m.dat, k * UINT_BYTES);
+ m[k] = 0;
+ while (!cells_lt(r1, m, k + 1, 0u)) {
+  cells_sub_n(r1, m, k + 1);
+ }
+ memcpy(r, r1, k * UINT_BYTES);
 }
 
 /**
- * Division as Multiplication with modular multiplicative inverse is
- * supported for two tiny values: 3 and 5.
- * This function performs this kind of division.
+ * Division as Multiplication with modular multiplicative inverse
+ * for tiny odd divisors (3 and 5): after subtracting the remainder,
+ * the division is exact, so the quotient is computed by biguint128_divexact_uint().
  * @param a Reference to the value to divide.
- * @param b Divisor, either 3 or 5. If b!=3, here we assume, that b==5.
- * Note: internal function, no input validation...
+ * @param b Odd divisor.
  * @return Pair of quotient and remainder.
  */
 static BigUIntTinyPair128 div_special_tiny_(const BigUInt128 *a, UInt b) {
- static BigUInt128DivAsMul v[]={{0},{0}};	// not ready
- if (!v[0].ready) {
-  init_divasmul_(3, &v[0]);
-  init_divasmul_(5, &v[1]);
- }
- size_t idx = (b==3? 0: 1);
- BigUIntTinyPair128 retv = {biguint128_mul(a, &v[idx].inv), 0};
- tune_remainder_(&retv, &v[idx]);
+ BigUIntTinyPair128 retv = {biguint128_ctor_copy(a), biguint128_mod_uint(a, b)};
+ biguint128_sub_tiny(&retv.first, retv.second);
+ retv.first = biguint128_divexact_uint(&retv.first, b);
  return retv;
 }
 
@@ -400,45 +451,14 @@ BigUInt128 biguint128_ctor_copy(const BigUInt128 *orig) {
 }
 
 BigUInt128 biguint128_ctor_hexcstream(const char *hex_digits, buint_size_t len) {
- BigUInt128 retv=biguint128_ctor_default();
- buint_bool ready = 0;
- for (buint_size_t i = 0; !ready && i < BIGUINT128_CELLS; ++i) {
-  for (buint_size_t j = 0; !ready && j < UINT_BYTES; ++j) {
-   buint_size_t offset = 2 * (UINT_BYTES * i + j);
-   if (offset < len) {
-    unsigned char x;
-    if (offset + 1 < len) {
-     get_hexbyte(hex_digits + len - offset - 2, &x);
-    } else {
-     get_digit(hex_digits[len - offset - 1], 16, &x);
-    }
-    retv.dat[i]|= (UInt)x << 8*j;
-   } else {
-    ready = 1;
-   }
-  }
- }
+ BigUInt128 retv;
+ biguintn_ctor_hexcstream(retv.dat, BIGUINT128_CELLS, hex_digits, len);
  return retv;
 }
 
 BigUInt128 biguint128_ctor_deccstream(const char *dec_digits, buint_size_t len) {
- BigUInt128 retv = biguint128_ctor_default();
- for (buint_size_t i = 0; i < len;) {
-  unsigned int plen = len - i < 3 ? len - i : 3;
-  unsigned int px = 0; // stores the partial, plen digit long value
-  for (buint_size_t pi = 0; pi < plen; ++pi) {
-   px *= 10;
-   unsigned char d;
-   get_digit(dec_digits[i+pi], 10, &d);
-   px += d;
-  }
-  retv =
-   plen == 1 ? biguint128_mul10(&retv) :
-   plen == 2 ? biguint128_mul100(&retv) :
-   biguint128_mul1000(&retv);
-  biguint128_add_tiny(&retv, px);
-  i+=plen;
- }
+ BigUInt128 retv;
+ biguintn_ctor_deccstream(retv.dat, BIGUINT128_CELLS, dec_digits, len);
  return retv;
 }
 
@@ -479,15 +499,20 @@ buint_size_t biguint128_import(BigUInt128 *dest, const char *src) {
 
 BigUInt128 biguint128_add(const BigUInt128 *a, const BigUInt128 *b) {
  BigUInt128 retv;
- biguint128_add_replace(&retv, a, b);
+#ifdef NATIVE_DUINT
+ native_store_(&retv, native_load_(a) + native_load_(b));
+#else
+ cells_adc(retv.dat, a->dat, b->dat, BIGUINT128_CELLS, BIGUINT128_STRAIGHT_CELLS, 0);
+#endif
  return retv;
 }
 
 BigUInt128 *biguint128_add_assign(BigUInt128 *a, const BigUInt128 *b) {
- buint_bool carry = 0;
- FOREACHCELL(i) {
-  uint_add_assign(&a->dat[i], b->dat[i], &carry);
- }
+#ifdef NATIVE_DUINT
+ native_store_(a, native_load_(a) + native_load_(b));
+#else
+ cells_adc(a->dat, a->dat, b->dat, BIGUINT128_CELLS, BIGUINT128_STRAIGHT_CELLS, 0);
+#endif
  return a;
 }
 
@@ -498,8 +523,11 @@ BigUInt128 *biguint128_add_assign(BigUInt128 *a, const BigUInt128 *b) {
  * @param b
  */
 void biguint128_add_replace(BigUInt128 *dest, const BigUInt128 *a, const BigUInt128 *b) {
- buint_bool carry = 0;
- biguint128_adc_replace(dest, a, b, &carry);
+#ifdef NATIVE_DUINT
+ native_store_(dest, native_load_(a) + native_load_(b));
+#else
+ cells_adc(dest->dat, a->dat, b->dat, BIGUINT128_CELLS, BIGUINT128_STRAIGHT_CELLS, 0);
+#endif
 }
 
 /**
@@ -510,9 +538,7 @@ void biguint128_add_replace(BigUInt128 *dest, const BigUInt128 *a, const BigUInt
  * @param carry input/output overflow.
  */
 void biguint128_adc_replace(BigUInt128 *dest, const BigUInt128 *a, const BigUInt128 *b, buint_bool *carry) {
- FOREACHCELL(i) {
-  dest->dat[i] = uint_add(a->dat[i], b->dat[i], carry);
- }
+ *carry = cells_adc(dest->dat, a->dat, b->dat, BIGUINT128_CELLS, BIGUINT128_STRAIGHT_CELLS, *carry);
 }
 
 // END ADD   //
@@ -523,13 +549,21 @@ void biguint128_adc_replace(BigUInt128 *dest, const BigUInt128 *a, const BigUInt
 
 BigUInt128 biguint128_sub(const BigUInt128 *a, const BigUInt128 *b) {
  BigUInt128 retv;
- biguint128_sub_replace(&retv, a, b);
+#ifdef NATIVE_DUINT
+ native_store_(&retv, native_load_(a) - native_load_(b));
+#else
+ cells_sbb(retv.dat, a->dat, b->dat, BIGUINT128_CELLS, BIGUINT128_STRAIGHT_CELLS, 0);
+#endif
  return retv;
 }
 
 BigUInt128 *biguint128_sub_assign(BigUInt128 *a, const BigUInt128 *b) {
- buint_bool carry = 0;
- return sbc_crng_(a,b,0,BIGUINT128_CELLS,&carry);
+#ifdef NATIVE_DUINT
+ native_store_(a, native_load_(a) - native_load_(b));
+#else
+ cells_sbb(a->dat, a->dat, b->dat, BIGUINT128_CELLS, BIGUINT128_STRAIGHT_CELLS, 0);
+#endif
+ return a;
 }
 
 /**
@@ -539,8 +573,11 @@ BigUInt128 *biguint128_sub_assign(BigUInt128 *a, const BigUInt128 *b) {
  * @param b
  */
 void biguint128_sub_replace(BigUInt128 *dest, const BigUInt128 *a, const BigUInt128 *b) {
- buint_bool carry = 0;
- biguint128_sbc_replace(dest, a, b, &carry);
+#ifdef NATIVE_DUINT
+ native_store_(dest, native_load_(a) - native_load_(b));
+#else
+ cells_sbb(dest->dat, a->dat, b->dat, BIGUINT128_CELLS, BIGUINT128_STRAIGHT_CELLS, 0);
+#endif
 }
 
 /**
@@ -551,9 +588,7 @@ void biguint128_sub_replace(BigUInt128 *dest, const BigUInt128 *a, const BigUInt
  * @param carry input/output underflow.
  */
 void biguint128_sbc_replace(BigUInt128 *dest, const BigUInt128 *a, const BigUInt128 *b, buint_bool *carry) {
- FOREACHCELL(i) {
-  dest->dat[i] = uint_sub(a->dat[i], b->dat[i], carry);
- }
+ *carry = cells_sbb(dest->dat, a->dat, b->dat, BIGUINT128_CELLS, BIGUINT128_STRAIGHT_CELLS, *carry);
 }
 
 /**
@@ -625,8 +660,22 @@ BigUInt128 *biguint128_dec(BigUInt128 *a) {
 
 // ### Section SHIFT / ROTATE
 BigUInt128 biguint128_shl(const BigUInt128 *a, const buint_size_t shift) {
- BigUInt128 retv = biguint128_ctor_default();
- return *biguint128_shl_or(&retv, a, shift);;
+ BigUInt128 retv;
+#ifdef NATIVE_DUINT
+ native_store_(&retv, shift < 2 * UINT_BITS ? native_load_(a) << shift : 0);
+#else
+ cells_shl(retv.dat, a->dat, BIGUINT128_CELLS, BIGUINT128_STRAIGHT_CELLS, shift);
+#endif
+ return retv;
+}
+
+BigUInt128 *biguint128_shl_assign(BigUInt128 *a, const buint_size_t shift) {
+#ifdef NATIVE_DUINT
+ native_store_(a, shift < 2 * UINT_BITS ? native_load_(a) << shift : 0);
+#else
+ cells_shl(a->dat, a->dat, BIGUINT128_CELLS, BIGUINT128_STRAIGHT_CELLS, shift);
+#endif
+ return a;
 }
 
 /**
@@ -638,88 +687,63 @@ BigUInt128 biguint128_shl(const BigUInt128 *a, const buint_size_t shift) {
  * @return dest.
  */
 BigUInt128 *biguint128_shl_or(BigUInt128 *restrict dest, const BigUInt128 *restrict a, const buint_size_t shift) {
- buint_size_p shift_p = bitpos_(shift);
-
+ buint_size_t cells = shift / UINT_BITS;
+ buint_size_t bits = shift % UINT_BITS;
+ UNROLL_CELLS
  FOREACHCELL(i) {
-  UIntPair x = uint_split(a->dat[i], UINT_BITS - shift_p.bit_sel);
-  if (i < BIGUINT128_CELLS - shift_p.byte_sel) {
-   dest->dat[i + shift_p.byte_sel]|= x.second << shift_p.bit_sel;
-   if (i < BIGUINT128_CELLS - shift_p.byte_sel - 1) {
-    dest->dat[i + shift_p.byte_sel + 1]|= x.first >> (UINT_BITS - shift_p.bit_sel);
-   }
-  }
+  dest->dat[i] |= shl_cell_(a->dat, i, cells, bits);
  }
  return dest;
 }
 
 BigUInt128 *biguint128_shl_tiny(BigUInt128 *a, const buint_size_t shift) {
- buint_size_t bitshift = UINT_BITS - bitpos_(shift).bit_sel;
-
- FOREACHCELL(i) {
-  UIntPair x = uint_split_shift(a->dat[BIGUINT128_CELLS - 1 - i], bitshift);
-  if (0 < i) a->dat[BIGUINT128_CELLS - i] |= x.first;
-  a->dat[BIGUINT128_CELLS - 1 - i] = x.second;
- }
+ cells_shl_bits(a->dat, a->dat, BIGUINT128_CELLS, bitpos_(shift).bit_sel);
  return a;
 }
 
 BigUInt128 biguint128_shr(const BigUInt128 *a, const buint_size_t shift) {
- BigUInt128 retv = biguint128_ctor_default();
- buint_size_p shift_p = bitpos_(shift);
-
- FOREACHCELL(i) {
-  UIntPair x = uint_split(a->dat[i], shift_p.bit_sel);
-  if (shift_p.byte_sel <= i) {
-   retv.dat[i - shift_p.byte_sel]|= x.first >> shift_p.bit_sel;
-   if (shift_p.byte_sel + 1 <= i) {
-    retv.dat[i - shift_p.byte_sel - 1]|= x.second << (UINT_BITS - shift_p.bit_sel);
-   }
-  }
- }
+ BigUInt128 retv;
+#ifdef NATIVE_DUINT
+ native_store_(&retv, shift < 2 * UINT_BITS ? native_load_(a) >> shift : 0);
+#else
+ cells_shr(retv.dat, a->dat, BIGUINT128_CELLS, BIGUINT128_STRAIGHT_CELLS, shift);
+#endif
  return retv;
 }
 
 BigUInt128 *biguint128_shr_assign(BigUInt128 *a, const buint_size_t shift) {
- const buint_size_p shift_p = bitpos_(shift);
- UInt carry=uint_split_shift(a->dat[shift_p.byte_sel],shift_p.bit_sel).first;
-
- // There are 2 ranges in the produced a->dat:
- //  [0, BIGUINT128_CELLS-shift_p.byte_sel]: these values are derived from equal and higher indexed a->dat entries;
- //  [BIGUINT128_CELLS-shift_p.byte_sel, BIGUINT128_CELLS): these values are cleared
- // the special entry is dat[BIGUINT128_CELLS-shift_p.byte_sel]: low part is copied, high part is cleared.
- FOREACHCELL(i) {
-  if (shift_p.byte_sel + i + 1 < BIGUINT128_CELLS){
-   UIntPair x= uint_split_shift(a->dat[shift_p.byte_sel + 1 + i], shift_p.bit_sel);
-   a->dat[i]= x.second | carry;
-   carry= x.first;
-  } else {
-    a->dat[i]= carry;
-    carry= 0;
-  }
- }
+#ifdef NATIVE_DUINT
+ native_store_(a, shift < 2 * UINT_BITS ? native_load_(a) >> shift : 0);
+#else
+ cells_shr(a->dat, a->dat, BIGUINT128_CELLS, BIGUINT128_STRAIGHT_CELLS, shift);
+#endif
  return a;
 }
 
 BigUInt128 *biguint128_shr_tiny(BigUInt128 *a, const buint_size_t shift) {
- buint_size_p shift_p = bitpos_(shift);
- return shr_tiny_crng_(a, shift_p.bit_sel, 0, BIGUINT128_CELLS);
+ cells_shr_bits(a->dat, a->dat, BIGUINT128_CELLS, bitpos_(shift).bit_sel);
+ return a;
 }
 
 BigUInt128 biguint128_ror(const BigUInt128 *a, const buint_size_t shift) {
- BigUInt128 retv = biguint128_ctor_default();
- BigUInt128 *dest = &retv;
- buint_size_p shift_p = bitpos_(shift);
-
- FOREACHCELL(i) {
-  UIntPair x = uint_split_shift(a->dat[i], shift_p.bit_sel);
-  dest->dat[(i - shift_p.byte_sel) % BIGUINT128_CELLS]|= x.first;
-  dest->dat[(i - shift_p.byte_sel - 1) % BIGUINT128_CELLS]|= x.second;
- }
+ BigUInt128 retv;
+ ror_long_(retv.dat, a->dat, BIGUINT128_CELLS, shift % (BIGUINT128_CELLS * UINT_BITS));
  return retv;
 }
 
 BigUInt128 biguint128_rol(const BigUInt128 *a, const buint_size_t shift) {
- return biguint128_ror(a, 128u - shift);
+ const buint_size_t bits = BIGUINT128_CELLS * UINT_BITS;
+ BigUInt128 retv;
+ ror_long_(retv.dat, a->dat, BIGUINT128_CELLS, (bits - shift % bits) % bits);
+ return retv;
+}
+
+BigUInt128 *biguint128_rol_assign(BigUInt128 *a, const buint_size_t shift) {
+ const buint_size_t bits = BIGUINT128_CELLS * UINT_BITS;
+ UInt t[BIGUINT128_CELLS];
+ memcpy(t, a->dat, sizeof(t));
+ ror_long_(a->dat, t, BIGUINT128_CELLS, (bits - shift % bits) % bits);
+ return a;
 }
 
 // ### Section Bitwise Logic
@@ -789,87 +813,101 @@ BigUInt128 *biguint128_xor_assign(BigUInt128 *a, const BigUInt128 *b) {
 
 // ### Section MUL/DIV
 BigUInt128 biguint128_mul(const BigUInt128 *a, const BigUInt128 *b) {
- BigUInt128 retv = biguint128_ctor_default();
- BigUInt128 carry = biguint128_ctor_default();
- buint_size_t lzca = biguint128_lzc(a);
- buint_size_t lzcb = biguint128_lzc(b);
- FORRANGE(i, 0, lzca) {
-  FORRANGE(j, 0, lzcb) {
-   buint_size_t k = i + j;
-   if (k < BIGUINT128_CELLS) {
-    UIntPair kmul = uint_mul(a->dat[i], b->dat[j]);
-    buint_bool cx0 = 0;
-    buint_bool cx1 = 0;
-    retv.dat[k] = uint_add(retv.dat[k], kmul.second, &cx0);
-    if (k + 1 < BIGUINT128_CELLS) {
-     if (cx0) {
-      ++carry.dat[k + 1];
-     }
-     retv.dat[k + 1] = uint_add(retv.dat[k + 1], kmul.first, &cx1);
-     if (cx1 && k + 2 < BIGUINT128_CELLS) {
-      ++carry.dat[k + 2];
-     }
-    }
-   }
-  }
- }
- BigUInt128 rx = biguint128_add(&retv, &carry);
- return rx;
+ BigUInt128 retv;
+#ifdef NATIVE_DUINT
+ native_store_(&retv, native_load_(a) * native_load_(b));
+#else
+ dmul_cells_(retv.dat, a->dat, biguint128_lzc(a), b->dat, biguint128_lzc(b), BIGUINT128_CELLS);
+#endif
+ return retv;
 }
 
 BigUIntPair128 biguint128_dmul(const BigUInt128 *a, const BigUInt128 *b) {
- BigUIntPair128 result= {biguint128_ctor_default(), biguint128_ctor_default()};
- BigUIntPair128 carry= {biguint128_ctor_default(), biguint128_ctor_default()};
- buint_size_t lzca = biguint128_lzc(a);
- buint_size_t lzcb = biguint128_lzc(b);
- UInt *res=result.first.dat;
- UInt *crr=carry.first.dat;
-
- FORRANGE(i, 0, lzca) { // iterate over a
-  FORRANGE(j, 0, lzcb) { // iterate over b
-   buint_size_t k = i + j;
-
-   UIntPair kmul = uint_mul(a->dat[i], b->dat[j]);
-   buint_bool cx0 = 0;
-   res[k] = uint_add(res[k], kmul.second, &cx0);
-   if (k + 1 < 2 * BIGUINT128_CELLS) {
-    res[k+1]=uint_add(res[k+1],kmul.first, &cx0);
-    if (cx0 && k + 2 < 2 * BIGUINT128_CELLS) { // highest cell will not overflow, still we check for OOR error.
-     ++crr[k + 2];
-    }
-   }
-  }
- }
- buint_bool cx=0;
- biguint128_adc_replace(&result.first, &result.first, &carry.first, &cx);
- biguint128_adc_replace(&result.second, &result.second, &carry.second, &cx);
+ BigUIntPair128 result;
+ // result.first and result.second are treated as one contiguous array of cells.
+ dmul_cells_(result.first.dat, a->dat, biguint128_lzc(a), b->dat, biguint128_lzc(b), 2 * BIGUINT128_CELLS);
+ return result;
+}
+
+BigUInt128 biguint128_sqr(const BigUInt128 *a) {
+ BigUInt128 retv;
+#ifdef NATIVE_DUINT
+ native_store_(&retv, native_load_(a) * native_load_(a));
+#else
+ dsqr_cells_(retv.dat, a->dat, biguint128_lzc(a), BIGUINT128_CELLS);
+#endif
+ return retv;
+}
+
+BigUIntPair128 biguint128_dsqr(const BigUInt128 *a) {
+ BigUIntPair128 result;
+ // result.first and result.second are treated as one contiguous array of cells.
+ dsqr_cells_(result.first.dat, a->dat, biguint128_lzc(a), 2 * BIGUINT128_CELLS);
  return result;
 }
 
 BigUIntPair128 biguint128_div(const BigUInt128 *a, const BigUInt128 *b) {
- BigUIntPair128 retv = {biguint128_ctor_default(), biguint128_ctor_copy(a)};
- buint_size_t msb_a = biguint128_msb(a);
- buint_size_t msb_b = biguint128_msb(b);
-
- if (!(msb_a < msb_b)) {
-  buint_size_t xbit = msb_a - msb_b;
-  BigUInt128 xdiv = biguint128_shl(b, xbit);
-  buint_size_t msb_x=msb_a;
-  for (buint_size_t i = 0; i <= xbit;) {
-   UInt idiff = 1;
-   if (!lt_brng_(&retv.second, &xdiv, msb_x)) {
-    biguint128_sbit(&retv.first, xbit - i);
-    sub_assign_brng_(&retv.second, &xdiv, xbit - i, xbit - i + msb_b);
-    msb_x = msbnxt_(&retv.second, msb_x);
-    idiff = msb_a - msb_x - i;
-    if (!idiff) idiff = 1;
-   }
-   idiff<UINT_BITS?
-    shr_tiny_brng_(&xdiv, idiff, xbit - i, xbit - i + msb_b):
-    biguint128_shr_assign(&xdiv, idiff);
-   i += idiff;
-  }
+ BigUIntDivisor128 d = biguint128_divisor_ctor(b);
+ return biguint128_div_pre(a, &d);
+}
+
+BigUIntDivisor128 biguint128_divisor_ctor(const BigUInt128 *b) {
+ BigUIntDivisor128 retv;
+ retv.cells = biguint128_lzc(b);
+ retv.shift = 0;
+ retv.inv = 0;
+ if (retv.cells == 0) {
+  retv.val = biguint128_ctor_default();
+  return retv;
  }
+ // normalization: the most significant bit of the divisor must be set.
+ retv.shift = UINT_BITS - 1 - uint_msb(b->dat[retv.cells - 1]);
+ cells_shl_bits(retv.val.dat, b->dat, BIGUINT128_CELLS, retv.shift);
+ retv.inv = uint_reciprocal(retv.val.dat[retv.cells - 1]);
+ return retv;
+}
+
+BigUIntDivisor128 biguint128_divisor_ctor_uint(UInt b) {
+ BigUInt128 bb = biguint128_value_of_uint(b);
+ return biguint128_divisor_ctor(&bb);
+}
+
+BigUIntPair128 biguint128_div_pre(const BigUInt128 *a, const BigUIntDivisor128 *d) {
+ BigUIntPair128 retv = {biguint128_ctor_default(), biguint128_ctor_default()};
+ buint_size_t na = biguint128_lzc(a);
+ buint_size_t nb = d->cells;
+
+ if (na < nb || nb == 0) {
+  retv.second = *a;
+  return retv;
+ }
+
+ UInt u[BIGUINT128_CELLS + 1];
+ u[na] = cells_shl_bits(u, a->dat, na, d->shift);
+ if (nb == 1) {
+  retv.second.dat[0] = cells_div_1(retv.first.dat, u, na, d->val.dat[0], d->inv) >> d->shift;
+  return retv;
+ }
+ cells_div(retv.first.dat, u, na, d->val.dat, nb, d->inv);
+ cells_shr_bits(retv.second.dat, u, nb, d->shift);
+ return retv;
+}
+
+BigUInt128 biguint128_mod_pre(const BigUInt128 *a, const BigUIntDivisor128 *d) {
+ BigUInt128 retv = biguint128_ctor_default();
+ buint_size_t na = biguint128_lzc(a);
+ buint_size_t nb = d->cells;
+
+ if (na < nb || nb == 0) return *a;
+
+ UInt u[BIGUINT128_CELLS + 1];
+ u[na] = cells_shl_bits(u, a->dat, na, d->shift);
+ if (nb == 1) {
+  retv.dat[0] = cells_div_1(NULL, u, na, d->val.dat[0], d->inv) >> d->shift;
+  return retv;
+ }
+ cells_div(NULL, u, na, d->val.dat, nb, d->inv);
+ cells_shr_bits(retv.dat, u, nb, d->shift);
  return retv;
 }
 
@@ -891,37 +929,206 @@ BigUIntPair128 bigint128_div(const BigUInt128 *a, const BigUInt128 *b) {
  return retv;
 }
 
-#define NUINT_CELLS (BIGUINT128_CELLS * sizeof(UInt) / sizeof(nUInt))
 BigUIntTinyPair128 biguint128_div_uint(const BigUInt128 *a, UInt b) {
- nUInt bx = (nUInt)b;
- nUInt *aptr = (nUInt*) a->dat;
+ BigUIntTinyPair128 retv = {biguint128_ctor_default(), 0};
+ if (b == 0) {
+  retv.second = a->dat[0];
+  return retv;
+ }
+#ifdef NATIVE_DUINT
+ DUInt x = native_load_(a);
+ DUInt q = x / b;
+ native_store_(&retv.first, q);
+ retv.second = (UInt)x - (UInt)q * b;
+#else
+ // normalization: the most significant bit of the divisor must be set.
+ buint_size_t shift = UINT_BITS - 1 - uint_msb(b);
+ UInt v = b << shift;
+ retv.second = cells_div_1_shl(retv.first.dat, a->dat, biguint128_lzc(a), v, uint_reciprocal(v), shift);
+#endif
+ return retv;
+}
+
+UInt biguint128_mod_uint(const BigUInt128 *a, UInt b) {
+ if (b == 0) return a->dat[0];
+#ifdef NATIVE_DUINT
+ return (UInt)(native_load_(a) % b);
+#else
+ buint_size_t shift = UINT_BITS - 1 - uint_msb(b);
+ UInt v = b << shift;
+ return cells_div_1_shl(NULL, a->dat, biguint128_lzc(a), v, uint_reciprocal(v), shift);
+#endif
+}
+
+BigUInt128 biguint128_divexact_uint(const BigUInt128 *a, UInt b) {
  BigUInt128 retv = biguint128_ctor_default();
- nUInt *retvptr = (nUInt*) retv.dat;
- wUInt frame;
- nUInt *frameptr = (nUInt*) (&frame);
- wUInt d;
- nUInt *dptr = (nUInt*) (&d);
- wUInt m;
- nUInt *mptr = (nUInt*) (&m);
- frameptr[1] = 0;
- for (unsigned int i = 0; i < NUINT_CELLS; ++i) {
-  frameptr[0] = aptr[NUINT_CELLS - 1 - i];
-  d = frame / bx;
-  m = frame % bx;
-  retvptr[NUINT_CELLS - 1 - i] = dptr[0];
-  frameptr[1] = mptr[0];
+ if (b == 0) return retv;
+
+ // strip the trailing zeros, so that the divisor is odd
+ buint_size_t shift = uint_ctz(b);
+ cells_shr_bits(retv.dat, a->dat, BIGUINT128_CELLS, shift);
+ b >>= shift;
+ cells_divexact_1(retv.dat, retv.dat, biguint128_lzc(&retv), b, uint_inverse(b));
+ return retv;
+}
+
+BigUInt128 biguint128_divexact(const BigUInt128 *a, const BigUInt128 *b) {
+ buint_size_t nb = biguint128_lzc(b);
+ if (nb == 0) return biguint128_ctor_default();
+ if (nb == 1) return biguint128_divexact_uint(a, b->dat[0]);
+
+ // strip the trailing zeros, so that the divisor is odd
+ buint_size_t shift = biguint128_ctz(b);
+ BigUInt128 bodd = biguint128_shr(b, shift);
+ BigUInt128 aodd = biguint128_shr(a, shift);
+
+ // 2-adic inverse of the divisor: Newton iteration from the inverse of the lowest cell
+ BigUInt128 inv = biguint128_value_of_uint(uint_inverse(bodd.dat[0]));
+ for (buint_size_t bits = UINT_BITS; bits < BIGUINT128_CELLS * UINT_BITS; bits *= 2) {
+  BigUInt128 t = biguint128_mul(&bodd, &inv);
+  bigint128_negate_assign(&t);
+  biguint128_add_tiny(&t, 2);
+  inv = biguint128_mul(&inv, &t);
+ }
+ return biguint128_mul(&aodd, &inv);
+}
+
+// ### Section MODULAR ARITHMETIC
+MontCtx128 biguint128_mont_ctor(const BigUInt128 *n) {
+ MontCtx128 retv;
+ retv.n = *n;
+ retv.ninv = -uint_inverse(n->dat[0]);
+ // R mod n = (R - n) mod n
+ BigUIntDivisor128 d = biguint128_divisor_ctor(n);
+ BigUInt128 rn = bigint128_negate(n);
+ retv.r = biguint128_mod_pre(&rn, &d);
+ // R^2 mod n: doubling R mod n (BIGUINT128_CELLS * UINT_BITS) times
+ retv.r2 = retv.r;
+ FORRANGE(i, 0, BIGUINT128_CELLS * UINT_BITS) {
+  UInt carry = cells_shl_bits(retv.r2.dat, retv.r2.dat, BIGUINT128_CELLS, 1);
+  if (carry || !biguint128_lt(&retv.r2, n)) {
+   biguint128_sub_assign(&retv.r2, n);
+  }
  }
- return (BigUIntTinyPair128){retv, (UInt)frameptr[1]};
+ return retv;
+}
+
+BigUInt128 biguint128_to_mont(const MontCtx128 *ctx, const BigUInt128 *a) {
+ return biguint128_mont_mul(ctx, a, &ctx->r2);
+}
+
+BigUInt128 biguint128_from_mont(const MontCtx128 *ctx, const BigUInt128 *a) {
+ UInt t[2 * BIGUINT128_CELLS + 1] = {0};
+ memcpy(t, a->dat, BIGUINT128_CELLS * UINT_BYTES);
+ return mont_redc_(ctx, t);
+}
+
+BigUInt128 biguint128_mont_mul(const MontCtx128 *ctx, const BigUInt128 *a, const BigUInt128 *b) {
+ UInt t[2 * BIGUINT128_CELLS + 1];
+ dmul_cells_(t, a->dat, biguint128_lzc(a), b->dat, biguint128_lzc(b), 2 * BIGUINT128_CELLS);
+ t[2 * BIGUINT128_CELLS] = 0;
+ return mont_redc_(ctx, t);
+}
+
+BigUInt128 biguint128_mont_sqr(const MontCtx128 *ctx, const BigUInt128 *a) {
+ UInt t[2 * BIGUINT128_CELLS + 1];
+ dsqr_cells_(t, a->dat, biguint128_lzc(a), 2 * BIGUINT128_CELLS);
+ t[2 * BIGUINT128_CELLS] = 0;
+ return mont_redc_(ctx, t);
+}
+
+#define MODPOW_MAX_WINDOW 5u
+BigUInt128 biguint128_modpow(const MontCtx128 *ctx, const BigUInt128 *base, const BigUInt128 *exp) {
+ buint_size_t ebits = biguint128_lzb(exp);
+ buint_size_t w = ebits <= 8 ? 1 : ebits <= 24 ? 2 : ebits <= 80 ? 3 : ebits <= 240 ? 4 : MODPOW_MAX_WINDOW;
+ // odd powers of the base: tbl[i] = base^(2*i + 1)
+ BigUInt128 tbl[1u << (MODPOW_MAX_WINDOW - 1)];
+ tbl[0] = biguint128_to_mont(ctx, base);
+ if (1 < w) {
+  BigUInt128 b2 = biguint128_mont_sqr(ctx, &tbl[0]);
+  FORRANGE(i, 1, (buint_size_t)1 << (w - 1)) {
+   tbl[i] = biguint128_mont_mul(ctx, &tbl[i - 1], &b2);
+  }
+ }
+
+ BigUInt128 res = ctx->r;
+ buint_size_t i = ebits;
+ while (0 < i) {
+  // zero bits: squaring only
+  for (buint_size_t nxt = msbnxt_(exp, i); nxt < i; --i) {
+   res = biguint128_mont_sqr(ctx, &res);
+  }
+  if (i == 0) break;
+  // window [lo, i): the longest one ending with a set bit
+  buint_size_t lo = w < i ? i - w : 0;
+  UInt val = bits_(exp, lo, i - lo);
+  buint_size_t tz = uint_ctz(val);
+  lo += tz;
+  val >>= tz;
+  for (buint_size_t j = i; lo < j; --j) {
+   res = biguint128_mont_sqr(ctx, &res);
+  }
+  res = biguint128_mont_mul(ctx, &res, &tbl[val >> 1]);
+  i = lo;
+ }
+ return biguint128_from_mont(ctx, &res);
+}
+#undef MODPOW_MAX_WINDOW
+
+BarrettCtx128 biguint128_barrett_ctor(const BigUInt128 *m) {
+ BarrettCtx128 retv;
+ retv.m = *m;
+ retv.cells = biguint128_lzc(m);
+ memset(retv.mu, 0, sizeof(retv.mu));
+ retv.mucells = 0;
+ if (retv.cells == 0) return retv;
+
+ // mu = b^(2k) / m
+ const buint_size_t k = retv.cells;
+ BigUIntDivisor128 d = biguint128_divisor_ctor(m);
+ UInt u[2 * BIGUINT128_CELLS + 2] = {0};
+ u[2 * k] = (UInt)1 << d.shift; // b^(2k), normalized
+ cells_div(retv.mu, u, 2 * k + 1, d.val.dat, k, d.inv);
+ retv.mucells = k + 2;
+ while (retv.mu[retv.mucells - 1] == 0) --retv.mucells;
+ return retv;
+}
+
+BigUInt128 biguint128_barrett_reduce(const BarrettCtx128 *ctx, const BigUIntPair128 *x) {
+ BigUInt128 retv = biguint128_ctor_default();
+ const buint_size_t k = ctx->cells;
+ if (k == 0) return retv;
+
+ // x->first and x->second are treated as one contiguous array of cells.
+ const UInt *xc = x->first.dat;
+ buint_size_t nx = 2 * BIGUINT128_CELLS;
+ while (0 < nx && xc[nx - 1] == 0) --nx;
+ if (nx < k || (nx == k && cells_lt(xc, ctx->m.dat, k, 0u))) { // already reduced
+  memcpy(retv.dat, xc, nx * UINT_BYTES);
+  return retv;
+ }
+
+ UInt w[2 * BIGUINT128_CELLS] = {0};
+ // number of k-cell digits, the highest two are reduced first
+ buint_size_t c = (nx + k - 1) / k;
+ if (c < 2) c = 2;
+ memcpy(w, xc + (c - 2) * k, (nx - (c - 2) * k) * UINT_BYTES);
+ barrett_step_(retv.dat, w, ctx);
+ FORRANGEREV(j, c - 2) {
+  memcpy(w, xc + j * k, k * UINT_BYTES);
+  memcpy(w + k, retv.dat, k * UINT_BYTES);
+  barrett_step_(retv.dat, w, ctx);
+ }
+ return retv;
 }
-#undef NUINT_CELLS
 
 // ### Section COMPARISON
 buint_bool biguint128_lt(const BigUInt128 *a, const BigUInt128 *b) {
- FOREACHCELLREV(j) {
-  if (a->dat[j]<b->dat[j]) return 1;
-  if (b->dat[j]<a->dat[j]) return 0;
- }
- return 0;
+#ifdef NATIVE_DUINT
+ return native_load_(a) < native_load_(b);
+#else
+ return cells_lt(a->dat, b->dat, BIGUINT128_CELLS, BIGUINT128_STRAIGHT_CELLS);
+#endif
 }
 
 buint_bool bigint128_ltz(const BigUInt128 *a) {
@@ -937,34 +1144,21 @@ buint_bool bigint128_lt(const BigUInt128 *a, const BigUInt128 *b) {
 }
 
 buint_bool biguint128_eq(const BigUInt128 *a, const BigUInt128 *b) {
- FOREACHCELL(i) {
-  if (a->dat[i]!=b->dat[i]) return 0;
- }
- return 1;
+#ifdef NATIVE_DUINT
+ return native_load_(a) == native_load_(b);
+#else
+ return cells_eq(a->dat, b->dat, BIGUINT128_CELLS, BIGUINT128_STRAIGHT_CELLS);
+#endif
 }
 
 buint_bool biguint128_eqz(const BigUInt128 *a) {
- FOREACHCELL(i) {
-  if (a->dat[i]!=0) return 0;
- }
- return 1;
+ return cells_eqz(a->dat, BIGUINT128_CELLS, BIGUINT128_STRAIGHT_CELLS);
 }
 
 // ### Section BIT level
 buint_size_t biguint128_msb(const BigUInt128 *a) {
- buint_size_t j;
- buint_bool found = 0;
- FOREACHCELL(i) {
-  j = BIGUINT128_CELLS - i - 1;
-  if (0 < a->dat[j]) {
-   found = 1;
-   break;
-  }
- }
- if (!found) {
-  return 0;
- }
- return j * UINT_BITS + uint_msb(a->dat[j]);
+ buint_size_t lzc = biguint128_lzc(a);
+ return lzc ? (lzc - 1) * UINT_BITS + uint_msb(a->dat[lzc - 1]) : 0U;
 }
 
 buint_size_t biguint128_lzc(const BigUInt128 *a) {
@@ -983,6 +1177,27 @@ buint_size_t biguint128_lzb(const BigUInt128 *a) {
   0U;
 }
 
+buint_size_t biguint128_clz(const BigUInt128 *a) {
+ return BIGUINT128_CELLS * UINT_BITS - biguint128_lzb(a);
+}
+
+buint_size_t biguint128_ctz(const BigUInt128 *a) {
+ FOREACHCELL(i) {
+  if (a->dat[i] != 0) {
+   return i * UINT_BITS + uint_ctz(a->dat[i]);
+  }
+ }
+ return BIGUINT128_CELLS * UINT_BITS;
+}
+
+buint_size_t biguint128_popcount(const BigUInt128 *a) {
+ buint_size_t retv = 0;
+ FOREACHCELL(i) {
+  retv += uint_popcount(a->dat[i]);
+ }
+ return retv;
+}
+
 void biguint128_sbit(BigUInt128 *a, buint_size_t bit) {
  buint_size_p bit_p = bitpos_(bit);
  a->dat[bit_p.byte_sel]|= (UInt)1 << bit_p.bit_sel;
@@ -1003,35 +1218,12 @@ buint_bool biguint128_gbit(const BigUInt128 *a, buint_size_t bit) {
 
 // ### Section PRINT
 buint_size_t biguint128_print_hex(const BigUInt128 *a, char *buf, buint_size_t buf_len) {
- buint_size_t retv = biguint128_msb(a)/4 + 1;
- if (buf_len < retv) {
-  return 0;
- }
- buint_bool ready = 0;
- for (buint_size_t i=0; !ready && i<BIGUINT128_CELLS; ++i) {
-  for (buint_size_t j=0; !ready && j<UINT_BYTES; ++j) {
-   buint_size_t offset = 2 * (i * UINT_BYTES + j);
-   if (retv <= offset) {
-    ready = 1;
-    break;
-   }
-   if (offset + 1 < retv) {
-    set_hexbyte(buf + retv - offset - 2, a->dat[i]>>8*j & 0xFF);
-   } else {
-    set_hexdigit(buf + retv - offset - 1, a->dat[i]>>8*j & 0xF);
-   }
-  }
- }
- return retv;
+ return biguintn_print_hex(a->dat, BIGUINT128_CELLS, buf, buf_len);
 }
 
 buint_size_t biguint128_print_dec(const BigUInt128 *a, char *buf, buint_size_t buf_len) {
- buint_size_t offset;
- buint_size_t size = print_dec_anywhere_(a, buf, buf_len, &offset);
- for (buint_size_t i = 0; i < size; ++i) {
-  buf[i] = buf[offset + i];
- }
- return size;
+ BigUInt128 temp;
+ return biguintn_print_dec(a->dat, BIGUINT128_CELLS, buf, buf_len, temp.dat);
 }
 
 buint_size_t bigint128_print_dec(const BigUInt128 *a, char *buf, buint_size_t buf_len) {
@@ -49,6 +49,41 @@ typedef struct {
  UInt second;
 } BigUIntTinyPair128;
 
+/**
+ Divisor prepared for repeated divisions by the same value.
+ Stores the normalized divisor (shifted left so that its most significant bit is set)
+ and the reciprocal of its highest cell, so the divisions need no hardware division.
+*/
+typedef struct {
+ BigUInt128 val;		///< Normalized divisor.
+ buint_size_t cells;	///< Number of significant cells of the divisor (0 if the divisor is 0).
+ buint_size_t shift;	///< Bits the divisor is shifted left by at normalization.
+ UInt inv;		///< Reciprocal of the highest significant cell of val.
+} BigUIntDivisor128;
+
+/**
+ Montgomery context of an odd modulus n, with R = 2^128.
+ Values in Montgomery form are stored as a*R mod n.
+*/
+typedef struct {
+ BigUInt128 n;		///< Modulus (odd).
+ BigUInt128 r;		///< R mod n, i.e., 1 in Montgomery form.
+ BigUInt128 r2;		///< R^2 mod n, used for converting to Montgomery form.
+ UInt ninv;		///< n' = -n^(-1) mod 2^UINT_BITS.
+} MontCtx128;
+
+/**
+ Barrett reduction context of a modulus m.
+ With k being the number of cells of m and b = 2^UINT_BITS,
+ the stored reciprocal is mu = floor(b^(2k) / m).
+*/
+typedef struct {
+ BigUInt128 m;		///< Modulus.
+ UInt mu[BIGUINT128_CELLS + 2];	///< Reciprocal of m (at most k + 2 cells).
+ buint_size_t cells;	///< Number of significant cells of m (k).
+ buint_size_t mucells;	///< Number of significant cells of mu.
+} BarrettCtx128;
+
 // constructors
 /**
  @brief Generates BigUInt128 instance initialized to 0.
@@ -178,12 +213,17 @@ BigUInt128 *biguint128_dec(BigUInt128 *a);
 // shift operations
 /**
  @brief Shift left operation.
+ Shifting by at least the width of the type results 0.
+ The _assign variant shifts in place, the _tiny variant shifts by (shift mod UINT bits).
 */
 BigUInt128 biguint128_shl(const BigUInt128 *a, const buint_size_t shift);
+BigUInt128 *biguint128_shl_assign(BigUInt128 *a, const buint_size_t shift);
 BigUInt128 *biguint128_shl_or(BigUInt128 *dest, const BigUInt128 *a, const buint_size_t shift);
 BigUInt128 *biguint128_shl_tiny(BigUInt128 *a, const buint_size_t shift);
 /**
  @brief Shift right operation.
+ Shifting by at least the width of the type results 0.
+ The _assign variant shifts in place, the _tiny variant shifts by (shift mod UINT bits).
 */
 BigUInt128 biguint128_shr(const BigUInt128 *a, const buint_size_t shift);
 BigUInt128 *biguint128_shr_assign(BigUInt128 *a, const buint_size_t shift);
@@ -191,10 +231,14 @@ BigUInt128 *biguint128_shr_tiny(BigUInt128 *a, const buint_size_t shift);
 
 /**
  @brief Rotate left operation.
+ The amount of rotation is taken modulo the width of the type.
+ The _assign variant rotates in place.
 */
 BigUInt128 biguint128_rol(const BigUInt128 *a, const buint_size_t shift);
+BigUInt128 *biguint128_rol_assign(BigUInt128 *a, const buint_size_t shift);
 /**
  @brief Rotate right operation.
+ The amount of rotation is taken modulo the width of the type.
 */
 BigUInt128 biguint128_ror(const BigUInt128 *a, const buint_size_t shift);
 
@@ -234,19 +278,150 @@ BigUInt128 biguint128_mul(const BigUInt128 *a, const BigUInt128 *b);
 */
 BigUIntPair128 biguint128_dmul(const BigUInt128 *a, const BigUInt128 *b);
 
+/**
+ @brief Squaring (faster than biguint128_mul(a, a): the cross products are calculated once).
+ @return Square of a (Least significant 128 bits).
+*/
+BigUInt128 biguint128_sqr(const BigUInt128 *a);
+
+/**
+ @brief Squaring resulting in double long (BigUIntPair128) value.
+ @return Square of a (first: low 128 bits, second: high 128 bits).
+*/
+BigUIntPair128 biguint128_dsqr(const BigUInt128 *a);
+
 /**
  @brief Division of a by b.
+ If b is 0, the quotient is 0 and the remainder is a.
  @return First: quotient, second: remainder.
 */
 BigUIntPair128 biguint128_div(const BigUInt128 *a, const BigUInt128 *b);
+
+/**
+ @brief Division of a by a single UInt value.
+ The divisor is normalized once, then each cell is divided by
+ multiplication with the reciprocal of the divisor.
+ If b is 0, the quotient is 0 and the remainder is the lowest cell of a.
+ @return First: quotient, second: remainder.
+*/
 BigUIntTinyPair128 biguint128_div_uint(const BigUInt128 *a, UInt b);
 
+/**
+ @brief Remainder of the division of a by a single UInt value (a mod b).
+ Same as biguint128_div_uint(a, b).second, but the quotient is not stored.
+ If b is 0, the lowest cell of a is returned.
+*/
+UInt biguint128_mod_uint(const BigUInt128 *a, UInt b);
+
+/**
+ @brief Prepares a divisor for biguint128_div_pre() and biguint128_mod_pre().
+ Worth it when dividing several values by the same divisor.
+ @return Normalized divisor with its reciprocal.
+*/
+BigUIntDivisor128 biguint128_divisor_ctor(const BigUInt128 *b);
+
+/**
+ @brief Prepares a divisor of UInt value for biguint128_div_pre() and biguint128_mod_pre().
+ @return Normalized divisor with its reciprocal.
+*/
+BigUIntDivisor128 biguint128_divisor_ctor_uint(UInt b);
+
+/**
+ @brief Division of a by a prepared divisor.
+ Same result as biguint128_div(), but the divisor is not normalized again.
+ @return First: quotient, second: remainder.
+*/
+BigUIntPair128 biguint128_div_pre(const BigUInt128 *a, const BigUIntDivisor128 *d);
+
+/**
+ @brief Remainder of the division of a by a prepared divisor.
+ @return Remainder (a, if the divisor is 0).
+*/
+BigUInt128 biguint128_mod_pre(const BigUInt128 *a, const BigUIntDivisor128 *d);
+
+/**
+ @brief Exact division of a by a single UInt value.
+ The caller guarantees that b divides a (the remainder is 0), otherwise the result is meaningless.
+ After stripping the trailing zero bits of b, the quotient is computed by
+ multiplication with the 2-adic inverse of b, no division is performed.
+ @return Quotient (0 if b is 0).
+*/
+BigUInt128 biguint128_divexact_uint(const BigUInt128 *a, UInt b);
+
+/**
+ @brief Exact division of a by b.
+ The caller guarantees that b divides a (the remainder is 0), otherwise the result is meaningless.
+ The quotient is the product of a and the 2-adic inverse of b (after stripping the trailing zero bits).
+ @return Quotient (0 if b is 0).
+*/
+BigUInt128 biguint128_divexact(const BigUInt128 *a, const BigUInt128 *b);
+
 /**
  @brief Division of signed values.
  @return First: quotient, second: remainder so that (a == b * quotient + remainder) is true.
 */
 BigUIntPair128 bigint128_div(const BigUInt128 *a, const BigUInt128 *b);
 
+// modular arithmetic
+/**
+ @brief Prepares the Montgomery context of modulus n.
+ @param n Modulus, must be odd.
+ @return Montgomery context.
+*/
+MontCtx128 biguint128_mont_ctor(const BigUInt128 *n);
+
+/**
+ @brief Conversion to Montgomery form.
+ @return a*R mod n.
+*/
+BigUInt128 biguint128_to_mont(const MontCtx128 *ctx, const BigUInt128 *a);
+
+/**
+ @brief Conversion from Montgomery form.
+ @return a*R^(-1) mod n.
+*/
+BigUInt128 biguint128_from_mont(const MontCtx128 *ctx, const BigUInt128 *a);
+
+/**
+ @brief Montgomery multiplication of values in Montgomery form (less than n).
+ @return a*b*R^(-1) mod n.
+*/
+BigUInt128 biguint128_mont_mul(const MontCtx128 *ctx, const BigUInt128 *a, const BigUInt128 *b);
+
+/**
+ @brief Montgomery squaring of a value in Montgomery form (less than n).
+ @return a*a*R^(-1) mod n.
+*/
+BigUInt128 biguint128_mont_sqr(const MontCtx128 *ctx, const BigUInt128 *a);
+
+/**
+ @brief Modular exponentiation (sliding window, Montgomery multiplication).
+ Input and output values are in normal form (not in Montgomery form).
+ @param ctx Montgomery context of the modulus.
+ @param base Base, less than the modulus.
+ @param exp Exponent.
+ @return base^exp mod n.
+*/
+BigUInt128 biguint128_modpow(const MontCtx128 *ctx, const BigUInt128 *base, const BigUInt128 *exp);
+
+/**
+ @brief Prepares the Barrett reduction context of modulus m.
+ @param m Modulus, must not be 0.
+ @return Barrett context.
+*/
+BarrettCtx128 biguint128_barrett_ctor(const BigUInt128 *m);
+
+/**
+ @brief Barrett reduction of a double-width value (e.g., the result of biguint128_dmul()).
+ If x is less than b^(2k) (e.g., the product of two values less than m),
+ a single reduction step is performed with at most two correction subtractions.
+ Larger values are reduced in steps of k cells.
+ @param ctx Barrett context of the modulus.
+ @param x Value to reduce (first: low 128 bits, second: high 128 bits).
+ @return x mod m.
+*/
+BigUInt128 biguint128_barrett_reduce(const BarrettCtx128 *ctx, const BigUIntPair128 *x);
+
 // comparison
 /**
  @brief 'Less than' relation.
@@ -301,6 +476,27 @@ buint_size_t biguint128_lzc(const BigUInt128 *a);
  */
 buint_size_t biguint128_lzb(const BigUInt128 *a);
 
+/**
+ * @brief Count leading zeros.
+ * @param a (Pointing to the) input value to examine.
+ * @return Number of the zero bits above the most significant bit set to 1 (all the bits if a is 0).
+ */
+buint_size_t biguint128_clz(const BigUInt128 *a);
+
+/**
+ * @brief Count trailing zeros.
+ * @param a (Pointing to the) input value to examine.
+ * @return Number of the zero bits below the least significant bit set to 1 (all the bits if a is 0).
+ */
+buint_size_t biguint128_ctz(const BigUInt128 *a);
+
+/**
+ * @brief Population count.
+ * @param a (Pointing to the) input value to examine.
+ * @return Number of the bits set to 1.
+ */
+buint_size_t biguint128_popcount(const BigUInt128 *a);
+
 /**
  @brief Set a bit (to 1) of the value.
  @param a (Pointer to) the value to operate on.
@@ -460,14 +656,14 @@ BigUIntPair128 bigint128_div1000(const BigUInt128 *a);
 BigUIntPair128 biguint128_div30(const BigUInt128 *a);
 
 /**
- * Division by 3 based on multiplication with -(1/3) (modular multiplicative inverse of 3).
+ * Division by 3 based on multiplication with 1/3 (modular multiplicative inverse of 3).
  * @param a Divident.
  * @return Pair of quotient and remainder.
  */
 BigUIntTinyPair128 biguint128_div3(const BigUInt128 *a);
 
 /**
- * Division by 5 based on multiplication with -(1/5) (modular multiplicative inverse of 5).
+ * Division by 5 based on multiplication with 1/5 (modular multiplicative inverse of 5).
  * Division by 10 relies on this function.
  * @param a Divident.
  * @return Pair of quotient and remainder.
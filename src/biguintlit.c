@@ -0,0 +1,147 @@
+/*****************************************************************************
+
+    Copyright 2020 SZIGETI János
+
+    This file is part of biguint library (Big Unsigned Integers).
+
+    Biguint is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Biguint is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+*****************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "biguintn.h"
+
+/**
+ Generator of compile time constants (see biguintlit.h).
+
+ Usage: biguintlit [-b <bits>] [<name>=]<value>...
+ The values are decimal (123), hexadecimal (0x7B) or negative decimal integers (-123, two's complement),
+ or decimal fractions (-1.25, BigDecimal initializer with the number of digits after the dot as precision).
+ Each value is printed as the initializer of a BigUInt<bits> (or BigDecimal<bits>) object,
+ as the replacement list of a macro, if name is given.
+*/
+
+#define MAX_BITS 65536U
+#define MAX_DIGITS (MAX_BITS * 3U / 10U + 2U)
+#define UINT_BITS (8U * sizeof(UInt))
+#define WORDS_PER_CELL (UINT_BITS / 32U)
+
+static UInt val[MAX_BITS / 32U];
+static char digits[MAX_DIGITS];
+
+/**
+ * The 32 bit word of index j of a value.
+ */
+static unsigned long word_(const UInt *a, buint_size_t j) {
+ return (unsigned long)(a[j / WORDS_PER_CELL] >> (32U * (j % WORDS_PER_CELL))) & 0xFFFFFFFFUL;
+}
+
+/**
+ * Parses a value into n cells.
+ * @param bits Width of the type.
+ * @param is_dec Output: the value is a decimal fraction.
+ * @param prec Output: number of digits after the dot.
+ * @return 0: success, otherwise the value is invalid or does not fit into the type.
+ */
+static int parse_(UInt *r, buint_size_t n, buint_size_t bits, const char *str, int *is_dec, buint_size_t *prec) {
+ int neg = str[0] == '-';
+ const char *dot;
+ size_t len;
+ buint_bool ovf;
+ str += neg;
+ len = strlen(str);
+ dot = strchr(str, '.');
+ *is_dec = dot != NULL;
+ *prec = 0;
+ if (len == 0 || MAX_DIGITS <= len) return 1;
+ if (!neg && !*is_dec && 2 < len && str[0] == '0' && (str[1] == 'x' || str[1] == 'X')) {
+  if (strspn(str + 2, "0123456789abcdefABCDEF") != len - 2) return 1;
+  ovf = biguintn_ctor_hexcstream(r, n, str + 2, len - 2);
+ } else {
+  size_t ilen = *is_dec ? (size_t)(dot - str) : len;
+  if (strspn(str, "0123456789") != ilen) return 1;
+  memcpy(digits, str, ilen);
+  if (*is_dec) {
+   *prec = len - ilen - 1;
+   if (strspn(dot + 1, "0123456789") != *prec || ilen + *prec == 0) return 1;
+   memcpy(digits + ilen, dot + 1, *prec);
+  }
+  ovf = biguintn_ctor_deccstream(r, n, digits, ilen + *prec);
+ }
+ // the words over the width of the type (n cells may be wider)
+ for (buint_size_t j = bits / 32U; j < n * WORDS_PER_CELL; ++j) ovf |= word_(r, j) != 0;
+ if (neg || *is_dec) {
+  // signed value: the magnitude must fit into bits - 1 bits (-2^(bits-1) is allowed)
+  int top = word_(r, bits / 32U - 1) >> 31;
+  if (neg) {
+   UInt c = 1;
+   int nz = 0;
+   for (buint_size_t i = 0; i < n; ++i) {
+    nz |= r[i] != 0;
+    r[i] = ~r[i] + c;
+    c = c && r[i] == 0;
+   }
+   ovf |= nz && !(word_(r, bits / 32U - 1) >> 31);
+  } else {
+   ovf |= top;
+  }
+ }
+ return ovf;
+}
+
+static void print_init_(const UInt *a, buint_size_t bits) {
+ buint_size_t words = bits / 32U;
+ printf("{{");
+ for (buint_size_t j = 0; j + 1 < words; j += 2) {
+  printf("%sBIGUINT_LIT2(0x%08lXu, 0x%08lXu)", j ? ", " : "", word_(a, j), word_(a, j + 1));
+ }
+ if (words % 2) {
+  printf("%sBIGUINT_LIT1(0x%08lXu)", 1 < words ? ", " : "", word_(a, words - 1));
+ }
+ printf("}}");
+}
+
+int main(int argc, const char *argv[]) {
+ buint_size_t bits = 128;
+ int argi = 1;
+ if (argi + 1 < argc && strcmp(argv[argi], "-b") == 0) {
+  bits = (buint_size_t)atoi(argv[argi + 1]);
+  argi += 2;
+ }
+ if (argc <= argi || bits == 0 || bits % 32U != 0 || MAX_BITS < bits) {
+  fprintf(stderr, "Usage:\n\t%s [-b <bits>] [<name>=]<value>...\n", argv[0]);
+  fprintf(stderr, "\t<bits>: multiple of 32, at most %u (default: 128)\n", MAX_BITS);
+  return 1;
+ }
+ for (; argi < argc; ++argi) {
+  buint_size_t n = (bits + UINT_BITS - 1) / UINT_BITS;
+  const char *eq = strchr(argv[argi], '=');
+  const char *str = eq ? eq + 1 : argv[argi];
+  int is_dec;
+  buint_size_t prec;
+  memset(val, 0, sizeof(val));
+  if (parse_(val, n, bits, str, &is_dec, &prec)) {
+   fprintf(stderr, "%s: invalid value, or it does not fit into %u bits: %s\n", argv[0], (unsigned int)bits, str);
+   return 1;
+  }
+  if (eq) printf("#define %.*s ", (int)(eq - argv[argi]), argv[argi]);
+  if (is_dec) printf("{");
+  print_init_(val, bits);
+  if (is_dec) printf(", %u}", (unsigned int)prec);
+  printf("\n");
+ }
+ return 0;
+}
+
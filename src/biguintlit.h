@@ -0,0 +1,56 @@
+/*****************************************************************************
+
+    Copyright 2020 SZIGETI János
+
+    This file is part of biguint library (Big Unsigned Integers).
+
+    Biguint is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Biguint is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+*****************************************************************************/
+#ifndef _BIGUINTLIT_H_
+#define _BIGUINTLIT_H_
+
+#include "uint_types.h"
+
+/**
+ Compile time constants of the BigUInt, BigInt and BigDecimal types (C).
+
+ The initializers are generated by the biguintlit program, e.g.,
+ `biguintlit -b 256 POW10_40=10000000000000000000000000000000000000000` prints
+ `#define POW10_40 {{BIGUINT_LIT2(0x00000000u, 0x4B3B4CA8u), ...}}`.
+ The values are written as 32 bit words (from the least significant one), which the macros below
+ arrange into cells of the configured width, so the generated initializers do not depend on the width of UInt.
+ The objects initialized by them are constant initialized (stored in .rodata if they are const):
+
+ static const BigUInt256 pow10_40 = POW10_40;
+*/
+
+#if defined(USE_STD_TYPES) && defined(USE_UINT64_T)
+/**
+ @brief Cell initializer of two 32 bit words (64 bit cells: one cell).
+*/
+#define BIGUINT_LIT2(lo, hi) (((UInt)(hi) << 32) | (UInt)(lo))
+#else
+/**
+ @brief Cell initializers of two 32 bit words (32 bit cells: two cells).
+*/
+#define BIGUINT_LIT2(lo, hi) (UInt)(lo), (UInt)(hi)
+/**
+ @brief Cell initializer of the most significant 32 bit word of an odd number of words (only for 32 bit cells).
+*/
+#define BIGUINT_LIT1(lo) (UInt)(lo)
+#endif
+
+#endif
+
@@ -0,0 +1,149 @@
+/*****************************************************************************
+
+    Copyright 2020 SZIGETI János
+
+    This file is part of biguint library (Big Unsigned Integers).
+
+    Biguint is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Biguint is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+*****************************************************************************/
+#ifndef _BIGUINTMIX_H_
+#define _BIGUINTMIX_H_
+
+#include "biguint128.h"
+#include "biguintn.h"
+
+/**
+ Mixed-width functions of BigUInt types.
+
+ BIGUINT_MIX(W, S) defines the functions of a wide type BigUInt<W> and a narrow type BigUInt<S> (S < W),
+ that iterate over the cells of each operand, the narrow one is never widened:
+ - biguint<S>_widen_<W>(), biguint<W>_narrow_<S>(): conversions;
+ - biguint<W>_add_<S>(), biguint<W>_sub_<S>(): addition / subtraction of the narrow value;
+ - biguint<W>_mul_<S>(), biguint<W>_dmul_<S>(): multiplication by the narrow value;
+ - biguint<W>_div_<S>(), biguint<W>_mod_<S>(): division by the narrow value.
+ The functions are static inline wrappers over the biguintn layer (see biguintn.h).
+
+ The functions of the pairs of the standard widths (128, 256, 384, 512) are defined
+ for the types whose headers are included before this header,
+ other pairs (e.g., with the user-defined width) can be defined by BIGUINT_MIX().
+*/
+
+#define BIGUINT_MIX(W, S) \
+/** @brief Quotient (wide) and remainder (narrow) of a mixed-width division. */ \
+typedef struct { \
+ BigUInt##W first; \
+ BigUInt##S second; \
+} BigUIntPair##W##_##S; \
+\
+/** @brief Conversion to the wider type (zero-extension). */ \
+static inline BigUInt##W biguint##S##_widen_##W(const BigUInt##S *a) { \
+ BigUInt##W retv; \
+ for (buint_size_t i = 0; i < BIGUINT##S##_CELLS; ++i) retv.dat[i] = a->dat[i]; \
+ for (buint_size_t i = BIGUINT##S##_CELLS; i < BIGUINT##W##_CELLS; ++i) retv.dat[i] = 0; \
+ return retv; \
+} \
+\
+/** @brief Conversion to the narrower type (the lowest S bits are kept). */ \
+static inline BigUInt##S biguint##W##_narrow_##S(const BigUInt##W *a) { \
+ BigUInt##S retv; \
+ for (buint_size_t i = 0; i < BIGUINT##S##_CELLS; ++i) retv.dat[i] = a->dat[i]; \
+ return retv; \
+} \
+\
+/** @brief Addition of a narrow value: a + b (the carry is lost). */ \
+static inline BigUInt##W biguint##W##_add_##S(const BigUInt##W *a, const BigUInt##S *b) { \
+ BigUInt##W retv; \
+ biguintn_add(retv.dat, a->dat, BIGUINT##W##_CELLS, b->dat, BIGUINT##S##_CELLS); \
+ return retv; \
+} \
+\
+/** @brief Subtraction of a narrow value: a - b (the borrow is lost). */ \
+static inline BigUInt##W biguint##W##_sub_##S(const BigUInt##W *a, const BigUInt##S *b) { \
+ BigUInt##W retv; \
+ biguintn_sub(retv.dat, a->dat, BIGUINT##W##_CELLS, b->dat, BIGUINT##S##_CELLS); \
+ return retv; \
+} \
+\
+/** @brief Multiplication by a narrow value: a * b (only the lowest W bits of the product are calculated). */ \
+static inline BigUInt##W biguint##W##_mul_##S(const BigUInt##W *a, const BigUInt##S *b) { \
+ BigUInt##W retv; \
+ biguintn_mul_low(retv.dat, a->dat, biguintn_lzc(a->dat, BIGUINT##W##_CELLS), \
+  b->dat, biguintn_lzc(b->dat, BIGUINT##S##_CELLS), BIGUINT##W##_CELLS); \
+ return retv; \
+} \
+\
+/** @brief Multiplication by a narrow value, resulting in double long value (first: low W bits, second: high bits). */ \
+static inline BigUIntPair##W biguint##W##_dmul_##S(const BigUInt##W *a, const BigUInt##S *b) { \
+ UInt prod[BIGUINT##W##_CELLS + BIGUINT##S##_CELLS]; \
+ UInt scratch[BIGUINTN_MUL_SCRATCH(BIGUINT##W##_CELLS, BIGUINT##S##_CELLS)]; \
+ buint_size_t na = biguintn_lzc(a->dat, BIGUINT##W##_CELLS); \
+ buint_size_t nb = biguintn_lzc(b->dat, BIGUINT##S##_CELLS); \
+ BigUIntPair##W retv; \
+ biguintn_mul(prod, a->dat, na, b->dat, nb, scratch); \
+ for (buint_size_t i = 0; i < BIGUINT##W##_CELLS; ++i) { \
+  retv.first.dat[i] = i < na + nb ? prod[i] : 0; \
+  retv.second.dat[i] = BIGUINT##W##_CELLS + i < na + nb ? prod[BIGUINT##W##_CELLS + i] : 0; \
+ } \
+ return retv; \
+} \
+\
+/** \
+ @brief Division by a narrow value. \
+ If b is 0, the quotient is 0 and the remainder is the lowest S bits of a. \
+ @return First: quotient, second: remainder. \
+*/ \
+static inline BigUIntPair##W##_##S biguint##W##_div_##S(const BigUInt##W *a, const BigUInt##S *b) { \
+ UInt scratch[BIGUINTN_DIV_SCRATCH(BIGUINT##W##_CELLS, BIGUINT##S##_CELLS)]; \
+ BigUIntPair##W##_##S retv; \
+ if (!biguintn_div(retv.first.dat, retv.second.dat, a->dat, BIGUINT##W##_CELLS, b->dat, BIGUINT##S##_CELLS, scratch)) { \
+  for (buint_size_t i = 0; i < BIGUINT##W##_CELLS; ++i) retv.first.dat[i] = 0; \
+  retv.second = biguint##W##_narrow_##S(a); \
+ } \
+ return retv; \
+} \
+\
+/** @brief Remainder of the division by a narrow value (the lowest S bits of a, if b is 0). */ \
+static inline BigUInt##S biguint##W##_mod_##S(const BigUInt##W *a, const BigUInt##S *b) { \
+ UInt scratch[BIGUINTN_DIV_SCRATCH(BIGUINT##W##_CELLS, BIGUINT##S##_CELLS)]; \
+ BigUInt##S retv; \
+ if (!biguintn_div(NULL, retv.dat, a->dat, BIGUINT##W##_CELLS, b->dat, BIGUINT##S##_CELLS, scratch)) { \
+  retv = biguint##W##_narrow_##S(a); \
+ } \
+ return retv; \
+}
+
+#ifdef _BIGUINT256_H_
+BIGUINT_MIX(256, 128)
+#endif
+
+#ifdef _BIGUINT384_H_
+BIGUINT_MIX(384, 128)
+#ifdef _BIGUINT256_H_
+BIGUINT_MIX(384, 256)
+#endif
+#endif
+
+#ifdef _BIGUINT512_H_
+BIGUINT_MIX(512, 128)
+#ifdef _BIGUINT256_H_
+BIGUINT_MIX(512, 256)
+#endif
+#ifdef _BIGUINT384_H_
+BIGUINT_MIX(512, 384)
+#endif
+#endif
+
+#endif
+
@@ -0,0 +1,439 @@
+/*****************************************************************************
+
+    Copyright 2020 SZIGETI János
+
+    This file is part of biguint library (Big Unsigned Integers).
+
+    Biguint is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Biguint is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+*****************************************************************************/
+#include "biguintn.h"
+#include "cells.h"
+#include "intio.h"
+#include "uint.h"
+
+#define UINT_BYTES sizeof(UInt)
+#define UINT_BITS (8 * UINT_BYTES)
+
+/////////////////////
+// Internal functions
+
+static void mul_unbalanced_(UInt *r, const UInt *a, buint_size_t na, const UInt *b, buint_size_t nb, UInt *t);
+static inline UInt add_carry_(UInt *r, const UInt *a, buint_size_t n, buint_bool carry);
+static inline UInt sub_carry_(UInt *r, const UInt *a, buint_size_t n, buint_bool carry);
+static UInt base_group_(unsigned int base, buint_size_t *digits);
+static inline void put_digit_(char **p, buint_size_t di, buint_size_t point, UInt d);
+
+/**
+ * Propagates a carry along a cell array: r = a + carry.
+ * @return Carry out.
+ */
+static inline UInt add_carry_(UInt *r, const UInt *a, buint_size_t n, buint_bool carry) {
+ for (buint_size_t i = 0; i < n; ++i) {
+  r[i] = uint_add(a[i], 0, &carry);
+ }
+ return carry;
+}
+
+/**
+ * Propagates a borrow along a cell array: r = a - carry.
+ * @return Borrow out.
+ */
+static inline UInt sub_carry_(UInt *r, const UInt *a, buint_size_t n, buint_bool carry) {
+ for (buint_size_t i = 0; i < n; ++i) {
+  r[i] = uint_sub(a[i], 0, &carry);
+ }
+ return carry;
+}
+
+/**
+ * Highest power of base fitting into a cell: the divisor (multiplier) of a group of digits.
+ * @param digits Output: number of digits in a group.
+ */
+static UInt base_group_(unsigned int base, buint_size_t *digits) {
+ UInt retv = base;
+ *digits = 1;
+ while (retv <= (UInt)~(UInt)0 / base) {
+  retv *= base;
+  ++*digits;
+ }
+ return retv;
+}
+
+/**
+ * Writes digit #di (from the lowest one) before *p, and the decimal point after point digits.
+ */
+static inline void put_digit_(char **p, buint_size_t di, buint_size_t point, UInt d) {
+ static const char chars[] = "0123456789abcdefghijklmnopqrstuvwxyz";
+ if (point != 0 && di == point) *--*p = '.';
+ *--*p = chars[d];
+}
+
+/**
+ * Multiplication of a long and a short factor (nb <= na) in slices of nb cells:
+ * the full slices are multiplied by Karatsuba's method, the shorter last slice
+ * by a recursive call (with the roles of the factors swapped).
+ * Each slice product is added to the product at the offset of the slice.
+ * The lengths of the recursion levels form a Euclidean remainder sequence,
+ * so the product buffers of all the levels sum up to at most 10 * nb cells.
+ * @param r Output: na + nb cells.
+ * @param a Long factor (na cells).
+ * @param na Number of cells of a.
+ * @param b Short factor (nb cells, BIGUINTN_KARATSUBA_CELLS <= nb <= na).
+ * @param nb Number of cells of b.
+ * @param t Scratch space (see BIGUINTN_MUL_SCRATCH()).
+ */
+static void mul_unbalanced_(UInt *r, const UInt *a, buint_size_t na, const UInt *b, buint_size_t nb, UInt *t) {
+ UInt *prod = t;
+ t += 2 * nb;
+ cells_kara_mul(r, a, b, nb, t, BIGUINTN_KARATSUBA_CELLS);
+ for (buint_size_t i = nb; i < na; i += nb) {
+  buint_size_t l = na - i < nb ? na - i : nb;
+  if (l == nb) {
+   cells_kara_mul(prod, a + i, b, nb, t, BIGUINTN_KARATSUBA_CELLS);
+  } else if (l < BIGUINTN_KARATSUBA_CELLS) {
+   cells_mul_base(prod, b, nb, a + i, l, nb + l);
+  } else {
+   mul_unbalanced_(prod, b, nb, a + i, l, t);
+  }
+  // r[i, i + nb) holds the upper half of the previous slice product
+  buint_bool carry = cells_add_n(r + i, prod, nb);
+  add_carry_(r + i + nb, prod + nb, l, carry);
+ }
+}
+
+// END internal functions
+/////////////////////
+
+/////////////////////
+// Public functions
+
+// ### Section ADD / SUB
+UInt biguintn_add(UInt *r, const UInt *a, buint_size_t na, const UInt *b, buint_size_t nb) {
+ buint_bool carry = cells_adc(r, a, b, nb, 0u, 0);
+ return add_carry_(r + nb, a + nb, na - nb, carry);
+}
+
+UInt biguintn_sub(UInt *r, const UInt *a, buint_size_t na, const UInt *b, buint_size_t nb) {
+ buint_bool carry = cells_sbb(r, a, b, nb, 0u, 0);
+ return sub_carry_(r + nb, a + nb, na - nb, carry);
+}
+
+UInt biguintn_add_uint(UInt *r, const UInt *a, buint_size_t n, UInt b) {
+ if (n == 0) return b != 0;
+ buint_bool carry = 0;
+ r[0] = uint_add(a[0], b, &carry);
+ return add_carry_(r + 1, a + 1, n - 1, carry);
+}
+
+UInt biguintn_sub_uint(UInt *r, const UInt *a, buint_size_t n, UInt b) {
+ if (n == 0) return b != 0;
+ buint_bool carry = 0;
+ r[0] = uint_sub(a[0], b, &carry);
+ return sub_carry_(r + 1, a + 1, n - 1, carry);
+}
+
+// ### Section MUL / DIV
+void biguintn_mul(UInt *r, const UInt *a, buint_size_t na, const UInt *b, buint_size_t nb, UInt *scratch) {
+ if (na < nb) {
+  const UInt *x = a;
+  a = b;
+  b = x;
+  buint_size_t nx = na;
+  na = nb;
+  nb = nx;
+ }
+ if (nb < BIGUINTN_KARATSUBA_CELLS) {
+  cells_mul_base(r, a, na, b, nb, na + nb);
+ } else if (na == nb) {
+  cells_kara_mul(r, a, b, na, scratch, BIGUINTN_KARATSUBA_CELLS);
+ } else {
+  mul_unbalanced_(r, a, na, b, nb, scratch);
+ }
+}
+
+void biguintn_mul_low(UInt *r, const UInt *a, buint_size_t na, const UInt *b, buint_size_t nb, buint_size_t n) {
+ cells_mul_base(r, a, na, b, nb, n);
+}
+
+void biguintn_sqr(UInt *r, const UInt *a, buint_size_t n, UInt *scratch) {
+ if (n < BIGUINTN_KARATSUBA_CELLS) {
+  cells_sqr_base(r, a, n, 2 * n);
+ } else {
+  cells_kara_sqr(r, a, n, scratch, BIGUINTN_KARATSUBA_CELLS);
+ }
+}
+
+UInt biguintn_muladd_uint(UInt *a, buint_size_t n, UInt m, UInt c) {
+ return cells_muladd_1(a, n, m, c);
+}
+
+UInt biguintn_div_uint(UInt *q, const UInt *a, buint_size_t n, UInt b) {
+ if (b == 0) {
+  UInt r = n ? a[0] : 0;
+  if (q) memset(q, 0, n * UINT_BYTES);
+  return r;
+ }
+ buint_size_t na = cells_lzc(a, n);
+ buint_size_t shift = UINT_BITS - 1 - uint_msb(b);
+ UInt v = b << shift;
+ UInt r = cells_div_1_shl(q, a, na, v, uint_reciprocal(v), shift);
+ if (q) memset(q + na, 0, (n - na) * UINT_BYTES);
+ return r;
+}
+
+buint_bool biguintn_div(UInt *q, UInt *r, const UInt *a, buint_size_t na, const UInt *b, buint_size_t nb, UInt *scratch) {
+ buint_size_t nas = cells_lzc(a, na);
+ buint_size_t nbs = cells_lzc(b, nb);
+ if (nbs == 0) return 0;
+
+ if (q) memset(q, 0, na * UINT_BYTES);
+ if (r) memset(r, 0, nb * UINT_BYTES);
+ if (nas < nbs) {
+  if (r) memcpy(r, a, nas * UINT_BYTES);
+  return 1;
+ }
+ // normalization: the most significant bit of the divisor must be set.
+ buint_size_t shift = UINT_BITS - 1 - uint_msb(b[nbs - 1]);
+ if (nbs == 1) {
+  UInt v = b[0] << shift;
+  UInt rem = cells_div_1_shl(q, a, nas, v, uint_reciprocal(v), shift);
+  if (r) r[0] = rem;
+  return 1;
+ }
+ UInt *u = scratch;
+ UInt *v = scratch + nas + 1;
+ u[nas] = cells_shl_bits(u, a, nas, shift);
+ cells_shl_bits(v, b, nbs, shift);
+ cells_div(q, u, nas, v, nbs, uint_reciprocal(v[nbs - 1]));
+ if (r) cells_shr_bits(r, u, nbs, shift);
+ return 1;
+}
+
+// ### Section SHIFT
+void biguintn_shl(UInt *r, const UInt *a, buint_size_t n, buint_size_t shift) {
+ cells_shl(r, a, n, 0u, shift);
+}
+
+void biguintn_shr(UInt *r, const UInt *a, buint_size_t n, buint_size_t shift) {
+ cells_shr(r, a, n, 0u, shift);
+}
+
+// ### Section RELATIONS
+buint_size_t biguintn_lzc(const UInt *a, buint_size_t n) {
+ return cells_lzc(a, n);
+}
+
+buint_bool biguintn_lt(const UInt *a, buint_size_t na, const UInt *b, buint_size_t nb) {
+ na = cells_lzc(a, na);
+ nb = cells_lzc(b, nb);
+ return na != nb ? na < nb : cells_lt(a, b, na, 0u);
+}
+
+buint_bool biguintn_eq(const UInt *a, buint_size_t na, const UInt *b, buint_size_t nb) {
+ na = cells_lzc(a, na);
+ nb = cells_lzc(b, nb);
+ return na == nb && cells_eq(a, b, na, 0u);
+}
+
+buint_bool biguintn_eqz(const UInt *a, buint_size_t n) {
+ return cells_eqz(a, n, 0u);
+}
+
+// ### Section PARSE / PRINT
+buint_bool biguintn_ctor_hexcstream(UInt *r, buint_size_t n, const char *hex_digits, buint_size_t len) {
+ memset(r, 0, n * UINT_BYTES);
+ buint_size_t cap = 2 * UINT_BYTES * n;
+ buint_bool oflow = 0;
+ // the digits that do not fit
+ for (buint_size_t i = 0; cap < len && i < len - cap; ++i) {
+  unsigned char x = 0;
+  get_digit(hex_digits[i], 16, &x);
+  oflow |= x != 0;
+ }
+ for (buint_size_t i = 0; i < n; ++i) {
+  for (buint_size_t j = 0; j < UINT_BYTES; ++j) {
+   buint_size_t offset = 2 * (UINT_BYTES * i + j);
+   if (len <= offset) return oflow;
+   unsigned char x;
+   if (offset + 1 < len) {
+    get_hexbyte(hex_digits + len - offset - 2, &x);
+   } else {
+    get_digit(hex_digits[len - offset - 1], 16, &x);
+   }
+   r[i] |= (UInt)x << 8 * j;
+  }
+ }
+ return oflow;
+}
+
+buint_bool biguintn_ctor_deccstream(UInt *r, buint_size_t n, const char *dec_digits, buint_size_t len) {
+ memset(r, 0, n * UINT_BYTES);
+ buint_size_t nr = 0; // significant cells of r
+ buint_bool oflow = 0;
+ for (buint_size_t i = 0; i < len;) {
+  buint_size_t plen = len - i < CELLS_DEC_DIGITS ? len - i : CELLS_DEC_DIGITS;
+  UInt px = 0; // stores the partial, plen digit long value
+  UInt pm = 1; // 10^plen
+  for (buint_size_t pi = 0; pi < plen; ++pi) {
+   unsigned char d = 0;
+   get_digit(dec_digits[i + pi], 10, &d);
+   px = px * 10u + d;
+   pm *= 10u;
+  }
+  UInt carry = cells_muladd_1(r, nr, pm, px);
+  if (carry != 0) {
+   if (nr < n) {
+    r[nr++] = carry;
+   } else {
+    oflow = 1;
+   }
+  }
+  i += plen;
+ }
+ return oflow;
+}
+
+buint_bool biguintn_ctor_basecstream(UInt *r, buint_size_t n, unsigned int base, const char *digits, buint_size_t len) {
+ memset(r, 0, n * UINT_BYTES);
+ if (base < 2 || 36 < base) return 1;
+ buint_size_t gdigits;
+ base_group_(base, &gdigits);
+ buint_size_t nr = 0; // significant cells of r
+ buint_bool oflow = 0;
+ for (buint_size_t i = 0; i < len;) {
+  buint_size_t plen = len - i < gdigits ? len - i : gdigits;
+  UInt px = 0; // stores the partial, plen digit long value
+  UInt pm = 1; // base^plen
+  for (buint_size_t pi = 0; pi < plen; ++pi) {
+   unsigned char d = 0;
+   get_digit(digits[i + pi], base, &d);
+   px = px * base + d;
+   pm *= base;
+  }
+  UInt carry = cells_muladd_1(r, nr, pm, px);
+  if (carry != 0) {
+   if (nr < n) {
+    r[nr++] = carry;
+   } else {
+    oflow = 1;
+   }
+  }
+  i += plen;
+ }
+ return oflow;
+}
+
+buint_size_t biguintn_print_hex(const UInt *a, buint_size_t n, char *buf, buint_size_t buf_len) {
+ buint_size_t na = cells_lzc(a, n);
+ buint_size_t retv = na ? ((na - 1) * UINT_BITS + uint_msb(a[na - 1])) / 4 + 1 : 1;
+ if (buf_len < retv) {
+  return 0;
+ }
+ if (na == 0) {
+  set_hexdigit(buf, 0);
+  return retv;
+ }
+ for (buint_size_t i = 0; i < na; ++i) {
+  for (buint_size_t j = 0; j < UINT_BYTES; ++j) {
+   buint_size_t offset = 2 * (i * UINT_BYTES + j);
+   if (retv <= offset) {
+    return retv;
+   }
+   if (offset + 1 < retv) {
+    set_hexbyte(buf + retv - offset - 2, a[i] >> 8 * j & 0xFF);
+   } else {
+    set_hexdigit(buf + retv - offset - 1, a[i] >> 8 * j & 0xF);
+   }
+  }
+ }
+ return retv;
+}
+
+buint_size_t biguintn_print_dec(const UInt *a, buint_size_t n, char *buf, buint_size_t buf_len, UInt *scratch) {
+ const buint_size_t shift = UINT_BITS - 1 - uint_msb(CELLS_DEC_BASE);
+ const UInt v = CELLS_DEC_BASE << shift;
+ const UInt vinv = uint_reciprocal(v);
+
+ buint_size_t nt = cells_lzc(a, n);
+ buint_size_t offset = buf_len; // the digits are written backwards, from the end of buf
+ if (scratch != a) memcpy(scratch, a, nt * UINT_BYTES);
+ do {
+  UInt d = cells_div_1_shl(scratch, scratch, nt, v, vinv, shift);
+  nt = cells_lzc(scratch, nt);
+  // all the digits of the group, but the leading zeros of the highest group
+  for (buint_size_t pi = 0; pi < CELLS_DEC_DIGITS && (nt != 0 || d != 0 || pi == 0); ++pi) {
+   if (offset == 0) return 0;
+   set_decdigit(buf + --offset, d % 10u);
+   d /= 10u;
+  }
+ } while (nt != 0);
+ memmove(buf, buf + offset, buf_len - offset);
+ return buf_len - offset;
+}
+
+buint_size_t biguintn_print_base(const UInt *a, buint_size_t n, unsigned int base, buint_size_t point, char *buf, buint_size_t buf_len, UInt *scratch) {
+ if (base < 2 || 36 < base) return 0;
+ const buint_size_t lb = (base & (base - 1)) == 0 ? uint_msb(base) : 0; // bits per digit of the power of 2 bases
+ buint_size_t gdigits = 0;
+ UInt *groups = scratch + n; // the lowest group first
+ buint_size_t na = cells_lzc(a, n);
+ buint_size_t len = 1; // significant digits
+ if (lb != 0) {
+  // the digits are bit fields of a
+  if (na != 0) len = ((na - 1) * UINT_BITS + uint_msb(a[na - 1])) / lb + 1;
+ } else {
+  const UInt group = base_group_(base, &gdigits);
+  const buint_size_t shift = UINT_BITS - 1 - uint_msb(group);
+  const UInt v = group << shift;
+  const UInt vinv = uint_reciprocal(v);
+  buint_size_t ng = 0;
+  memcpy(scratch, a, na * UINT_BYTES);
+  do {
+   groups[ng++] = cells_div_1_shl(scratch, scratch, na, v, vinv, shift);
+   na = cells_lzc(scratch, na);
+  } while (na != 0);
+  len = (ng - 1) * gdigits + 1;
+  for (UInt x = groups[ng - 1]; base <= x; x /= base) ++len;
+ }
+ buint_size_t digits = point < len ? len : point + 1; // including the leading 0s
+ buint_size_t retv = digits + (point != 0);
+ if (buf_len < retv) return 0;
+
+ // the digits are written backwards to their final place, the lowest one first
+ char *p = buf + retv;
+ buint_size_t di = 0;
+ if (lb != 0) {
+  for (; di < len; ++di) {
+   buint_size_t offset = di * lb;
+   buint_size_t ci = offset / UINT_BITS;
+   buint_size_t bi = offset % UINT_BITS;
+   UInt field = a[ci] >> bi;
+   if (UINT_BITS < bi + lb && ci + 1 < n) field |= a[ci + 1] << (UINT_BITS - bi);
+   put_digit_(&p, di, point, field & (base - 1));
+  }
+ } else {
+  for (buint_size_t gi = 0; di < len; ++gi) {
+   UInt x = groups[gi];
+   buint_size_t gend = len - di < gdigits ? len : di + gdigits;
+   if (base == 10) { // division by constant
+    for (; di < gend; ++di, x /= 10u) put_digit_(&p, di, point, x % 10u);
+   } else {
+    for (; di < gend; ++di, x /= base) put_digit_(&p, di, point, x % base);
+   }
+  }
+ }
+ for (; di < digits; ++di) put_digit_(&p, di, point, 0);
+ return retv;
+}
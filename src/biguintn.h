@@ -0,0 +1,273 @@
+/*****************************************************************************
+
+    Copyright 2020 SZIGETI János
+
+    This file is part of biguint library (Big Unsigned Integers).
+
+    Biguint is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Biguint is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+*****************************************************************************/
+#ifndef _BIGUINTN_H_
+#define _BIGUINTN_H_
+
+#include "uint_types.h"
+
+/**
+ Runtime-length BigUInt values.
+
+ The functions operate on cell arrays provided by the caller (least significant cell at index 0),
+ the length of the operands (number of cells) is given at runtime, as in the low-level layer of GMP (mpn).
+ Nothing is allocated: where an algorithm needs temporary storage, the caller passes
+ a scratch array of the size given by the corresponding BIGUINTN_*_SCRATCH macro
+ (e.g., on the stack, or a static buffer).
+ The fixed-width types (BigUInt128, BigUInt256, ...) share the algorithms of this layer.
+
+ Unless stated otherwise, the output array may be the same as (but must not partially overlap with) an input array.
+*/
+
+/**
+ @brief Karatsuba cutoff of biguintn_mul() and biguintn_sqr(), in cells.
+*/
+#ifndef BIGUINTN_KARATSUBA_CELLS
+#define BIGUINTN_KARATSUBA_CELLS 32u
+#endif
+
+/**
+ @brief Scratch space of biguintn_mul(), in cells.
+*/
+#define BIGUINTN_MUL_SCRATCH(na, nb) (16u * ((na) < (nb) ? (na) : (nb)) + 128u)
+
+/**
+ @brief Scratch space of biguintn_sqr(), in cells.
+*/
+#define BIGUINTN_SQR_SCRATCH(n) (6u * (n) + 128u)
+
+/**
+ @brief Scratch space of biguintn_div(), in cells.
+*/
+#define BIGUINTN_DIV_SCRATCH(na, nb) ((na) + (nb) + 1u)
+
+/**
+ @brief Scratch space of biguintn_print_base(), in cells.
+*/
+#define BIGUINTN_PRINT_SCRATCH(n) (3u * (n) + 2u)
+
+/**
+ @brief Length of the decimal form of a value of n cells, in digits (upper bound).
+ The digits of 2^bits - 1 are floor(bits * log10(2)) + 1; 1233 / 4096 is below log10(2) by less than 1 / 200000,
+ hence the extra digit (for values shorter than 200000 bits).
+*/
+#define BIGUINTN_DEC_DIGITS(n) ((n) * 8u * sizeof(UInt) * 1233u / 4096u + 2u)
+
+// ### Section ADD / SUB
+/**
+ @brief Addition: r = a + b.
+ @param r Output: na cells.
+ @param a First addend (na cells).
+ @param na Number of cells of a.
+ @param b Second addend (nb cells, nb <= na).
+ @param nb Number of cells of b.
+ @return Carry (0 or 1).
+*/
+UInt biguintn_add(UInt *r, const UInt *a, buint_size_t na, const UInt *b, buint_size_t nb);
+
+/**
+ @brief Subtraction: r = a - b.
+ @param r Output: na cells.
+ @param a Minuend (na cells).
+ @param na Number of cells of a.
+ @param b Subtrahend (nb cells, nb <= na).
+ @param nb Number of cells of b.
+ @return Borrow (0 or 1).
+*/
+UInt biguintn_sub(UInt *r, const UInt *a, buint_size_t na, const UInt *b, buint_size_t nb);
+
+/**
+ @brief Addition of a single UInt value: r = a + b.
+ @param r Output: n cells.
+ @return Carry (0 or 1).
+*/
+UInt biguintn_add_uint(UInt *r, const UInt *a, buint_size_t n, UInt b);
+
+/**
+ @brief Subtraction of a single UInt value: r = a - b.
+ @param r Output: n cells.
+ @return Borrow (0 or 1).
+*/
+UInt biguintn_sub_uint(UInt *r, const UInt *a, buint_size_t n, UInt b);
+
+// ### Section MUL / DIV
+/**
+ @brief Multiplication: r = a * b.
+ Small factors are multiplied by the quadratic basecase, factors of at least BIGUINTN_KARATSUBA_CELLS cells by Karatsuba's method
+ (unbalanced factors in slices of the shorter one).
+ @param r Output: na + nb cells (must not overlap with the factors).
+ @param a First factor (na cells).
+ @param na Number of cells of a.
+ @param b Second factor (nb cells).
+ @param nb Number of cells of b.
+ @param scratch Scratch space of BIGUINTN_MUL_SCRATCH(na, nb) cells.
+*/
+void biguintn_mul(UInt *r, const UInt *a, buint_size_t na, const UInt *b, buint_size_t nb, UInt *scratch);
+
+/**
+ @brief Truncated multiplication: the lowest n cells of a * b.
+ The columns of the product above n are not calculated (quadratic basecase, no scratch space).
+ @param r Output: n cells (must not overlap with the factors).
+ @param a First factor (na cells).
+ @param na Number of cells of a.
+ @param b Second factor (nb cells).
+ @param nb Number of cells of b.
+ @param n Number of cells of the result.
+*/
+void biguintn_mul_low(UInt *r, const UInt *a, buint_size_t na, const UInt *b, buint_size_t nb, buint_size_t n);
+
+/**
+ @brief Squaring: r = a * a (faster than biguintn_mul(): the cross products are calculated once).
+ @param r Output: 2n cells (must not overlap with a).
+ @param a Value to square (n cells).
+ @param n Number of cells of a.
+ @param scratch Scratch space of BIGUINTN_SQR_SCRATCH(n) cells.
+*/
+void biguintn_sqr(UInt *r, const UInt *a, buint_size_t n, UInt *scratch);
+
+/**
+ @brief Multiply-add of single UInt values in place: a = a * m + c.
+ @return Carry cell (the bits above the n cells).
+*/
+UInt biguintn_muladd_uint(UInt *a, buint_size_t n, UInt m, UInt c);
+
+/**
+ @brief Division by a single UInt value: q = a / b.
+ The divisor is normalized once, the dividend is normalized on the fly.
+ If b is 0, the quotient is 0 and the remainder is the lowest cell of a.
+ @param q Output: n cells of the quotient (NULL: the quotient is not stored).
+ @param a Dividend (n cells).
+ @param n Number of cells of a.
+ @param b Divisor.
+ @return Remainder.
+*/
+UInt biguintn_div_uint(UInt *q, const UInt *a, buint_size_t n, UInt b);
+
+/**
+ @brief Division: q = a / b, r = a % b (Knuth's Algorithm D).
+ @param q Output: na cells of the quotient (NULL: the quotient is not stored).
+ @param r Output: nb cells of the remainder (NULL: the remainder is not stored).
+ @param a Dividend (na cells).
+ @param na Number of cells of a.
+ @param b Divisor (nb cells).
+ @param nb Number of cells of b.
+ @param scratch Scratch space of BIGUINTN_DIV_SCRATCH(na, nb) cells.
+ The outputs must not overlap with the inputs.
+ @return Zero: the divisor is 0 (q and r are not written).
+*/
+buint_bool biguintn_div(UInt *q, UInt *r, const UInt *a, buint_size_t na, const UInt *b, buint_size_t nb, UInt *scratch);
+
+// ### Section SHIFT
+/**
+ @brief Shift left: r = a << shift (the bits shifted out of the n cells are lost).
+ @param shift Amount of shifting (any value).
+*/
+void biguintn_shl(UInt *r, const UInt *a, buint_size_t n, buint_size_t shift);
+
+/**
+ @brief Shift right: r = a >> shift.
+ @param shift Amount of shifting (any value).
+*/
+void biguintn_shr(UInt *r, const UInt *a, buint_size_t n, buint_size_t shift);
+
+// ### Section RELATIONS
+/**
+ @brief Number of significant cells.
+ @return Index of the highest non-zero cell plus 1 (0 if a is 0).
+*/
+buint_size_t biguintn_lzc(const UInt *a, buint_size_t n);
+
+/**
+ @brief 'Less than' relation of values of any length.
+ @return Not zero: a is less than b.
+*/
+buint_bool biguintn_lt(const UInt *a, buint_size_t na, const UInt *b, buint_size_t nb);
+
+/**
+ @brief Equality of values of any length.
+ @return Not zero: a equals to b.
+*/
+buint_bool biguintn_eq(const UInt *a, buint_size_t na, const UInt *b, buint_size_t nb);
+
+/**
+ @brief Comparison to zero.
+ @return Not zero: a is 0.
+*/
+buint_bool biguintn_eqz(const UInt *a, buint_size_t n);
+
+// ### Section PARSE / PRINT
+/**
+ @brief Parses a hexadecimal value (without prefix) into n cells.
+ @param r Output: n cells.
+ @return Not zero: the value does not fit into n cells (r holds its lowest n cells).
+*/
+buint_bool biguintn_ctor_hexcstream(UInt *r, buint_size_t n, const char *hex_digits, buint_size_t len);
+
+/**
+ @brief Parses a decimal value into n cells.
+ The digits are processed in groups fitting into a single cell, one multiply-add pass per group.
+ @param r Output: n cells.
+ @return Not zero: the value does not fit into n cells (r holds its lowest n cells).
+*/
+buint_bool biguintn_ctor_deccstream(UInt *r, buint_size_t n, const char *dec_digits, buint_size_t len);
+
+/**
+ @brief Parses a value of any base in range [2, 36] (without prefix and sign) into n cells.
+ Digits greater than 9 may be given either uppercase or lowercase.
+ The digits are processed in groups fitting into a single cell, one multiply-add pass per group.
+ @param r Output: n cells.
+ @param base Base of the digits.
+ @return Not zero: the value does not fit into n cells (r holds its lowest n cells).
+*/
+buint_bool biguintn_ctor_basecstream(UInt *r, buint_size_t n, unsigned int base, const char *digits, buint_size_t len);
+
+/**
+ @brief Export the value in character array format, base 16.
+ The method does not write terminating 0 character.
+ @return Length of the written characters. Zero: buf_len is to small to store the value.
+*/
+buint_size_t biguintn_print_hex(const UInt *a, buint_size_t n, char *buf, buint_size_t buf_len);
+
+/**
+ @brief Export the value in character array format, base 10.
+ The method does not write terminating 0 character.
+ Each division by the highest power of 10 fitting into a cell yields a group of digits,
+ and the dividend shrinks as its highest cells become 0.
+ @param scratch Scratch space of n cells (may be the same as a: then a is destroyed).
+ @return Length of the written characters. Zero: buf_len is to small to store the value.
+*/
+buint_size_t biguintn_print_dec(const UInt *a, buint_size_t n, char *buf, buint_size_t buf_len, UInt *scratch);
+
+/**
+ @brief Export the value in character array format, any base in range [2, 36].
+ Digits greater than 9 are written in lower case. The method does not write terminating 0 character.
+ The groups of digits (remainders of the divisions by the highest power of base fitting into a cell)
+ are collected in the scratch space first (the digits of the power of 2 bases are bit fields of the value),
+ thus the length is known before writing and each digit is written to its final place
+ (no shift after the write, unlike biguintn_print_dec()).
+ @param point Number of digits after the decimal point (0: no decimal point is written).
+ If the value has no more digits than point, leading 0s are written (e.g., 0.05).
+ @param scratch Scratch space of BIGUINTN_PRINT_SCRATCH(n) cells.
+ @return Length of the written characters. Zero: buf_len is to small to store the value, or base is out of range.
+*/
+buint_size_t biguintn_print_base(const UInt *a, buint_size_t n, unsigned int base, buint_size_t point, char *buf, buint_size_t buf_len, UInt *scratch);
+
+#endif
+
@@ -0,0 +1,97 @@
+/*****************************************************************************
+
+    Copyright 2020 SZIGETI János
+
+    This file is part of biguint library (Big Unsigned Integers).
+
+    Biguint is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Biguint is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+*****************************************************************************/
+#include "biguintvec128.h"
+#include "vec_kernel.h"
+
+// Local definitions
+#define FORRANGE(i, LO, HI) for (buint_size_t i=(LO); i<(HI); ++i)
+#define FOREACHCELL(i) FORRANGE(i, 0U, BIGUINT128_CELLS)
+
+// Implementations
+
+BigUIntVec128 biguintvec128_ctor(UInt *dat, buint_size_t len) {
+ BigUIntVec128 v = {dat, len};
+ return v;
+}
+
+void biguintvec128_gather(BigUIntVec128 *v, const BigUInt128 *src) {
+ const buint_size_t n = v->len;
+ FORRANGE(k, 0U, n) {
+  FOREACHCELL(i) v->dat[i * n + k] = src[k].dat[i];
+ }
+}
+
+void biguintvec128_scatter(const BigUIntVec128 *v, BigUInt128 *dest) {
+ const buint_size_t n = v->len;
+ FORRANGE(k, 0U, n) {
+  FOREACHCELL(i) dest[k].dat[i] = v->dat[i * n + k];
+ }
+}
+
+BigUInt128 biguintvec128_get(const BigUIntVec128 *v, buint_size_t k) {
+ BigUInt128 a;
+ FOREACHCELL(i) a.dat[i] = v->dat[i * v->len + k];
+ return a;
+}
+
+void biguintvec128_set(BigUIntVec128 *v, buint_size_t k, const BigUInt128 *a) {
+ FOREACHCELL(i) v->dat[i * v->len + k] = a->dat[i];
+}
+
+void biguintvec128_add(BigUIntVec128 *r, const BigUIntVec128 *a, const BigUIntVec128 *b) {
+ vec_kernel_add(r->dat, a->dat, b->dat, BIGUINT128_CELLS, a->len);
+}
+
+void biguintvec128_sub(BigUIntVec128 *r, const BigUIntVec128 *a, const BigUIntVec128 *b) {
+ vec_kernel_sub(r->dat, a->dat, b->dat, BIGUINT128_CELLS, a->len);
+}
+
+void biguintvec128_min(BigUIntVec128 *r, const BigUIntVec128 *a, const BigUIntVec128 *b) {
+ vec_kernel_min(r->dat, a->dat, b->dat, BIGUINT128_CELLS, a->len);
+}
+
+void biguintvec128_max(BigUIntVec128 *r, const BigUIntVec128 *a, const BigUIntVec128 *b) {
+ vec_kernel_max(r->dat, a->dat, b->dat, BIGUINT128_CELLS, a->len);
+}
+
+void biguintvec128_and(BigUIntVec128 *r, const BigUIntVec128 *a, const BigUIntVec128 *b) {
+ vec_kernel_and(r->dat, a->dat, b->dat, BIGUINTVEC128_SIZE(a->len));
+}
+
+void biguintvec128_or(BigUIntVec128 *r, const BigUIntVec128 *a, const BigUIntVec128 *b) {
+ vec_kernel_or(r->dat, a->dat, b->dat, BIGUINTVEC128_SIZE(a->len));
+}
+
+void biguintvec128_xor(BigUIntVec128 *r, const BigUIntVec128 *a, const BigUIntVec128 *b) {
+ vec_kernel_xor(r->dat, a->dat, b->dat, BIGUINTVEC128_SIZE(a->len));
+}
+
+void biguintvec128_not(BigUIntVec128 *r, const BigUIntVec128 *a) {
+ vec_kernel_not(r->dat, a->dat, BIGUINTVEC128_SIZE(a->len));
+}
+
+void biguintvec128_lt(buint_bool *res, const BigUIntVec128 *a, const BigUIntVec128 *b) {
+ vec_kernel_lt(res, a->dat, b->dat, BIGUINT128_CELLS, a->len);
+}
+
+void biguintvec128_eq(buint_bool *res, const BigUIntVec128 *a, const BigUIntVec128 *b) {
+ vec_kernel_eq(res, a->dat, b->dat, BIGUINT128_CELLS, a->len);
+}
@@ -0,0 +1,113 @@
+/*****************************************************************************
+
+    Copyright 2020 SZIGETI János
+
+    This file is part of biguint library (Big Unsigned Integers).
+
+    Biguint is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Biguint is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+*****************************************************************************/
+#ifndef _BIGUINTVEC128_H_
+#define _BIGUINTVEC128_H_
+
+#include "biguint128.h"
+
+/**
+ Vector of BigUInt128 values in struct-of-arrays layout:
+ cell i of element k is at dat[i * len + k], thus each row holds the same cell of all elements.
+ The elementwise operations process several elements at once with SIMD instructions (see vec_kernel.h),
+ with the carries propagated from row to row in each lane.
+ The storage (BIGUINTVEC128_SIZE(len) cells) is provided by the caller; the vector does not own it.
+*/
+typedef struct {
+ UInt *dat;		///< Rows of cells (BIGUINT128_CELLS rows of len cells).
+ buint_size_t len;	///< Number of elements.
+} BigUIntVec128;
+
+/**
+ Number of cells needed to store len elements.
+*/
+#define BIGUINTVEC128_SIZE(len) (BIGUINT128_CELLS * (len))
+
+/**
+ @brief Constructor (the content of the storage is left as it is).
+ @param dat Storage of BIGUINTVEC128_SIZE(len) cells.
+ @param len Number of elements.
+*/
+BigUIntVec128 biguintvec128_ctor(UInt *dat, buint_size_t len);
+
+/**
+ @brief Loads len values into the vector (array-of-structs to struct-of-arrays).
+ @param src Array of v->len values.
+*/
+void biguintvec128_gather(BigUIntVec128 *v, const BigUInt128 *src);
+
+/**
+ @brief Stores the elements of the vector (struct-of-arrays to array-of-structs).
+ @param dest Array of v->len values.
+*/
+void biguintvec128_scatter(const BigUIntVec128 *v, BigUInt128 *dest);
+
+/**
+ @brief Gets element k.
+*/
+BigUInt128 biguintvec128_get(const BigUIntVec128 *v, buint_size_t k);
+
+/**
+ @brief Sets element k.
+*/
+void biguintvec128_set(BigUIntVec128 *v, buint_size_t k, const BigUInt128 *a);
+
+/**
+ @brief Elementwise addition with overflow: r[k] = a[k] + b[k].
+ The vectors must have the same length; r may be the same as a or b.
+*/
+void biguintvec128_add(BigUIntVec128 *r, const BigUIntVec128 *a, const BigUIntVec128 *b);
+
+/**
+ @brief Elementwise subtraction with underflow: r[k] = a[k] - b[k].
+*/
+void biguintvec128_sub(BigUIntVec128 *r, const BigUIntVec128 *a, const BigUIntVec128 *b);
+
+/**
+ @brief Elementwise minimum: r[k] = min(a[k], b[k]).
+*/
+void biguintvec128_min(BigUIntVec128 *r, const BigUIntVec128 *a, const BigUIntVec128 *b);
+
+/**
+ @brief Elementwise maximum: r[k] = max(a[k], b[k]).
+*/
+void biguintvec128_max(BigUIntVec128 *r, const BigUIntVec128 *a, const BigUIntVec128 *b);
+
+/**
+ @brief Elementwise bitwise operations.
+*/
+void biguintvec128_and(BigUIntVec128 *r, const BigUIntVec128 *a, const BigUIntVec128 *b);
+void biguintvec128_or(BigUIntVec128 *r, const BigUIntVec128 *a, const BigUIntVec128 *b);
+void biguintvec128_xor(BigUIntVec128 *r, const BigUIntVec128 *a, const BigUIntVec128 *b);
+void biguintvec128_not(BigUIntVec128 *r, const BigUIntVec128 *a);
+
+/**
+ @brief Elementwise 'less than' relation: res[k] = a[k] < b[k].
+ @param res Array of a->len values.
+*/
+void biguintvec128_lt(buint_bool *res, const BigUIntVec128 *a, const BigUIntVec128 *b);
+
+/**
+ @brief Elementwise equality: res[k] = a[k] == b[k].
+ @param res Array of a->len values.
+*/
+void biguintvec128_eq(buint_bool *res, const BigUIntVec128 *a, const BigUIntVec128 *b);
+
+#endif
@@ -0,0 +1,761 @@
+/*****************************************************************************
+
+    Copyright 2020 SZIGETI János
+
+    This file is part of biguint library (Big Unsigned Integers).
+
+    Biguint is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Biguint is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+*****************************************************************************/
+#ifndef _CELLS_H_
+#define _CELLS_H_
+
+#include <string.h>
+#include "mul_kernel.h"
+#include "uint.h"
+
+/**
+ Width-generic kernels of cell arrays.
+
+ The whole-width kernels (cells_adc() ... cells_shr()) take the number of cells (n) and the length of their straight-line part (u).
+ The first min(n, u, CELLS_STRAIGHT_MAX) steps are emitted one by one by the preprocessor (CELLS_STRAIGHT_),
+ each of them guarded by its index; the remaining cells (if any) are processed by a loop.
+ The BigUInt types call the kernels with compile time constant n and u, so the guards are
+ resolved by the compiler, and the operations of narrow types become unrolled straight-line
+ code (e.g., a single add / adc chain) whose operands can be kept in registers,
+ regardless of the unrolling heuristics (or pragmas) of the compiler.
+*/
+
+/**
+ @brief Maximal length of the straight-line part of the kernels.
+*/
+#define CELLS_STRAIGHT_MAX 32u
+
+/**
+ @brief Default length of the straight-line part of the kernels (it can be overridden for each width).
+*/
+#ifndef CELLS_STRAIGHT_DEFAULT
+#define CELLS_STRAIGHT_DEFAULT 16u
+#endif
+
+// Expands M(k) for k = o, o + 1, ..., o + 2^x - 1 (x is the suffix).
+#define CELLS_REP1_(M, o) M(o)
+#define CELLS_REP2_(M, o) CELLS_REP1_(M, o) CELLS_REP1_(M, (o) + 1u)
+#define CELLS_REP4_(M, o) CELLS_REP2_(M, o) CELLS_REP2_(M, (o) + 2u)
+#define CELLS_REP8_(M, o) CELLS_REP4_(M, o) CELLS_REP4_(M, (o) + 4u)
+#define CELLS_REP16_(M, o) CELLS_REP8_(M, o) CELLS_REP8_(M, (o) + 8u)
+#define CELLS_REP32_(M, o) CELLS_REP16_(M, o) CELLS_REP16_(M, (o) + 16u)
+// Straight-line part of a kernel: M(k) for the steps k < min(n, u), where n and u are the parameters of the kernel.
+#define CELLS_STEP_(M, k) if ((k) < n && (k) < u) { M(k); }
+#define CELLS_STRAIGHT_(M) CELLS_REP32_(M, 0u)
+// Number of steps of the straight-line part (the loops of the kernels continue from here).
+#define CELLS_STRAIGHT_LEN_(u) ((u) < CELLS_STRAIGHT_MAX ? (u) : CELLS_STRAIGHT_MAX)
+
+#define CELLS_UINT_BITS_ (8u * (buint_size_t)sizeof(UInt))
+
+// The kernels are always inlined: the compiler decides on inlining before it resolves the guards,
+// so the straight-line parts would seem too long otherwise.
+#if defined(__GNUC__) || defined(__clang__)
+#define CELLS_KERNEL_ static inline __attribute__((always_inline))
+#else
+#define CELLS_KERNEL_ static inline
+#endif
+
+/**
+ @brief Funnel shift right: the low cell of (hi:lo) >> shift.
+ The high cell is shifted in two steps, so that shift may be 0 as well (without branching).
+ @param hi High cell.
+ @param lo Low cell.
+ @param shift Amount of shifting [0, UINT_BITS).
+ @return Bits [shift, shift + UINT_BITS) of hi:lo.
+*/
+static inline UInt cells_funnel(UInt hi, UInt lo, buint_size_t shift) {
+ return (lo >> shift) | ((hi << 1) << (CELLS_UINT_BITS_ - 1 - shift));
+}
+
+/**
+ @brief Source cell of a shift, masked instead of branching.
+ @param src Value to shift.
+ @param j Index of the source cell (not read if it is out of range).
+ @param in The index is in range.
+ @return src[j] if in, otherwise 0.
+*/
+static inline UInt cells_src(const UInt *src, buint_size_t j, buint_bool in) {
+ return src[in ? j : 0] & -(UInt)in;
+}
+
+/**
+ @brief Addition with carry: r = a + b + c.
+ r may be the same as a or b.
+ @return Carry out (0 or 1).
+*/
+CELLS_KERNEL_ buint_bool cells_adc(UInt *r, const UInt *a, const UInt *b, buint_size_t n, buint_size_t u, buint_bool c) {
+#define CELLS_ADC_(k) r[k] = uint_add(a[k], b[k], &c)
+#define CELLS_ADC_STEP_(k) CELLS_STEP_(CELLS_ADC_, k)
+ CELLS_STRAIGHT_(CELLS_ADC_STEP_)
+ for (buint_size_t k = CELLS_STRAIGHT_LEN_(u); k < n; ++k) CELLS_ADC_(k);
+#undef CELLS_ADC_STEP_
+#undef CELLS_ADC_
+ return c;
+}
+
+/**
+ @brief Subtraction with borrow: r = a - b - c.
+ r may be the same as a or b.
+ @return Borrow out (0 or 1).
+*/
+CELLS_KERNEL_ buint_bool cells_sbb(UInt *r, const UInt *a, const UInt *b, buint_size_t n, buint_size_t u, buint_bool c) {
+#define CELLS_SBB_(k) r[k] = uint_sub(a[k], b[k], &c)
+#define CELLS_SBB_STEP_(k) CELLS_STEP_(CELLS_SBB_, k)
+ CELLS_STRAIGHT_(CELLS_SBB_STEP_)
+ for (buint_size_t k = CELLS_STRAIGHT_LEN_(u); k < n; ++k) CELLS_SBB_(k);
+#undef CELLS_SBB_STEP_
+#undef CELLS_SBB_
+ return c;
+}
+
+/**
+ @brief 'Less than' relation.
+ Arrays of at most u cells are compared by a borrow chain (without branches),
+ longer ones from the highest cell down to the first difference.
+*/
+CELLS_KERNEL_ buint_bool cells_lt(const UInt *a, const UInt *b, buint_size_t n, buint_size_t u) {
+ if (CELLS_STRAIGHT_LEN_(u) < n) {
+  for (buint_size_t k = n; 0 < k--;) {
+   if (a[k] != b[k]) return a[k] < b[k];
+  }
+  return 0;
+ }
+ buint_bool c = 0;
+#define CELLS_LT_(k) uint_sub(a[k], b[k], &c)
+#define CELLS_LT_STEP_(k) CELLS_STEP_(CELLS_LT_, k)
+ CELLS_STRAIGHT_(CELLS_LT_STEP_)
+#undef CELLS_LT_STEP_
+#undef CELLS_LT_
+ return c;
+}
+
+/**
+ @brief Equality.
+ Arrays of at most u cells are compared without branches,
+ longer ones up to the first difference.
+*/
+CELLS_KERNEL_ buint_bool cells_eq(const UInt *a, const UInt *b, buint_size_t n, buint_size_t u) {
+ if (CELLS_STRAIGHT_LEN_(u) < n) {
+  for (buint_size_t k = 0; k < n; ++k) {
+   if (a[k] != b[k]) return 0;
+  }
+  return 1;
+ }
+ UInt d = 0;
+#define CELLS_EQ_(k) d |= a[k] ^ b[k]
+#define CELLS_EQ_STEP_(k) CELLS_STEP_(CELLS_EQ_, k)
+ CELLS_STRAIGHT_(CELLS_EQ_STEP_)
+#undef CELLS_EQ_STEP_
+#undef CELLS_EQ_
+ return d == 0;
+}
+
+/**
+ @brief Comparison to zero.
+ Arrays of at most u cells are checked without branches,
+ longer ones up to the first non-zero cell.
+*/
+CELLS_KERNEL_ buint_bool cells_eqz(const UInt *a, buint_size_t n, buint_size_t u) {
+ if (CELLS_STRAIGHT_LEN_(u) < n) {
+  for (buint_size_t k = 0; k < n; ++k) {
+   if (a[k] != 0) return 0;
+  }
+  return 1;
+ }
+ UInt d = 0;
+#define CELLS_EQZ_(k) d |= a[k]
+#define CELLS_EQZ_STEP_(k) CELLS_STEP_(CELLS_EQZ_, k)
+ CELLS_STRAIGHT_(CELLS_EQZ_STEP_)
+#undef CELLS_EQZ_STEP_
+#undef CELLS_EQZ_
+ return d == 0;
+}
+
+/**
+ @brief Shift left by any amount, in a single pass of funnel shifts
+ (the move of whole cells and the shift of the bits together).
+ The pass goes downwards, each source cell is read once, so r may be the same as a.
+ @param r Output: n cells of the shifted value.
+ @param a Value to shift (n cells).
+ @param shift Amount of shifting (the result is 0 from n * UINT_BITS).
+*/
+CELLS_KERNEL_ void cells_shl(UInt *r, const UInt *a, buint_size_t n, buint_size_t u, buint_size_t shift) {
+ buint_size_t cells = shift / CELLS_UINT_BITS_;
+ buint_size_t bits = shift % CELLS_UINT_BITS_;
+ UInt hi = cells_src(a, n - 1 - cells, cells < n);
+#define CELLS_SHL_(k) do { \
+  buint_size_t i = n - 1 - (k); \
+  UInt lo = cells_src(a, i - cells - 1, cells < i); \
+  r[i] = (hi << bits) | ((lo >> 1) >> (CELLS_UINT_BITS_ - 1 - bits)); \
+  hi = lo; \
+ } while (0)
+#define CELLS_SHL_STEP_(k) CELLS_STEP_(CELLS_SHL_, k)
+ CELLS_STRAIGHT_(CELLS_SHL_STEP_)
+ for (buint_size_t k = CELLS_STRAIGHT_LEN_(u); k < n; ++k) CELLS_SHL_(k);
+#undef CELLS_SHL_STEP_
+#undef CELLS_SHL_
+}
+
+/**
+ @brief Shift right by any amount, in a single pass of funnel shifts
+ (the move of whole cells and the shift of the bits together).
+ The pass goes upwards, each source cell is read once, so r may be the same as a.
+ @param r Output: n cells of the shifted value.
+ @param a Value to shift (n cells).
+ @param shift Amount of shifting (the result is 0 from n * UINT_BITS).
+*/
+CELLS_KERNEL_ void cells_shr(UInt *r, const UInt *a, buint_size_t n, buint_size_t u, buint_size_t shift) {
+ buint_size_t cells = shift / CELLS_UINT_BITS_;
+ buint_size_t bits = shift % CELLS_UINT_BITS_;
+ UInt lo = cells_src(a, cells, cells < n);
+#define CELLS_SHR_(k) do { \
+  UInt hi = cells_src(a, (k) + cells + 1, cells + 1 < n - (k)); \
+  r[k] = cells_funnel(hi, lo, bits); \
+  lo = hi; \
+ } while (0)
+#define CELLS_SHR_STEP_(k) CELLS_STEP_(CELLS_SHR_, k)
+ CELLS_STRAIGHT_(CELLS_SHR_STEP_)
+ for (buint_size_t k = CELLS_STRAIGHT_LEN_(u); k < n; ++k) CELLS_SHR_(k);
+#undef CELLS_SHR_STEP_
+#undef CELLS_SHR_
+}
+
+/*
+ Runtime-length kernels.
+
+ The algorithms of the BigUInt types that work on cell arrays of any length
+ (multiplication, division, shifts by less than a cell). They are shared by the
+ fixed-width types (with constant lengths after inlining) and the runtime-length layer (biguintn.h).
+*/
+
+// Unrolled carry chains of the loops compile to plain adc / sbb sequences.
+#if defined(USE_CARRY_BUILTINS) && defined(__clang__)
+#define CELLS_UNROLL_CARRY_ _Pragma("unroll")
+#elif defined(USE_CARRY_BUILTINS) && defined(__GNUC__) && (__GNUC__ >= 8)
+#define CELLS_UNROLL_CARRY_ _Pragma("GCC unroll 16")
+#else
+#define CELLS_UNROLL_CARRY_
+#endif
+
+/**
+ @brief Scratch space of the Karatsuba multiplication of n-cell factors, in cells:
+ at most 3n + 4 cells on each recursion level (n halves each time).
+*/
+#define CELLS_KARATSUBA_SCRATCH(n) (6u * (n) + 128u)
+
+/**
+ @brief The highest power of 10 that can be represented in UInt type (and its exponent),
+ i.e., the divisor of the decimal printing (one division by it gives this many digits).
+*/
+#if defined(SIZEOF_UINT) && (SIZEOF_UINT != 2) && (SIZEOF_UINT != 4) && (SIZEOF_UINT != 8)
+#error CELLS_DEC_DIGITS and CELLS_DEC_BASE are defined for 16, 32 and 64 bit UInt cells only.
+#endif
+#define CELLS_DEC_DIGITS (sizeof(UInt) < 4u ? 4u : sizeof(UInt) < 8u ? 9u : 19u)
+#define CELLS_DEC_BASE (sizeof(UInt) < 4u ? (UInt)10000u : sizeof(UInt) < 8u ? (UInt)1000000000ul : (UInt)10000000000000000000ull)
+
+/**
+ @brief Number of significant cells.
+ @return Index of the highest non-zero cell plus 1 (0 if all cells are 0).
+*/
+static inline buint_size_t cells_lzc(const UInt *a, buint_size_t n) {
+ while (0 < n && a[n - 1] == 0) --n;
+ return n;
+}
+
+/**
+ @brief Add-assignment of cell arrays.
+ @param a Subject of operation (n cells).
+ @param b Cell array to add (n cells).
+ @param n Number of cells.
+ @return Carry (0 or 1).
+*/
+static inline UInt cells_add_n(UInt *a, const UInt *b, buint_size_t n) {
+ buint_bool carry = 0;
+ CELLS_UNROLL_CARRY_
+ for (buint_size_t i = 0; i < n; ++i) {
+  uint_add_assign(&a[i], b[i], &carry);
+ }
+ return carry;
+}
+
+/**
+ @brief Subtract-assignment of cell arrays.
+ @param a Subject of operation (n cells).
+ @param b Cell array to subtract (n cells).
+ @param n Number of cells.
+ @return Borrow (0 or 1).
+*/
+static inline UInt cells_sub_n(UInt *a, const UInt *b, buint_size_t n) {
+ buint_bool carry = 0;
+ CELLS_UNROLL_CARRY_
+ for (buint_size_t i = 0; i < n; ++i) {
+  uint_sub_assign(&a[i], b[i], &carry);
+ }
+ return carry;
+}
+
+/**
+ @brief Multiply-accumulate step of the product scanning multiplication.
+ @param acc Three-cell accumulator (least significant cell at index 0).
+ @param a Factor.
+ @param b Factor.
+*/
+static inline void cells_mac(UInt *acc, UInt a, UInt b) {
+ UIntPair prod = uint_mul(a, b);
+ buint_bool carry = 0;
+ acc[0] = uint_add(acc[0], prod.second, &carry);
+ acc[1] = uint_add(acc[1], prod.first, &carry);
+ acc[2] += carry;
+}
+
+/**
+ @brief Product scanning (column-wise) multiplication of two cell arrays.
+ Column k of the product collects the partial products a[i]*b[k-i]
+ in a three-cell accumulator, then the lowest cell of the accumulator is
+ written to res[k] and the accumulator is shifted down by one cell.
+ Thus, each output cell is written exactly once, and neither columns above ncols
+ (that would be truncated anyway) nor columns above na + nb (that are 0) are calculated.
+ @param res Output: ncols cells of the product.
+ @param a First factor.
+ @param na Number of significant cells of a (cells above are treated as 0).
+ @param b Second factor.
+ @param nb Number of significant cells of b (cells above are treated as 0).
+ @param ncols Number of calculated product cells.
+*/
+static inline void cells_mul_cols(UInt *res, const UInt *a, buint_size_t na, const UInt *b, buint_size_t nb, buint_size_t ncols) {
+ UInt acc[3] = {0, 0, 0};
+ buint_size_t nk = na + nb < ncols ? na + nb : ncols;
+ for (buint_size_t k = 0; k < nk; ++k) {
+  buint_size_t ilo = nb < k + 1 ? k + 1 - nb : 0;
+  buint_size_t ihi = na < k + 1 ? na : k + 1;
+  for (buint_size_t i = ilo; i < ihi; ++i) {
+   cells_mac(acc, a[i], b[k - i]);
+  }
+  res[k] = acc[0];
+  acc[0] = acc[1];
+  acc[1] = acc[2];
+  acc[2] = 0;
+ }
+ memset(res + nk, 0, (ncols - nk) * sizeof(UInt));
+}
+
+/**
+ @brief Product scanning squaring of a cell array.
+ Same as cells_mul_cols(res, a, na, a, na, ncols), but in each column the off-diagonal
+ products a[i]*a[k-i] (i < k-i) are calculated only once, and their sum is doubled.
+ @param res Output: ncols cells of the square.
+ @param a Value to square.
+ @param na Number of significant cells of a (cells above are treated as 0).
+ @param ncols Number of calculated cells.
+*/
+static inline void cells_sqr_cols(UInt *res, const UInt *a, buint_size_t na, buint_size_t ncols) {
+ UInt acc[3] = {0, 0, 0};
+ buint_size_t nk = 2 * na < ncols ? 2 * na : ncols;
+ for (buint_size_t k = 0; k < nk; ++k) {
+  UInt cross[3] = {0, 0, 0};
+  buint_size_t ilo = na < k + 1 ? k + 1 - na : 0;
+  for (buint_size_t i = ilo; 2 * i < k; ++i) {
+   cells_mac(cross, a[i], a[k - i]);
+  }
+  // acc += 2 * cross
+  buint_bool carry = 0;
+  acc[0] = uint_add(acc[0], cross[0] << 1, &carry);
+  acc[1] = uint_add(acc[1], (cross[1] << 1) | (cross[0] >> (CELLS_UINT_BITS_ - 1)), &carry);
+  acc[2] = uint_add(acc[2], (cross[2] << 1) | (cross[1] >> (CELLS_UINT_BITS_ - 1)), &carry);
+  if (!(k & 1)) {
+   cells_mac(acc, a[k / 2], a[k / 2]);
+  }
+  res[k] = acc[0];
+  acc[0] = acc[1];
+  acc[1] = acc[2];
+  acc[2] = 0;
+ }
+ memset(res + nk, 0, (ncols - nk) * sizeof(UInt));
+}
+
+/**
+ @brief Basecase multiplication by the active kernel (see mul_kernel.h).
+ @param res Output: ncols cells of the product (must not overlap with the factors).
+ @param a First factor.
+ @param na Number of significant cells of a.
+ @param b Second factor.
+ @param nb Number of significant cells of b.
+ @param ncols Number of calculated product cells.
+*/
+static inline void cells_mul_base(UInt *res, const UInt *a, buint_size_t na, const UInt *b, buint_size_t nb, buint_size_t ncols) {
+#ifdef MUL_KERNEL_HAVE_MULX_ADX
+ if (mul_kernel_active == MUL_KERNEL_MULX_ADX && (na + nb <= ncols || MUL_KERNEL_MULX_TRUNC_CELLS <= ncols)) {
+  mul_kernel_mulx_mul(res, a, na, b, nb, ncols);
+  return;
+ }
+#endif
+ cells_mul_cols(res, a, na, b, nb, ncols);
+}
+
+/**
+ @brief Basecase squaring by the active kernel (see mul_kernel.h).
+ @param res Output: ncols cells of the square (must not overlap with a).
+ @param a Value to square.
+ @param na Number of significant cells of a.
+ @param ncols Number of calculated cells.
+*/
+static inline void cells_sqr_base(UInt *res, const UInt *a, buint_size_t na, buint_size_t ncols) {
+#ifdef MUL_KERNEL_HAVE_MULX_ADX
+ if (mul_kernel_active == MUL_KERNEL_MULX_ADX && (2 * na <= ncols || MUL_KERNEL_MULX_TRUNC_CELLS <= ncols)) {
+  mul_kernel_mulx_sqr(res, a, na, ncols);
+  return;
+ }
+#endif
+ cells_sqr_cols(res, a, na, ncols);
+}
+
+/**
+ @brief Absolute difference of two cell arrays.
+ @param res Output: |a - b| (na cells).
+ @param a Cell array of na cells.
+ @param na Number of cells of a.
+ @param b Cell array of nb cells (nb <= na), treated as zero-extended to na cells.
+ @param nb Number of cells of b.
+ @return Not zero: a is less than b.
+*/
+static inline buint_bool cells_abs_diff(UInt *res, const UInt *a, buint_size_t na, const UInt *b, buint_size_t nb) {
+ buint_bool a_lt_b = 0;
+ buint_size_t i = na;
+ while (nb < i && a[i - 1] == 0) --i; // the cells of a above nb are compared to 0
+ if (i <= nb) {
+  while (0 < i && a[i - 1] == b[i - 1]) --i;
+  a_lt_b = (0 < i && a[i - 1] < b[i - 1]);
+ }
+ const UInt *x = a_lt_b ? b : a;
+ const UInt *y = a_lt_b ? a : b;
+ buint_size_t ny = a_lt_b ? na : nb;
+ buint_size_t nx = a_lt_b ? nb : na;
+ buint_bool carry = 0;
+ for (buint_size_t j = 0; j < na; ++j) {
+  res[j] = uint_sub(j < nx ? x[j] : 0, j < ny ? y[j] : 0, &carry);
+ }
+ return a_lt_b;
+}
+
+/**
+ @brief Middle step of Karatsuba's method: adds z0 + z2 -/+ p to res at offset h.
+ @param res Product of 2n cells: z0 (2h cells) and z2 (2m cells) are already there.
+ @param n Number of cells of the factors (n = h + m, h = n / 2).
+ @param w Scratch of 2m + 1 cells.
+ @param p The product |a1 - a0| * |b1 - b0| (2m cells).
+ @param p_neg Not zero: (a1 - a0) * (b1 - b0) is negative, i.e., p is to be added.
+*/
+static inline void cells_kara_combine(UInt *res, buint_size_t n, UInt *w, const UInt *p, buint_bool p_neg) {
+ const buint_size_t h = n / 2;
+ const buint_size_t m = n - h;
+ // w = z0 + z2
+ buint_bool carry = 0;
+ for (buint_size_t i = 0; i < 2 * m; ++i) {
+  w[i] = uint_add(i < 2 * h ? res[i] : 0, res[2 * h + i], &carry);
+ }
+ w[2 * m] = carry;
+ // w = z0 + z2 - (a1 - a0) * (b1 - b0)
+ if (p_neg) {
+  w[2 * m] += cells_add_n(w, p, 2 * m);
+ } else {
+  w[2 * m] -= cells_sub_n(w, p, 2 * m);
+ }
+ // res += w * b^h
+ carry = 0;
+ for (buint_size_t i = 0; i < 2 * m + 1; ++i) {
+  uint_add_assign(&res[h + i], w[i], &carry);
+ }
+ for (buint_size_t i = h + 2 * m + 1; carry && i < 2 * n; ++i) {
+  uint_add_assign(&res[i], 0, &carry);
+ }
+}
+
+/**
+ @brief Karatsuba multiplication of cell arrays (subtractive variant):
+ a*b = z2*b^(2h) + (z0 + z2 - (a1 - a0)*(b1 - b0))*b^h + z0, where z0 = a0*b0, z2 = a1*b1.
+ Below kcells cells, the basecase multiplication is used.
+ @param res Output: 2n cells of the product (must not overlap with the factors).
+ @param a First factor (n cells).
+ @param b Second factor (n cells).
+ @param n Number of cells of the factors.
+ @param t Scratch space of CELLS_KARATSUBA_SCRATCH(n) cells.
+ @param kcells Karatsuba cutoff (cells).
+*/
+static inline void cells_kara_mul(UInt *res, const UInt *a, const UInt *b, buint_size_t n, UInt *t, buint_size_t kcells) {
+ if (n < kcells || n < 2) {
+  cells_mul_base(res, a, n, b, n, 2 * n);
+  return;
+ }
+ const buint_size_t h = n / 2;
+ const buint_size_t m = n - h;
+ UInt *da = t;
+ UInt *db = t + m;
+ UInt *p = t + 2 * m;
+ UInt *w = t + 4 * m;
+ cells_kara_mul(res, a, b, h, t, kcells);
+ cells_kara_mul(res + 2 * h, a + h, b + h, m, t, kcells);
+ buint_bool p_neg = cells_abs_diff(da, a + h, m, a, h);
+ p_neg ^= cells_abs_diff(db, b + h, m, b, h);
+ cells_kara_mul(p, da, db, m, t + 6 * m + 1, kcells);
+ cells_kara_combine(res, n, w, p, p_neg);
+}
+
+/**
+ @brief Karatsuba squaring of a cell array, same as cells_kara_mul(res, a, a, n, t, kcells).
+ @param res Output: 2n cells of the square (must not overlap with a).
+ @param a Value to square (n cells).
+ @param n Number of cells.
+ @param t Scratch space of CELLS_KARATSUBA_SCRATCH(n) cells.
+ @param kcells Karatsuba cutoff (cells).
+*/
+static inline void cells_kara_sqr(UInt *res, const UInt *a, buint_size_t n, UInt *t, buint_size_t kcells) {
+ if (n < kcells || n < 2) {
+  cells_sqr_base(res, a, n, 2 * n);
+  return;
+ }
+ const buint_size_t h = n / 2;
+ const buint_size_t m = n - h;
+ UInt *da = t;
+ UInt *p = t + 2 * m;
+ UInt *w = t + 4 * m;
+ cells_kara_sqr(res, a, h, t, kcells);
+ cells_kara_sqr(res + 2 * h, a + h, m, t, kcells);
+ cells_abs_diff(da, a + h, m, a, h);
+ cells_kara_sqr(p, da, m, t + 6 * m + 1, kcells);
+ cells_kara_combine(res, n, w, p, 0);
+}
+
+/**
+ @brief Shift left of a cell array by less than UINT_BITS.
+ @param dest Output: n cells of the shifted value (may be the same as src).
+ @param src Value to shift (n cells).
+ @param n Number of cells.
+ @param shift Amount of shifting [0, UINT_BITS).
+ @return Bits shifted out of the highest cell.
+*/
+static inline UInt cells_shl_bits(UInt *dest, const UInt *src, buint_size_t n, buint_size_t shift) {
+ if (shift == 0) {
+  if (dest != src) memmove(dest, src, n * sizeof(UInt));
+  return 0;
+ }
+ UInt carry = 0;
+ for (buint_size_t i = 0; i < n; ++i) {
+  UInt x = src[i];
+  dest[i] = (x << shift) | carry;
+  carry = x >> (CELLS_UINT_BITS_ - shift);
+ }
+ return carry;
+}
+
+/**
+ @brief Shift right of a cell array by less than UINT_BITS.
+ @param dest Output: n cells of the shifted value (may be the same as src).
+ @param src Value to shift (n cells).
+ @param n Number of cells.
+ @param shift Amount of shifting [0, UINT_BITS).
+*/
+static inline void cells_shr_bits(UInt *dest, const UInt *src, buint_size_t n, buint_size_t shift) {
+ if (shift == 0) {
+  if (dest != src) memmove(dest, src, n * sizeof(UInt));
+  return;
+ }
+ UInt carry = 0;
+ for (buint_size_t i = n; 0 < i--;) {
+  UInt x = src[i];
+  dest[i] = (x >> shift) | carry;
+  carry = x << (CELLS_UINT_BITS_ - shift);
+ }
+}
+
+/**
+ @brief Subtracts the product of a cell array and a single cell from another cell array.
+ @param a Subject of operation (n + 1 cells).
+ @param b Cell array to multiply (n cells).
+ @param n Number of cells of b.
+ @param m Multiplier.
+ @return Borrow (the result is negative).
+*/
+static inline buint_bool cells_submul_1(UInt *a, const UInt *b, buint_size_t n, UInt m) {
+ UInt mcarry = 0;
+ buint_bool borrow = 0;
+ for (buint_size_t i = 0; i < n; ++i) {
+  UIntPair prod = uint_mul(m, b[i]);
+  buint_bool c = 0;
+  UInt plo = uint_add(prod.second, mcarry, &c);
+  mcarry = prod.first + c;
+  a[i] = uint_sub(a[i], plo, &borrow);
+ }
+ a[n] = uint_sub(a[n], mcarry, &borrow);
+ return borrow;
+}
+
+/**
+ @brief Adds the product of a cell array and a single cell to another cell array.
+ @param a Subject of operation (n cells).
+ @param b Cell array to multiply (n cells).
+ @param n Number of cells.
+ @param m Multiplier.
+ @return Carry cell (the bits above a[n - 1]).
+*/
+static inline UInt cells_addmul_1(UInt *a, const UInt *b, buint_size_t n, UInt m) {
+ UInt mcarry = 0;
+ for (buint_size_t i = 0; i < n; ++i) {
+  UIntPair prod = uint_mul(m, b[i]);
+  buint_bool c = 0;
+  UInt plo = uint_add(prod.second, mcarry, &c);
+  mcarry = prod.first + c;
+  c = 0;
+  a[i] = uint_add(a[i], plo, &c);
+  mcarry += c;
+ }
+ return mcarry;
+}
+
+/**
+ @brief Multiply-add of a cell array and single cells in place: a = a * m + c.
+ @param a Subject of operation (n cells).
+ @param n Number of cells.
+ @param m Multiplier.
+ @param c Addend.
+ @return Carry cell (the bits above a[n - 1]).
+*/
+static inline UInt cells_muladd_1(UInt *a, buint_size_t n, UInt m, UInt c) {
+ for (buint_size_t i = 0; i < n; ++i) {
+  UIntPair prod = uint_mul(m, a[i]);
+  buint_bool carry = 0;
+  a[i] = uint_add(prod.second, c, &carry);
+  c = prod.first + carry;
+ }
+ return c;
+}
+
+/**
+ @brief Long division of cell arrays (Knuth, TAOCP Vol. 2, Algorithm D).
+ Each quotient cell is estimated by dividing the two highest cells of the
+ current remainder by the highest cell of the divisor (using its precomputed
+ reciprocal, so no hardware division is performed), then the estimation is
+ corrected with the next cells (the estimation is at most 2 greater than the
+ quotient cell), and finally with an add-back step (rarely needed).
+ @param q Output: nu - nv + 1 cells of the quotient (NULL: the quotient is not stored).
+ @param u Normalized dividend of nu + 1 cells (u[nu] holds the bits shifted out at normalization).
+ Overwritten by the normalized remainder (lowest nv cells), the other cells are cleared.
+ @param nu Number of cells of the dividend (nv <= nu).
+ @param v Normalized divisor of nv cells: the most significant bit of v[nv - 1] is set.
+ @param nv Number of cells of the divisor (0 < nv).
+ @param vinv Reciprocal of the highest cell of the divisor (uint_reciprocal(v[nv - 1])).
+*/
+static inline void cells_div(UInt *q, UInt *u, buint_size_t nu, const UInt *v, buint_size_t nv, UInt vinv) {
+ const UInt vhi = v[nv - 1];
+ for (buint_size_t j = nu - nv + 1; 0 < j--;) {
+  UInt *uj = u + j;
+  UInt qhat;
+  UInt rhat;
+  buint_bool rhat_oflow;
+  if (uj[nv] == vhi) {
+   qhat = (UInt)-1;
+   rhat = uj[nv - 1] + vhi;
+   rhat_oflow = rhat < vhi;
+  } else {
+   UIntPair qr = uint_div_pre((UIntPair){uj[nv], uj[nv - 1]}, vhi, vinv);
+   qhat = qr.first;
+   rhat = qr.second;
+   rhat_oflow = 0;
+  }
+  // correction of the estimation
+  while (1 < nv && !rhat_oflow) {
+   UIntPair prod = uint_mul(qhat, v[nv - 2]);
+   if (prod.first < rhat || (prod.first == rhat && prod.second <= uj[nv - 2])) break;
+   --qhat;
+   rhat += vhi;
+   rhat_oflow = rhat < vhi;
+  }
+  // multiply and subtract
+  if (cells_submul_1(uj, v, nv, qhat)) { // the remainder became negative: add back
+   --qhat;
+   uj[nv] += cells_add_n(uj, v, nv);
+  }
+  if (q) q[j] = qhat;
+ }
+}
+
+/**
+ @brief Division of a cell array by a single normalized cell (with its precomputed reciprocal).
+ @param q Output: n cells of the quotient (NULL: the quotient is not stored).
+ @param u Normalized dividend of n + 1 cells, u[n] must be less than v.
+ @param n Number of cells of the quotient.
+ @param v Normalized divisor: its most significant bit is set.
+ @param vinv Reciprocal of the divisor (uint_reciprocal(v)).
+ @return Normalized remainder.
+*/
+static inline UInt cells_div_1(UInt *q, const UInt *u, buint_size_t n, UInt v, UInt vinv) {
+ UInt r = u[n];
+ for (buint_size_t i = n; 0 < i--;) {
+  UIntPair qr = uint_div_pre((UIntPair){r, u[i]}, v, vinv);
+  if (q) q[i] = qr.first;
+  r = qr.second;
+ }
+ return r;
+}
+
+/**
+ @brief Division of a cell array by a single cell, normalized on the fly
+ (each cell of the dividend is shifted left by a funnel shift right before its division step).
+ The pass goes downwards, each cell of a is read before q overwrites it, so q may be the same as a.
+ @param q Output: n cells of the quotient (NULL: the quotient is not stored).
+ @param a Dividend (n cells).
+ @param n Number of cells.
+ @param v Normalized divisor: b << shift, where b is the divisor.
+ @param vinv Reciprocal of the normalized divisor (uint_reciprocal(v)).
+ @param shift Normalization shift of the divisor [0, UINT_BITS).
+ @return Remainder.
+*/
+static inline UInt cells_div_1_shl(UInt *q, const UInt *a, buint_size_t n, UInt v, UInt vinv, buint_size_t shift) {
+ if (n == 0) return 0;
+ UInt r = (a[n - 1] >> 1) >> (CELLS_UINT_BITS_ - 1 - shift);
+ for (buint_size_t i = n; 0 < i--;) {
+  UInt lo = 0 < i ? a[i - 1] : 0;
+  UIntPair qr = uint_div_pre((UIntPair){r, (a[i] << shift) | ((lo >> 1) >> (CELLS_UINT_BITS_ - 1 - shift))}, v, vinv);
+  if (q) q[i] = qr.first;
+  r = qr.second;
+ }
+ return r >> shift;
+}
+
+/**
+ @brief Exact division of a cell array by a single odd cell (Jebelean's algorithm).
+ Each quotient cell is computed by multiplication with the 2-adic inverse of the divisor,
+ the high part of its product with the divisor is borrowed from the next cell.
+ @param q Output: n cells of the quotient (may be the same as a).
+ @param a Dividend of n cells, must be a multiple of b.
+ @param n Number of cells.
+ @param b Odd divisor.
+ @param binv 2-adic inverse of the divisor (uint_inverse(b)).
+*/
+static inline void cells_divexact_1(UInt *q, const UInt *a, buint_size_t n, UInt b, UInt binv) {
+ UInt borrow = 0;
+ for (buint_size_t i = 0; i < n; ++i) {
+  buint_bool c = 0;
+  UInt qi = uint_sub(a[i], borrow, &c) * binv;
+  q[i] = qi;
+  borrow = uint_mul(qi, b).first + c;
+ }
+}
+
+#endif
@@ -0,0 +1,203 @@
+/*****************************************************************************
+
+    Copyright 2020 SZIGETI János
+
+    This file is part of biguint library (Big Unsigned Integers).
+
+    Biguint is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Biguint is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+*****************************************************************************/
+#include "mul_kernel.h"
+#include "uint.h"
+#include <string.h>
+#ifdef MUL_KERNEL_HAVE_MULX_ADX
+#include <cpuid.h>
+#endif
+
+// Local definitions
+#define UINT_BITS (8u * sizeof(UInt))
+
+#define CPUID7_EBX_BMI2 (1u << 8)
+#define CPUID7_EBX_ADX (1u << 19)
+
+MulKernel mul_kernel_active = MUL_KERNEL_GENERIC;
+
+// Static function declarations
+static MulKernel detect_(void);
+static void init_(void);
+#ifdef MUL_KERNEL_HAVE_MULX_ADX
+static inline UInt addmul_1_(UInt *r, const UInt *b, buint_size_t n, UInt m);
+#endif
+
+// Implementations
+
+/**
+ * Selects the best kernel supported by the CPU.
+ * @return Kernel identifier (not MUL_KERNEL_AUTO).
+ */
+static MulKernel detect_(void) {
+#ifdef MUL_KERNEL_HAVE_MULX_ADX
+ unsigned int eax, ebx, ecx, edx;
+ if (__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx)
+     && (ebx & CPUID7_EBX_BMI2) && (ebx & CPUID7_EBX_ADX)) {
+  return MUL_KERNEL_MULX_ADX;
+ }
+#endif
+ return MUL_KERNEL_GENERIC;
+}
+
+/**
+ * Load-time kernel selection.
+ * Without constructor support, the generic kernel is used until mul_kernel_set() is called.
+ */
+#if defined(__GNUC__) || defined(__clang__)
+__attribute__((constructor))
+#endif
+static void init_(void) {
+ mul_kernel_active = detect_();
+}
+
+buint_bool mul_kernel_supported(MulKernel k) {
+ return k == MUL_KERNEL_AUTO || k == MUL_KERNEL_GENERIC || (k == MUL_KERNEL_MULX_ADX && detect_() == MUL_KERNEL_MULX_ADX);
+}
+
+buint_bool mul_kernel_set(MulKernel k) {
+ if (!mul_kernel_supported(k)) return 0;
+ mul_kernel_active = k == MUL_KERNEL_AUTO ? detect_() : k;
+ return 1;
+}
+
+const char *mul_kernel_name(MulKernel k) {
+ switch (k) {
+  case MUL_KERNEL_AUTO: return "auto";
+  case MUL_KERNEL_GENERIC: return "generic";
+  case MUL_KERNEL_MULX_ADX: return "mulx-adx";
+ }
+ return "unknown";
+}
+
+#ifdef MUL_KERNEL_HAVE_MULX_ADX
+/**
+ * Multiply-accumulate row: r[0..n) += b[0..n) * m.
+ * The low halves of the products are added by ADCX (carry flag),
+ * the high halves of the previous products by ADOX (overflow flag),
+ * thus the two carry chains do not wait for each other.
+ * The first n % 4 cells are processed one by one, the rest by a loop unrolled 4 times,
+ * alternating two registers for the high halves.
+ * The loop counters run from -n to 0 (LEA and JRCXZ do not modify the flags).
+ * @param r Accumulator (n cells).
+ * @param b Factor (n cells).
+ * @param n Number of cells (at least 1).
+ * @param m Single-cell factor.
+ * @return Carry cell (to be added to r[n]).
+ */
+static inline UInt addmul_1_(UInt *r, const UInt *b, buint_size_t n, UInt m) {
+ UInt hi = 0;
+ UInt lo, hn, t;
+ buint_size_t head = n % 4;
+ buint_size_t i = (buint_size_t)0 - head;
+ if (head != 0) {
+  __asm__ (
+   "xor %k[t], %k[t]\n\t"	// clears CF and OF
+   "1:\n\t"
+   "mulx (%[b],%[i],8), %[lo], %[hn]\n\t"
+   "mov (%[r],%[i],8), %[t]\n\t"
+   "adcx %[lo], %[t]\n\t"
+   "adox %[hi], %[t]\n\t"
+   "mov %[t], (%[r],%[i],8)\n\t"
+   "mov %[hn], %[hi]\n\t"
+   "lea 1(%[i]), %[i]\n\t"
+   "jrcxz 2f\n\t"
+   "jmp 1b\n"
+   "2:\n\t"
+   "mov $0, %k[t]\n\t"
+   "adcx %[t], %[hi]\n\t"
+   "adox %[t], %[hi]\n\t"
+   : [hi] "+&r" (hi), [lo] "=&r" (lo), [hn] "=&r" (hn), [t] "=&r" (t), [i] "+&c" (i)
+   : [r] "r" (r + head), [b] "r" (b + head), "d" (m)
+   : "cc", "memory");
+ }
+ i = (buint_size_t)0 - (n - head);
+ if (i != 0) {
+  __asm__ (
+   "xor %k[t], %k[t]\n\t"	// clears CF and OF
+   "1:\n\t"
+   "mulx (%[b],%[i],8), %[lo], %[hn]\n\t"
+   "mov (%[r],%[i],8), %[t]\n\t"
+   "adcx %[lo], %[t]\n\t"
+   "adox %[hi], %[t]\n\t"
+   "mov %[t], (%[r],%[i],8)\n\t"
+   "mulx 8(%[b],%[i],8), %[lo], %[hi]\n\t"
+   "mov 8(%[r],%[i],8), %[t]\n\t"
+   "adcx %[lo], %[t]\n\t"
+   "adox %[hn], %[t]\n\t"
+   "mov %[t], 8(%[r],%[i],8)\n\t"
+   "mulx 16(%[b],%[i],8), %[lo], %[hn]\n\t"
+   "mov 16(%[r],%[i],8), %[t]\n\t"
+   "adcx %[lo], %[t]\n\t"
+   "adox %[hi], %[t]\n\t"
+   "mov %[t], 16(%[r],%[i],8)\n\t"
+   "mulx 24(%[b],%[i],8), %[lo], %[hi]\n\t"
+   "mov 24(%[r],%[i],8), %[t]\n\t"
+   "adcx %[lo], %[t]\n\t"
+   "adox %[hn], %[t]\n\t"
+   "mov %[t], 24(%[r],%[i],8)\n\t"
+   "lea 4(%[i]), %[i]\n\t"
+   "jrcxz 2f\n\t"
+   "jmp 1b\n"
+   "2:\n\t"
+   "mov $0, %k[t]\n\t"
+   "adcx %[t], %[hi]\n\t"
+   "adox %[t], %[hi]\n\t"
+   : [hi] "+&r" (hi), [lo] "=&r" (lo), [hn] "=&r" (hn), [t] "=&r" (t), [i] "+&c" (i)
+   : [r] "r" (r + n), [b] "r" (b + n), "d" (m)
+   : "cc", "memory");
+ }
+ return hi;
+}
+
+void mul_kernel_mulx_mul(UInt *res, const UInt *a, buint_size_t na, const UInt *b, buint_size_t nb, buint_size_t ncols) {
+ memset(res, 0, ncols * sizeof(UInt));
+ if (nb == 0) return;
+ for (buint_size_t i = 0; i < na && i < ncols; ++i) {
+  buint_size_t n = nb < ncols - i ? nb : ncols - i;
+  UInt c = addmul_1_(res + i, b, n, a[i]);
+  if (i + n < ncols) res[i + n] = c;
+ }
+}
+
+void mul_kernel_mulx_sqr(UInt *res, const UInt *a, buint_size_t na, buint_size_t ncols) {
+ memset(res, 0, ncols * sizeof(UInt));
+ // off-diagonal products a[i]*a[j] (i < j)
+ for (buint_size_t i = 0; i + 1 < na && 2 * i + 1 < ncols; ++i) {
+  buint_size_t n = na - i - 1 < ncols - 2 * i - 1 ? na - i - 1 : ncols - 2 * i - 1;
+  UInt c = addmul_1_(res + 2 * i + 1, a + i + 1, n, a[i]);
+  if (2 * i + 1 + n < ncols) res[2 * i + 1 + n] = c;
+ }
+ // doubling, and adding the diagonal products a[i]*a[i]
+ UInt top = 0;
+ buint_bool carry = 0;
+ for (buint_size_t i = 0; 2 * i < ncols; ++i) {
+  UIntPair sq = i < na ? uint_mul(a[i], a[i]) : (UIntPair){0, 0};
+  UInt x = res[2 * i];
+  res[2 * i] = uint_add((x << 1) | top, sq.second, &carry);
+  top = x >> (UINT_BITS - 1);
+  if (2 * i + 1 < ncols) {
+   x = res[2 * i + 1];
+   res[2 * i + 1] = uint_add((x << 1) | top, sq.first, &carry);
+   top = x >> (UINT_BITS - 1);
+  }
+ }
+}
+#endif
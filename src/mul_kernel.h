@@ -0,0 +1,103 @@
+/*****************************************************************************
+
+    Copyright 2020 SZIGETI János
+
+    This file is part of biguint library (Big Unsigned Integers).
+
+    Biguint is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Biguint is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+*****************************************************************************/
+#ifndef _MUL_KERNEL_H_
+#define _MUL_KERNEL_H_
+
+#include "uint_types.h"
+
+/**
+ Platform-specific multiplication kernels.
+
+ The basecase (quadratic) multiplication and squaring of cell arrays is done either
+ by the generic C code of the BigUInt types, or by a kernel tuned for the CPU.
+ The kernel is selected at load time by means of cpuid; it can be overridden by mul_kernel_set()
+ (e.g., to compare or test the kernels on the same machine).
+*/
+
+/**
+ Identifiers of the multiplication kernels.
+*/
+typedef enum {
+ MUL_KERNEL_AUTO = 0,	///< Best kernel supported by the CPU (as selected at load time).
+ MUL_KERNEL_GENERIC = 1,	///< Portable C code.
+ MUL_KERNEL_MULX_ADX = 2	///< x86-64 MULX (BMI2) with two carry chains by ADCX / ADOX (ADX), 64 bit cells only.
+} MulKernel;
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__)) && defined(USE_STD_TYPES) && defined(USE_UINT64_T)
+#define MUL_KERNEL_HAVE_MULX_ADX 1
+#endif
+
+/**
+ Truncated products (e.g., mul, sqr) shorter than this many cells are calculated by the generic code
+ even if the MULX / ADX kernel is active: the kernel works row by row, and short rows do not pay off.
+*/
+#ifndef MUL_KERNEL_MULX_TRUNC_CELLS
+#define MUL_KERNEL_MULX_TRUNC_CELLS 16u
+#endif
+
+/**
+ Currently active kernel (never MUL_KERNEL_AUTO), read by the multiplication functions.
+*/
+extern MulKernel mul_kernel_active;
+
+/**
+ @brief Checks whether a kernel can be used on this CPU with this UInt width.
+ @param k Kernel identifier.
+ @return k can be selected by mul_kernel_set().
+*/
+buint_bool mul_kernel_supported(MulKernel k);
+
+/**
+ @brief Selects the multiplication kernel.
+ Not thread-safe: call it before starting threads that multiply.
+ @param k Kernel identifier; MUL_KERNEL_AUTO restores the choice made at load time.
+ @return The kernel is supported and has been selected (otherwise the active kernel is unchanged).
+*/
+buint_bool mul_kernel_set(MulKernel k);
+
+/**
+ @brief Human-readable name of a kernel.
+*/
+const char *mul_kernel_name(MulKernel k);
+
+#ifdef MUL_KERNEL_HAVE_MULX_ADX
+/**
+ @brief Basecase multiplication by MULX / ADCX / ADOX.
+ @param res Output: ncols cells of the product (must not overlap with the factors).
+ @param a First factor.
+ @param na Number of significant cells of a.
+ @param b Second factor.
+ @param nb Number of significant cells of b.
+ @param ncols Number of calculated product cells (higher cells are truncated).
+*/
+void mul_kernel_mulx_mul(UInt *res, const UInt *a, buint_size_t na, const UInt *b, buint_size_t nb, buint_size_t ncols);
+
+/**
+ @brief Basecase squaring by MULX / ADCX / ADOX.
+ @param res Output: ncols cells of the square (must not overlap with a).
+ @param a Value to square.
+ @param na Number of significant cells of a.
+ @param ncols Number of calculated cells (higher cells are truncated).
+*/
+void mul_kernel_mulx_sqr(UInt *res, const UInt *a, buint_size_t na, buint_size_t ncols);
+#endif
+
+#endif
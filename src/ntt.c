@@ -0,0 +1,321 @@
+/*****************************************************************************
+
+    Copyright 2020 SZIGETI János
+
+    This file is part of biguint library (Big Unsigned Integers).
+
+    Biguint is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Biguint is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+*****************************************************************************/
+#include "ntt.h"
+#include <string.h>
+
+// Local definitions
+#define FORRANGE(i, LO, HI) for (buint_size_t i=(LO); i<(HI); ++i)
+
+#define UINT_BITS (8u * sizeof(UInt))
+#define DIGIT_BITS 32u
+#define DIGITS_PER_CELL ((UINT_BITS + DIGIT_BITS - 1u) / DIGIT_BITS)
+#define CELLS_PER_DIGIT ((DIGIT_BITS + UINT_BITS - 1u) / UINT_BITS)
+#define PRIMES 3u
+
+// Moduli of the transforms: c * 2^k + 1, with primitive root 3.
+#define PRIME0 998244353u	// 119 * 2^23 + 1
+#define PRIME1 167772161u	// 5 * 2^25 + 1
+#define PRIME2 469762049u	// 7 * 2^26 + 1
+#define PRIMITIVE_ROOT 3u
+
+/**
+ * Constants of the arithmetic modulo one prime.
+ * Values in Montgomery form are multiplied by R = 2^32.
+ */
+typedef struct {
+ uint32_t p;	///< The modulus.
+ uint32_t pinv;	///< -p^(-1) mod R.
+ uint32_t one;	///< R mod p, that is, 1 in Montgomery form.
+} NttPrime;
+
+// Static function declarations
+static inline uint32_t mont_mul_(uint32_t a, uint32_t b, uint32_t p, uint32_t pinv);
+static inline uint32_t reduce_(uint32_t a, uint32_t p2);
+static uint32_t pow_mod_(uint32_t a, uint32_t e, uint32_t p);
+static NttPrime prime_ctor_(uint32_t p);
+static void load_digits_(uint32_t *dst, buint_size_t len, const UInt *a, buint_size_t na);
+static void twiddles_(uint32_t *w, buint_size_t len, const NttPrime *m);
+static void ntt_fwd_(uint32_t *x, buint_size_t len, const uint32_t *w, const NttPrime *m);
+static void ntt_inv_(uint32_t *x, buint_size_t len, const uint32_t *w, const NttPrime *m);
+static void convolve_(uint32_t *fa, uint32_t *fb, buint_size_t len, buint_bool sqr, uint32_t *w, const NttPrime *m);
+static inline void put_digit_(UInt *res, buint_size_t n, buint_size_t i, uint32_t d);
+
+// Implementations
+
+/**
+ * Montgomery multiplication without the final correction.
+ * @param a First factor (less than 4p).
+ * @param b Second factor (less than p, or both factors less than 2p).
+ * @param p The modulus (less than 2^30).
+ * @param pinv -p^(-1) mod R.
+ * @return a * b / R mod p, less than 2p.
+ */
+static inline uint32_t mont_mul_(uint32_t a, uint32_t b, uint32_t p, uint32_t pinv) {
+ uint64_t t = (uint64_t)a * b;
+ uint32_t q = (uint32_t)t * pinv;
+ return (uint32_t)((t + (uint64_t)q * p) >> 32);
+}
+
+/**
+ * Partial reduction.
+ * @param a Value less than 2 * p2.
+ * @param p2 Twice the modulus.
+ * @return a mod p, less than p2.
+ */
+static inline uint32_t reduce_(uint32_t a, uint32_t p2) {
+ return a < p2 ? a : a - p2;
+}
+
+/**
+ * Modular exponentiation (square and multiply), used for the setup only.
+ * @return a^e mod p.
+ */
+static uint32_t pow_mod_(uint32_t a, uint32_t e, uint32_t p) {
+ uint64_t r = 1;
+ uint64_t s = a % p;
+ for (; e; e >>= 1) {
+  if (e & 1u) r = r * s % p;
+  s = s * s % p;
+ }
+ return (uint32_t)r;
+}
+
+/**
+ * Calculates the constants of the Montgomery arithmetic.
+ * @param p An odd prime below 2^30.
+ * @return Prime constants.
+ */
+static NttPrime prime_ctor_(uint32_t p) {
+ uint32_t x = p;	// p * p == 1 (mod 8)
+ FORRANGE(i, 0, 4) {
+  x *= 2u - p * x;	// doubles the number of correct bits
+ }
+ return (NttPrime){p, (uint32_t)0 - x, (uint32_t)(((uint64_t)1 << 32) % p)};
+}
+
+/**
+ * Splits a cell array into 32-bit digits, padded with zeros.
+ * @param dst Output: len digits.
+ * @param len Number of digits to write.
+ * @param a Cell array.
+ * @param na Number of cells of a.
+ */
+static void load_digits_(uint32_t *dst, buint_size_t len, const UInt *a, buint_size_t na) {
+ memset(dst, 0, len * sizeof(uint32_t));
+ if (DIGIT_BITS <= UINT_BITS) {
+  FORRANGE(i, 0, na) {
+   UInt c = a[i];
+   FORRANGE(j, 0, DIGITS_PER_CELL) {
+    dst[i * DIGITS_PER_CELL + j] = (uint32_t)c;
+    c = DIGITS_PER_CELL == 1 ? 0 : c >> (DIGIT_BITS % UINT_BITS);
+   }
+  }
+ } else {
+  FORRANGE(i, 0, na) {
+   dst[i / CELLS_PER_DIGIT] |= (uint32_t)a[i] << (i % CELLS_PER_DIGIT * UINT_BITS);
+  }
+ }
+}
+
+/**
+ * Stores one digit of the product.
+ * @param res Cell array, cleared in advance.
+ * @param n Number of cells of res.
+ * @param i Index of the digit.
+ * @param d Value of the digit.
+ */
+static inline void put_digit_(UInt *res, buint_size_t n, buint_size_t i, uint32_t d) {
+ if (DIGIT_BITS <= UINT_BITS) {
+  if (i / DIGITS_PER_CELL < n) res[i / DIGITS_PER_CELL] |= (UInt)d << (i % DIGITS_PER_CELL * DIGIT_BITS % UINT_BITS);
+ } else {
+  FORRANGE(j, 0, CELLS_PER_DIGIT) {
+   if (i * CELLS_PER_DIGIT + j < n) res[i * CELLS_PER_DIGIT + j] = (UInt)(d >> (j * UINT_BITS % DIGIT_BITS));
+  }
+ }
+}
+
+/**
+ * Twiddle factors of all stages of the transforms, in Montgomery form.
+ * The factors of the stage with butterflies of size 2 * half are w[half + j] = root^j (0 <= j < half),
+ * where root is a primitive (2 * half)-th root of unity.
+ * @param w Output: len values (w[0] is not used).
+ * @param len Length of the transform (power of 2, at least 2).
+ * @param m Prime constants.
+ */
+static void twiddles_(uint32_t *w, buint_size_t len, const NttPrime *m) {
+ const uint32_t p = m->p;
+ const uint32_t pinv = m->pinv;
+ uint32_t root = pow_mod_(PRIMITIVE_ROOT, (p - 1u) / len, p);
+ uint32_t step = (uint32_t)(((uint64_t)root << 32) % p);
+ const buint_size_t half = len / 2;
+ w[half] = m->one;
+ FORRANGE(j, 1, half) {
+  uint32_t x = mont_mul_(w[half + j - 1], step, p, pinv);
+  w[half + j] = x < p ? x : x - p;
+ }
+ // the root of a stage is the square of the root of the next stage
+ for (buint_size_t h = half / 2; 0 < h; h /= 2) {
+  FORRANGE(j, 0, h) {
+   w[h + j] = w[2 * h + 2 * j];
+  }
+ }
+}
+
+/**
+ * Forward transform (decimation in frequency), the output is in bit-reversed order.
+ * The values are kept below 2p (lazy reduction).
+ * @param x Values to transform in place (len values less than 2p).
+ * @param len Length of the transform (power of 2).
+ * @param w Twiddle factors (see twiddles_).
+ * @param m Prime constants.
+ */
+static void ntt_fwd_(uint32_t *x, buint_size_t len, const uint32_t *w, const NttPrime *m) {
+ const uint32_t p = m->p;
+ const uint32_t p2 = 2u * p;
+ const uint32_t pinv = m->pinv;
+ for (buint_size_t half = len / 2; 0 < half; half /= 2) {
+  const uint32_t *wh = w + half;
+  for (buint_size_t i = 0; i < len; i += 2 * half) {
+   uint32_t *x0 = x + i;
+   uint32_t *x1 = x0 + half;
+   FORRANGE(j, 0, half) {
+    uint32_t u = x0[j];
+    uint32_t v = x1[j];
+    x0[j] = reduce_(u + v, p2);
+    x1[j] = mont_mul_(u + p2 - v, wh[j], p, pinv);
+   }
+  }
+ }
+}
+
+/**
+ * Inverse transform without scaling (decimation in time), the input is in bit-reversed order.
+ * The inverse roots of unity are taken from the same table: root^(-j) = -root^(half - j).
+ * The values are kept below 2p (lazy reduction).
+ * @param x Values to transform in place (len values less than 2p).
+ * @param len Length of the transform (power of 2).
+ * @param w Twiddle factors (see twiddles_).
+ * @param m Prime constants.
+ */
+static void ntt_inv_(uint32_t *x, buint_size_t len, const uint32_t *w, const NttPrime *m) {
+ const uint32_t p = m->p;
+ const uint32_t p2 = 2u * p;
+ const uint32_t pinv = m->pinv;
+ for (buint_size_t half = 1; half < len; half *= 2) {
+  const uint32_t *wh = w + 2 * half;	// wh[-j] = root^(half - j)
+  for (buint_size_t i = 0; i < len; i += 2 * half) {
+   uint32_t *x0 = x + i;
+   uint32_t *x1 = x0 + half;
+   uint32_t u = x0[0];
+   uint32_t v = x1[0];
+   x0[0] = reduce_(u + v, p2);
+   x1[0] = reduce_(u + p2 - v, p2);
+   FORRANGE(j, 1, half) {
+    u = x0[j];
+    v = mont_mul_(x1[j], *(wh - j), p, pinv);	// -(x1[j] * root^(-j))
+    x0[j] = reduce_(u + p2 - v, p2);
+    x1[j] = reduce_(u + v, p2);
+   }
+  }
+ }
+}
+
+/**
+ * Cyclic convolution modulo one prime.
+ * @param fa First sequence (len digits), overwritten by the result (less than p).
+ * @param fb Second sequence (len digits), overwritten (not used if sqr is set).
+ * @param len Length of the transform (power of 2).
+ * @param sqr The second sequence is the same as the first one.
+ * @param w Scratch space for the twiddle factors (len words).
+ * @param m Prime constants.
+ */
+static void convolve_(uint32_t *fa, uint32_t *fb, buint_size_t len, buint_bool sqr, uint32_t *w, const NttPrime *m) {
+ const uint32_t p = m->p;
+ const uint32_t pinv = m->pinv;
+ FORRANGE(i, 0, len) {
+  fa[i] %= p;
+ }
+ twiddles_(w, len, m);
+ ntt_fwd_(fa, len, w, m);
+ if (sqr) {
+  fb = fa;
+ } else {
+  FORRANGE(i, 0, len) {
+   fb[i] %= p;
+  }
+  ntt_fwd_(fb, len, w, m);
+ }
+ // The pointwise products are divided by R, and the inverse transform is multiplied by len:
+ // both are compensated at the end by the factor R^2 / len.
+ FORRANGE(i, 0, len) {
+  fa[i] = mont_mul_(fa[i], fb[i], p, pinv);
+ }
+ ntt_inv_(fa, len, w, m);
+ uint64_t r2 = (uint64_t)m->one * m->one % p;
+ uint32_t scale = (uint32_t)(r2 * pow_mod_((uint32_t)len, p - 2u, p) % p);
+ FORRANGE(i, 0, len) {
+  uint32_t x = mont_mul_(fa[i], scale, p, pinv);
+  fa[i] = x < p ? x : x - p;
+ }
+}
+
+void ntt_mul(UInt *res, const UInt *a, buint_size_t na, const UInt *b, buint_size_t nb, uint32_t *scratch) {
+ const buint_size_t da = (na * UINT_BITS + DIGIT_BITS - 1u) / DIGIT_BITS;
+ const buint_size_t db = (nb * UINT_BITS + DIGIT_BITS - 1u) / DIGIT_BITS;
+ const buint_bool sqr = a == b && na == nb;
+ buint_size_t len = 1;
+ while (len < da + db) len *= 2;
+ uint32_t *conv[PRIMES] = {scratch, scratch + len, scratch + 2 * len};
+ uint32_t *fb = scratch + 3 * len;
+ uint32_t *w = scratch + 4 * len;
+ const uint32_t primes[PRIMES] = {PRIME0, PRIME1, PRIME2};
+ FORRANGE(k, 0, PRIMES) {
+  NttPrime m = prime_ctor_(primes[k]);
+  load_digits_(conv[k], len, a, na);
+  if (!sqr) load_digits_(fb, len, b, nb);
+  convolve_(conv[k], fb, len, sqr, w, &m);
+ }
+
+ // Garner's algorithm: x = v0 + v1 * p0 + v2 * p0 * p1, then carry propagation.
+ const uint32_t inv01 = pow_mod_(PRIME0 % PRIME1, PRIME1 - 2u, PRIME1);
+ const uint32_t inv012 = pow_mod_((uint32_t)((uint64_t)PRIME0 * PRIME1 % PRIME2), PRIME2 - 2u, PRIME2);
+ const uint64_t p01 = (uint64_t)PRIME0 * PRIME1;
+ uint64_t acc_lo = 0;	// bits 0..63 of the pending carry
+ uint64_t acc_hi = 0;	// bits 64..127 of the pending carry
+ memset(res, 0, (na + nb) * sizeof(UInt));
+ FORRANGE(i, 0, da + db) {
+  uint32_t v0 = conv[0][i];
+  uint32_t v1 = (uint32_t)((conv[1][i] + (uint64_t)PRIME1 - v0 % PRIME1) * inv01 % PRIME1);
+  uint64_t low = v0 + (uint64_t)v1 * PRIME0;	// less than p0 * p1
+  uint32_t v2 = (uint32_t)((conv[2][i] + PRIME2 - low % PRIME2) * inv012 % PRIME2);
+  uint64_t mid_lo = (uint64_t)v2 * (uint32_t)p01;	// v2 * p0 * p1 = mid_hi * 2^32 + mid_lo
+  uint64_t mid_hi = (uint64_t)v2 * (uint32_t)(p01 >> 32);
+  acc_lo += low;
+  acc_hi += acc_lo < low;
+  acc_lo += mid_lo;
+  acc_hi += acc_lo < mid_lo;
+  acc_lo += mid_hi << 32;
+  acc_hi += (acc_lo < mid_hi << 32) + (mid_hi >> 32);
+  put_digit_(res, na + nb, i, (uint32_t)acc_lo);
+  acc_lo = acc_lo >> 32 | acc_hi << 32;
+  acc_hi >>= 32;
+ }
+}
@@ -0,0 +1,66 @@
+/*****************************************************************************
+
+    Copyright 2020 SZIGETI János
+
+    This file is part of biguint library (Big Unsigned Integers).
+
+    Biguint is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Biguint is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+*****************************************************************************/
+#ifndef _NTT_H_
+#define _NTT_H_
+
+#include <stdint.h>
+#include "uint_types.h"
+
+/**
+ Multiplication of long cell arrays by number-theoretic transforms.
+
+ The factors are split into 32-bit digits, which are convolved modulo three
+ primes below 2^30 (each of them is c * 2^k + 1 with k >= 23),
+ and the digits of the product are recovered by the Chinese remainder theorem.
+ The factors may have up to 2^22 digits (2^27 bits) each.
+*/
+
+// Smallest power of 2 not less than x (for 0 < x < 2^32, integer constant expression).
+#define NTT_POW2_1_(x) ((x) | (x) >> 1)
+#define NTT_POW2_2_(x) (NTT_POW2_1_(x) | NTT_POW2_1_(x) >> 2)
+#define NTT_POW2_4_(x) (NTT_POW2_2_(x) | NTT_POW2_2_(x) >> 4)
+#define NTT_POW2_8_(x) (NTT_POW2_4_(x) | NTT_POW2_4_(x) >> 8)
+#define NTT_POW2_16_(x) (NTT_POW2_8_(x) | NTT_POW2_8_(x) >> 16)
+#define NTT_POW2CEIL(x) (NTT_POW2_16_((x) - 1u) + 1u)
+
+/**
+ @brief Length of the transforms used for factors of at most nbytes bytes each.
+*/
+#define NTT_LEN(nbytes) NTT_POW2CEIL(2u * (((nbytes) + 3u) / 4u))
+
+/**
+ @brief Number of words of scratch space required by ntt_mul() for factors of at most nbytes bytes each.
+*/
+#define NTT_SCRATCH_WORDS(nbytes) (5u * NTT_LEN(nbytes))
+
+/**
+ @brief Multiplication of cell arrays.
+ Squaring is detected (a == b and na == nb) and saves one third of the transforms.
+ @param res Output: na + nb cells of the product (must not overlap with the factors).
+ @param a First factor.
+ @param na Number of cells of a (at least 1).
+ @param b Second factor.
+ @param nb Number of cells of b (at least 1).
+ @param scratch At least NTT_SCRATCH_WORDS(max(na, nb) * sizeof(UInt)) words of scratch space.
+*/
+void ntt_mul(UInt *res, const UInt *a, buint_size_t na, const UInt *b, buint_size_t nb, uint32_t *scratch);
+
+#endif
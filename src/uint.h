@@ -35,6 +35,81 @@ typedef struct {
  UInt second;
 } UIntPair;
 
+/*
+ Carry propagation layer.
+ The portable implementation derives the carry bit from comparisons.
+ If USE_CARRY_BUILTINS is defined (see configure --disable-carry-builtins),
+ the add-with-carry intrinsics or the overflow builtins of the compiler are used instead,
+ so that chains of uint_add() / uint_sub() calls compile to adc / sbb instruction sequences.
+*/
+#if defined(USE_CARRY_BUILTINS) && defined(USE_STD_TYPES) && defined(USE_UINT64_T) && defined(HAVE_ADDCARRY_U64)
+  #include <x86intrin.h>
+  #define UINT_ADDCARRY_(c, a, b, r) _addcarry_u64((c), (a), (b), (r))
+  #define UINT_SUBBORROW_(c, a, b, r) _subborrow_u64((c), (a), (b), (r))
+  typedef unsigned long long UIntCarryRes_;
+  #define UINT_CARRY_LAYER "_addcarry_u64 intrinsics"
+#elif defined(USE_CARRY_BUILTINS) && !(defined(USE_STD_TYPES) && defined(USE_UINT64_T)) && defined(HAVE_ADDCARRY_U32)
+  #include <x86intrin.h>
+  #define UINT_ADDCARRY_(c, a, b, r) _addcarry_u32((c), (a), (b), (r))
+  #define UINT_SUBBORROW_(c, a, b, r) _subborrow_u32((c), (a), (b), (r))
+  typedef unsigned int UIntCarryRes_;
+  #define UINT_CARRY_LAYER "_addcarry_u32 intrinsics"
+#elif defined(USE_CARRY_BUILTINS) && defined(HAVE_BUILTIN_ADD_OVERFLOW)
+  #define UINT_OVERFLOW_BUILTINS_ 1
+  #define UINT_CARRY_LAYER "overflow builtins"
+#else
+  #define UINT_CARRY_LAYER "portable"
+#endif
+
+#if defined(UINT_ADDCARRY_)
+static inline UInt uint_add(UInt a, UInt b, buint_bool *carry) {
+ UIntCarryRes_ c;
+ *carry = UINT_ADDCARRY_(!!*carry, a, b, &c);
+ return c;
+}
+
+static inline UInt *uint_add_assign(UInt *a, UInt b, buint_bool *carry) {
+ *a = uint_add(*a, b, carry);
+ return a;
+}
+
+static inline UInt uint_sub(UInt a, UInt b, buint_bool *carry) {
+ UIntCarryRes_ c;
+ *carry = UINT_SUBBORROW_(!!*carry, a, b, &c);
+ return c;
+}
+
+static inline UInt *uint_sub_assign(UInt *a, UInt b, buint_bool *carry) {
+ *a = uint_sub(*a, b, carry);
+ return a;
+}
+#elif defined(UINT_OVERFLOW_BUILTINS_)
+static inline UInt uint_add(UInt a, UInt b, buint_bool *carry) {
+ UInt c;
+ buint_bool c1 = __builtin_add_overflow(a, b, &c);
+ buint_bool c2 = __builtin_add_overflow(c, (UInt)!!*carry, &c);
+ *carry = c1 | c2;
+ return c;
+}
+
+static inline UInt *uint_add_assign(UInt *a, UInt b, buint_bool *carry) {
+ *a = uint_add(*a, b, carry);
+ return a;
+}
+
+static inline UInt uint_sub(UInt a, UInt b, buint_bool *carry) {
+ UInt c;
+ buint_bool c1 = __builtin_sub_overflow(a, b, &c);
+ buint_bool c2 = __builtin_sub_overflow(c, (UInt)!!*carry, &c);
+ *carry = c1 | c2;
+ return c;
+}
+
+static inline UInt *uint_sub_assign(UInt *a, UInt b, buint_bool *carry) {
+ *a = uint_sub(*a, b, carry);
+ return a;
+}
+#else
 /**
  @brief Addition of two UInt values with carry bit.
  @param carry Input carry bit read from, output carry bit written to.
@@ -77,6 +152,7 @@ static inline UInt *uint_sub_assign(UInt *a, UInt b, buint_bool *carry) {
  *carry = (*carry ? orig <= *a : orig < *a);
  return a;
 }
+#endif
 
 /**
  @brief Splits a value by means of bit masking into two.
@@ -104,13 +180,233 @@ static inline UIntPair uint_split_shift(UInt a, buint_size_t lsb) {
 
 /**
  @brief Multiplication of two values.
+ If double-width type wUInt is available, the product is calculated directly
+ (on most platforms, this is a single instruction).
+ Otherwise, the factors are split into half-width parts.
  @return first: high bits; second: low bits.
 */
-UIntPair uint_mul(UInt a, UInt b);
+static inline UIntPair uint_mul(UInt a, UInt b) {
+#ifdef HAVE_DUINT
+ wUInt prod = (wUInt)a * b;
+ return (UIntPair){(UInt)(prod >> UINT_BITS), (UInt)prod};
+#else
+ UIntPair retv;
+ buint_size_t uint_mbits = UINT_BITS / 2;
+
+ // split
+ UIntPair ap = uint_split(a, uint_mbits);
+ ap.first>>=uint_mbits;
+ UIntPair bp = uint_split(b, uint_mbits);
+ bp.first>>=uint_mbits;
+
+ // calculating the products
+ retv.first = ap.first * bp.first;
+ retv.second = ap.second * bp.second;
+
+ UInt c = ap.first * bp.second;
+ UInt d = ap.second * bp.first;
+ UIntPair cp = uint_split(c, uint_mbits);
+ cp.first>>=uint_mbits;
+ cp.second<<=uint_mbits;
+ UIntPair dp = uint_split(d, uint_mbits);
+ dp.first>>=uint_mbits;
+ dp.second<<=uint_mbits;
+
+ // summing
+ // Note: retv.first will not overflow,
+ // thus no need to check the carry bit.
+ UInt retv_lo0 = retv.second + cp.second;
+ if (retv_lo0 < retv.second) {
+  ++retv.first;
+ }
+ retv.second = retv_lo0 + dp.second;
+ if (retv.second < retv_lo0) {
+  ++retv.first;
+ }
+ retv.first+=cp.first;
+ retv.first+=dp.first;
+ return retv;
+#endif
+}
+
+/**
+ @brief Division of a double-width value by a single UInt value.
+ Preconditions: the most significant bit of b is set (b is normalized),
+ and a.first is less than b (the quotient fits into UInt).
+ @param a Dividend (first: high bits, second: low bits).
+ @param b Divisor.
+ @return first: quotient; second: remainder.
+*/
+static inline UIntPair uint_div(UIntPair a, UInt b) {
+#ifdef HAVE_DUINT
+ wUInt divident = ((wUInt)a.first << UINT_BITS) | a.second;
+ return (UIntPair){(UInt)(divident / b), (UInt)(divident % b)};
+#else
+ // Long division with half-width digits (Knuth, TAOCP Vol. 2, Algorithm D).
+ const buint_size_t hbits = UINT_BITS / 2;
+ const UInt hbase = (UInt)1 << hbits;
+ const UInt hmask = hbase - 1;
+ UInt b1 = b >> hbits;
+ UInt b0 = b & hmask;
+ UInt a1 = a.second >> hbits;
+ UInt a0 = a.second & hmask;
+
+ UInt q1 = a.first / b1;
+ UInt rhat = a.first - q1 * b1;
+ while (hbase <= q1 || hbase * rhat + a1 < q1 * b0) {
+  --q1;
+  rhat += b1;
+  if (hbase <= rhat) break;
+ }
+ UInt a21 = a.first * hbase + a1 - q1 * b;
+
+ UInt q0 = a21 / b1;
+ rhat = a21 - q0 * b1;
+ while (hbase <= q0 || hbase * rhat + a0 < q0 * b0) {
+  --q0;
+  rhat += b1;
+  if (hbase <= rhat) break;
+ }
+ return (UIntPair){q1 * hbase + q0, a21 * hbase + a0 - q0 * b};
+#endif
+}
+
+/**
+ @brief Reciprocal of a normalized UInt value (Moller, Granlund: Improved division by invariant integers).
+ The reciprocal is floor((B^2 - 1) / b) - B, where B = 2^UINT_BITS.
+ @param b Divisor, the most significant bit of b must be set.
+ @return Reciprocal of b.
+*/
+static inline UInt uint_reciprocal(UInt b) {
+ return uint_div((UIntPair){~b, (UInt)-1}, b).first;
+}
+
+/**
+ @brief Division of a double-width value by a single UInt value with precomputed reciprocal.
+ Same as uint_div(), but only multiplications are performed.
+ Preconditions: the most significant bit of b is set (b is normalized),
+ and a.first is less than b (the quotient fits into UInt).
+ @param a Dividend (first: high bits, second: low bits).
+ @param b Divisor.
+ @param v Reciprocal of b (see uint_reciprocal()).
+ @return first: quotient; second: remainder.
+*/
+static inline UIntPair uint_div_pre(UIntPair a, UInt b, UInt v) {
+ UIntPair q = uint_mul(v, a.first);
+ buint_bool carry = 0;
+ q.second = uint_add(q.second, a.second, &carry);
+ q.first = uint_add(q.first, a.first, &carry) + 1;
+ UInt r = a.second - q.first * b;
+ if (q.second < r) {
+  --q.first;
+  r += b;
+ }
+ if (b <= r) {
+  ++q.first;
+  r -= b;
+ }
+ return (UIntPair){q.first, r};
+}
+
+/**
+ @brief Multiplicative inverse of an odd value modulo 2^UINT_BITS (2-adic inverse).
+ Newton iteration: each step doubles the number of correct low bits.
+ @param a Odd value.
+ @return x so that a * x == 1 (mod 2^UINT_BITS).
+*/
+static inline UInt uint_inverse(UInt a) {
+ UInt x = a; // a * a == 1 (mod 8), i.e., 3 bits are correct
+ for (buint_size_t bits = 3; bits < UINT_BITS; bits *= 2) {
+  x *= 2 - a * x;
+ }
+ return x;
+}
+
+/*
+ Bit scanning.
+ If HAVE_BUILTIN_CLZ is defined (see configure), the count leading / trailing zeros
+ and population count builtins of the compiler are used (e.g., lzcnt / bsr, tzcnt / bsf, popcnt on x86).
+ Otherwise, the portable implementations do a binary search, resp. parallel bit counting.
+*/
+#ifdef HAVE_BUILTIN_CLZ
+#define UINT_BUILTIN_(f, a) \
+ (sizeof(UInt) <= sizeof(unsigned int) ? (buint_size_t)__builtin_##f((unsigned int)(a)) : \
+  sizeof(UInt) <= sizeof(unsigned long) ? (buint_size_t)__builtin_##f##l((unsigned long)(a)) : \
+  (buint_size_t)__builtin_##f##ll((unsigned long long)(a)))
+// Leading zeros of the argument type above the UInt bits.
+#define UINT_CLZ_PAD_ \
+ (sizeof(UInt) <= sizeof(unsigned int) ? 8 * sizeof(unsigned int) - UINT_BITS : \
+  sizeof(UInt) <= sizeof(unsigned long) ? 8 * sizeof(unsigned long) - UINT_BITS : \
+  8 * sizeof(unsigned long long) - UINT_BITS)
+#endif
+
 /**
- @return most significant bit (set to 1) of the value.
+ @return most significant bit (set to 1) of the value (0 if a is 0).
 */
-buint_size_t uint_msb(UInt a);
+static inline buint_size_t uint_msb(UInt a) {
+#ifdef HAVE_BUILTIN_CLZ
+ return a ? UINT_BITS - 1 - (UINT_BUILTIN_(clz, a) - UINT_CLZ_PAD_) : 0;
+#else
+ // kind of binary search..
+ buint_size_t n = 4 * sizeof(UInt);
+ buint_size_t inf = 0;
+ for (buint_size_t s = n / 2; 0 < s; s/=2) {
+  if (a < (UInt)1 << n) {
+   n-=s;    // same as n=inf+s
+  } else {
+   inf = n;
+   n+=s;
+  }
+ }
+ return a < (UInt)1 << n ? inf : n;
+#endif
+}
+
+/**
+ @return number of leading zero bits (UINT_BITS if a is 0).
+*/
+static inline buint_size_t uint_clz(UInt a) {
+#ifdef HAVE_BUILTIN_CLZ
+ return a ? UINT_BUILTIN_(clz, a) - UINT_CLZ_PAD_ : UINT_BITS;
+#else
+ return a ? UINT_BITS - 1 - uint_msb(a) : UINT_BITS;
+#endif
+}
+
+/**
+ @return number of trailing zero bits (UINT_BITS if a is 0).
+*/
+static inline buint_size_t uint_ctz(UInt a) {
+#ifdef HAVE_BUILTIN_CLZ
+ return a ? UINT_BUILTIN_(ctz, a) : UINT_BITS;
+#else
+ return a ? uint_msb(a & -a) : UINT_BITS;
+#endif
+}
+
+/**
+ @return number of bits set to 1.
+*/
+static inline buint_size_t uint_popcount(UInt a) {
+#ifdef HAVE_BUILTIN_CLZ
+ return UINT_BUILTIN_(popcount, a);
+#else
+ // parallel counting in 2, 4 and 8 bit fields, then summing up the bytes by multiplication
+ const UInt m1 = (UInt)-1 / 3;
+ const UInt m2 = (UInt)-1 / 5;
+ const UInt m4 = (UInt)-1 / 17;
+ const UInt h01 = (UInt)-1 / 255;
+ a -= (a >> 1) & m1;
+ a = (a & m2) + ((a >> 2) & m2);
+ a = (a + (a >> 4)) & m4;
+ return (buint_size_t)((UInt)(a * h01) >> (UINT_BITS - 8));
+#endif
+}
+
+#ifdef HAVE_BUILTIN_CLZ
+#undef UINT_BUILTIN_
+#undef UINT_CLZ_PAD_
+#endif
 
 #undef UINT_BITS
 #endif
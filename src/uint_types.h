@@ -30,6 +30,10 @@
   typedef bool buint_bool;	///< Logical value.
   #ifdef USE_UINT64_T
     typedef uint64_t UInt;	///< Alias on the basic store unit.
+    #ifdef __SIZEOF_INT128__
+      typedef unsigned __int128 DUInt;	///< Double the size of UInt (compiler extension).
+      #define HAVE_DUINT 1
+    #endif
     typedef uint32_t SUInt;	///< Half the size of UInt.
     #define HAVE_SUINT 1
     #define PRIuint PRIu64
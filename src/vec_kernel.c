@@ -0,0 +1,371 @@
+/*****************************************************************************
+
+    Copyright 2020 SZIGETI János
+
+    This file is part of biguint library (Big Unsigned Integers).
+
+    Biguint is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Biguint is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+*****************************************************************************/
+#include "vec_kernel.h"
+#include "uint.h"
+#include <string.h>
+
+// Local definitions
+#define UINT_BITS (8u * sizeof(UInt))
+#define GENERIC_CHUNK 64u
+
+#ifdef VEC_KERNEL_HAVE_X86
+// Unaligned vectors of cells: the rows of a vector are not padded to the register size.
+typedef UInt VecUInt128_ __attribute__((vector_size(16), aligned(sizeof(UInt)), may_alias));
+typedef UInt VecUInt256_ __attribute__((vector_size(32), aligned(sizeof(UInt)), may_alias));
+#define TARGET_SSE2
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+
+VecKernel vec_kernel_active = VEC_KERNEL_GENERIC;
+
+// Static function declarations
+static VecKernel detect_(void);
+static void init_(void);
+static void generic_add_(UInt *r, const UInt *a, const UInt *b, buint_size_t cells, buint_size_t n, buint_size_t k);
+static void generic_sub_(UInt *r, const UInt *a, const UInt *b, buint_size_t cells, buint_size_t n, buint_size_t k);
+static void generic_lt_(buint_bool *r, const UInt *a, const UInt *b, buint_size_t cells, buint_size_t n, buint_size_t k);
+static void generic_eq_(buint_bool *r, const UInt *a, const UInt *b, buint_size_t cells, buint_size_t n, buint_size_t k);
+static void generic_minmax_(UInt *r, const UInt *a, const UInt *b, buint_size_t cells, buint_size_t n, buint_bool max, buint_size_t k);
+
+// Implementations
+
+/**
+ * Selects the best kernel supported by the CPU (and the OS, as for the AVX registers).
+ * @return Kernel identifier (not VEC_KERNEL_AUTO).
+ */
+static VecKernel detect_(void) {
+#ifdef VEC_KERNEL_HAVE_X86
+ __builtin_cpu_init();	// constructors may run before that of libgcc
+ if (__builtin_cpu_supports("avx2")) return VEC_KERNEL_AVX2;
+ return VEC_KERNEL_SSE2;	// part of x86-64
+#else
+ return VEC_KERNEL_GENERIC;
+#endif
+}
+
+/**
+ * Load-time kernel selection.
+ * Without constructor support, the generic kernel is used until vec_kernel_set() is called.
+ */
+#if defined(__GNUC__) || defined(__clang__)
+__attribute__((constructor))
+#endif
+static void init_(void) {
+ vec_kernel_active = detect_();
+}
+
+buint_bool vec_kernel_supported(VecKernel k) {
+ switch (k) {
+  case VEC_KERNEL_AUTO:
+  case VEC_KERNEL_GENERIC:
+   return 1;
+  case VEC_KERNEL_SSE2:
+  case VEC_KERNEL_AVX2:
+   return detect_() >= k;
+ }
+ return 0;
+}
+
+buint_bool vec_kernel_set(VecKernel k) {
+ if (!vec_kernel_supported(k)) return 0;
+ vec_kernel_active = k == VEC_KERNEL_AUTO ? detect_() : k;
+ return 1;
+}
+
+const char *vec_kernel_name(VecKernel k) {
+ switch (k) {
+  case VEC_KERNEL_AUTO: return "auto";
+  case VEC_KERNEL_GENERIC: return "generic";
+  case VEC_KERNEL_SSE2: return "sse2";
+  case VEC_KERNEL_AVX2: return "avx2";
+ }
+ return "unknown";
+}
+
+/*
+ * Generic kernels: elements k..n-1, processed in chunks of GENERIC_CHUNK elements row by row,
+ * keeping the carries of the chunk in a local array (thus the memory is read sequentially).
+ */
+
+static void generic_add_(UInt *r, const UInt *a, const UInt *b, buint_size_t cells, buint_size_t n, buint_size_t k) {
+ buint_bool carry[GENERIC_CHUNK];
+ for (; k < n; k += GENERIC_CHUNK) {
+  buint_size_t m = n - k < GENERIC_CHUNK ? n - k : GENERIC_CHUNK;
+  memset(carry, 0, sizeof(carry));
+  for (buint_size_t i = 0; i < cells; ++i) {
+   for (buint_size_t j = 0; j < m; ++j) {
+    r[i * n + k + j] = uint_add(a[i * n + k + j], b[i * n + k + j], &carry[j]);
+   }
+  }
+ }
+}
+
+static void generic_sub_(UInt *r, const UInt *a, const UInt *b, buint_size_t cells, buint_size_t n, buint_size_t k) {
+ buint_bool carry[GENERIC_CHUNK];
+ for (; k < n; k += GENERIC_CHUNK) {
+  buint_size_t m = n - k < GENERIC_CHUNK ? n - k : GENERIC_CHUNK;
+  memset(carry, 0, sizeof(carry));
+  for (buint_size_t i = 0; i < cells; ++i) {
+   for (buint_size_t j = 0; j < m; ++j) {
+    r[i * n + k + j] = uint_sub(a[i * n + k + j], b[i * n + k + j], &carry[j]);
+   }
+  }
+ }
+}
+
+static void generic_lt_(buint_bool *r, const UInt *a, const UInt *b, buint_size_t cells, buint_size_t n, buint_size_t k) {
+ for (; k < n; k += GENERIC_CHUNK) {
+  buint_size_t m = n - k < GENERIC_CHUNK ? n - k : GENERIC_CHUNK;
+  memset(r + k, 0, m * sizeof(buint_bool));
+  for (buint_size_t i = 0; i < cells; ++i) {
+   for (buint_size_t j = 0; j < m; ++j) {
+    (void)uint_sub(a[i * n + k + j], b[i * n + k + j], &r[k + j]);
+   }
+  }
+ }
+}
+
+static void generic_eq_(buint_bool *r, const UInt *a, const UInt *b, buint_size_t cells, buint_size_t n, buint_size_t k) {
+ UInt diff[GENERIC_CHUNK];
+ for (; k < n; k += GENERIC_CHUNK) {
+  buint_size_t m = n - k < GENERIC_CHUNK ? n - k : GENERIC_CHUNK;
+  memset(diff, 0, sizeof(diff));
+  for (buint_size_t i = 0; i < cells; ++i) {
+   for (buint_size_t j = 0; j < m; ++j) {
+    diff[j] |= a[i * n + k + j] ^ b[i * n + k + j];
+   }
+  }
+  for (buint_size_t j = 0; j < m; ++j) r[k + j] = diff[j] == 0;
+ }
+}
+
+/**
+ * Elementwise minimum (or maximum) of the elements k..n-1.
+ * The borrows of the chunk are computed first, thus r may be the same as a or b.
+ */
+static void generic_minmax_(UInt *r, const UInt *a, const UInt *b, buint_size_t cells, buint_size_t n, buint_bool max, buint_size_t k) {
+ buint_bool lt[GENERIC_CHUNK];
+ for (; k < n; k += GENERIC_CHUNK) {
+  buint_size_t m = n - k < GENERIC_CHUNK ? n - k : GENERIC_CHUNK;
+  memset(lt, 0, sizeof(lt));
+  for (buint_size_t i = 0; i < cells; ++i) {
+   for (buint_size_t j = 0; j < m; ++j) {
+    (void)uint_sub(a[i * n + k + j], b[i * n + k + j], &lt[j]);
+   }
+  }
+  for (buint_size_t i = 0; i < cells; ++i) {
+   for (buint_size_t j = 0; j < m; ++j) {
+    UInt mask = (UInt)0 - (UInt)(lt[j] != max);	// all ones: a is selected
+    r[i * n + k + j] = (a[i * n + k + j] & mask) | (b[i * n + k + j] & ~mask);
+   }
+  }
+ }
+}
+
+/**
+ * Bitwise operation of the cells k..len-1.
+ * @param op One of '&', '|', '^' and '~' (b is not read).
+ */
+static void generic_bitwise_(UInt *r, const UInt *a, const UInt *b, buint_size_t len, char op, buint_size_t k) {
+ for (; k < len; ++k) {
+  switch (op) {
+   case '&': r[k] = a[k] & b[k]; break;
+   case '|': r[k] = a[k] | b[k]; break;
+   case '^': r[k] = a[k] ^ b[k]; break;
+   default: r[k] = ~a[k]; break;
+  }
+ }
+}
+
+#ifdef VEC_KERNEL_HAVE_X86
+/*
+ * SIMD kernels, instantiated for SSE2 and AVX2 (same code, different register width and target).
+ * Each processes whole registers of elements from k on, and returns the index of the first unprocessed element.
+ * The carry (borrow) of each lane is kept as 0 or 1 in a register,
+ * computed from the most significant bits of the operands and the result (Hacker's Delight, 2-13).
+ */
+#define VEC_KERNEL_FAMILY_(NAME, V, TARGET) \
+TARGET static buint_size_t NAME##_add_(UInt *r, const UInt *a, const UInt *b, buint_size_t cells, buint_size_t n, buint_size_t k) { \
+ const buint_size_t lanes = sizeof(V) / sizeof(UInt); \
+ for (; k + lanes <= n; k += lanes) { \
+  V c = {0}; \
+  for (buint_size_t i = 0; i < cells; ++i) { \
+   V x = *(const V *)(a + i * n + k); \
+   V y = *(const V *)(b + i * n + k); \
+   V s = x + y + c; \
+   c = ((x & y) | ((x | y) & ~s)) >> (UINT_BITS - 1); \
+   *(V *)(r + i * n + k) = s; \
+  } \
+ } \
+ return k; \
+} \
+\
+TARGET static buint_size_t NAME##_sub_(UInt *r, const UInt *a, const UInt *b, buint_size_t cells, buint_size_t n, buint_size_t k) { \
+ const buint_size_t lanes = sizeof(V) / sizeof(UInt); \
+ for (; k + lanes <= n; k += lanes) { \
+  V c = {0}; \
+  for (buint_size_t i = 0; i < cells; ++i) { \
+   V x = *(const V *)(a + i * n + k); \
+   V y = *(const V *)(b + i * n + k); \
+   V d = x - y - c; \
+   c = ((~x & y) | ((~x | y) & d)) >> (UINT_BITS - 1); \
+   *(V *)(r + i * n + k) = d; \
+  } \
+ } \
+ return k; \
+} \
+\
+TARGET static inline V NAME##_borrow_(const UInt *a, const UInt *b, buint_size_t cells, buint_size_t n, buint_size_t k) { \
+ V c = {0}; \
+ for (buint_size_t i = 0; i < cells; ++i) { \
+  V x = *(const V *)(a + i * n + k); \
+  V y = *(const V *)(b + i * n + k); \
+  c = ((~x & y) | ((~x | y) & (x - y - c))) >> (UINT_BITS - 1); \
+ } \
+ return c; \
+} \
+\
+TARGET static buint_size_t NAME##_lt_(buint_bool *r, const UInt *a, const UInt *b, buint_size_t cells, buint_size_t n, buint_size_t k) { \
+ const buint_size_t lanes = sizeof(V) / sizeof(UInt); \
+ for (; k + lanes <= n; k += lanes) { \
+  V c = NAME##_borrow_(a, b, cells, n, k); \
+  for (buint_size_t l = 0; l < lanes; ++l) r[k + l] = c[l] != 0; \
+ } \
+ return k; \
+} \
+\
+TARGET static buint_size_t NAME##_eq_(buint_bool *r, const UInt *a, const UInt *b, buint_size_t cells, buint_size_t n, buint_size_t k) { \
+ const buint_size_t lanes = sizeof(V) / sizeof(UInt); \
+ for (; k + lanes <= n; k += lanes) { \
+  V d = {0}; \
+  for (buint_size_t i = 0; i < cells; ++i) { \
+   d |= *(const V *)(a + i * n + k) ^ *(const V *)(b + i * n + k); \
+  } \
+  for (buint_size_t l = 0; l < lanes; ++l) r[k + l] = d[l] == 0; \
+ } \
+ return k; \
+} \
+\
+TARGET static buint_size_t NAME##_minmax_(UInt *r, const UInt *a, const UInt *b, buint_size_t cells, buint_size_t n, buint_bool max, buint_size_t k) { \
+ const buint_size_t lanes = sizeof(V) / sizeof(UInt); \
+ for (; k + lanes <= n; k += lanes) { \
+  V c = NAME##_borrow_(a, b, cells, n, k); \
+  V m = -(c ^ (UInt)max);	/* all ones in the lanes where a is selected */ \
+  for (buint_size_t i = 0; i < cells; ++i) { \
+   V x = *(const V *)(a + i * n + k); \
+   V y = *(const V *)(b + i * n + k); \
+   *(V *)(r + i * n + k) = (x & m) | (y & ~m); \
+  } \
+ } \
+ return k; \
+} \
+\
+TARGET static buint_size_t NAME##_bitwise_(UInt *r, const UInt *a, const UInt *b, buint_size_t len, char op, buint_size_t k) { \
+ const buint_size_t lanes = sizeof(V) / sizeof(UInt); \
+ for (; k + lanes <= len; k += lanes) { \
+  V x = *(const V *)(a + k); \
+  switch (op) { \
+   case '&': x &= *(const V *)(b + k); break; \
+   case '|': x |= *(const V *)(b + k); break; \
+   case '^': x ^= *(const V *)(b + k); break; \
+   default: x = ~x; break; \
+  } \
+  *(V *)(r + k) = x; \
+ } \
+ return k; \
+}
+
+VEC_KERNEL_FAMILY_(sse2, VecUInt128_, TARGET_SSE2)
+VEC_KERNEL_FAMILY_(avx2, VecUInt256_, TARGET_AVX2)
+
+/*
+ * Dispatch: the AVX2 kernel leaves at most 3 (or 7) elements,
+ * of which the SSE2 kernel processes the pairs (quadruples), the generic kernel the rest.
+ */
+#define VEC_KERNEL_DISPATCH_(k, OP, ...) \
+ switch (vec_kernel_active) { \
+  case VEC_KERNEL_AVX2: k = avx2_##OP##_(__VA_ARGS__, k); /* fall through */ \
+  case VEC_KERNEL_SSE2: k = sse2_##OP##_(__VA_ARGS__, k); break; \
+  default: break; \
+ }
+#else
+#define VEC_KERNEL_DISPATCH_(k, OP, ...)
+#endif
+
+void vec_kernel_add(UInt *r, const UInt *a, const UInt *b, buint_size_t cells, buint_size_t n) {
+ buint_size_t k = 0;
+ VEC_KERNEL_DISPATCH_(k, add, r, a, b, cells, n)
+ generic_add_(r, a, b, cells, n, k);
+}
+
+void vec_kernel_sub(UInt *r, const UInt *a, const UInt *b, buint_size_t cells, buint_size_t n) {
+ buint_size_t k = 0;
+ VEC_KERNEL_DISPATCH_(k, sub, r, a, b, cells, n)
+ generic_sub_(r, a, b, cells, n, k);
+}
+
+void vec_kernel_lt(buint_bool *r, const UInt *a, const UInt *b, buint_size_t cells, buint_size_t n) {
+ buint_size_t k = 0;
+ VEC_KERNEL_DISPATCH_(k, lt, r, a, b, cells, n)
+ generic_lt_(r, a, b, cells, n, k);
+}
+
+void vec_kernel_eq(buint_bool *r, const UInt *a, const UInt *b, buint_size_t cells, buint_size_t n) {
+ buint_size_t k = 0;
+ VEC_KERNEL_DISPATCH_(k, eq, r, a, b, cells, n)
+ generic_eq_(r, a, b, cells, n, k);
+}
+
+void vec_kernel_min(UInt *r, const UInt *a, const UInt *b, buint_size_t cells, buint_size_t n) {
+ buint_size_t k = 0;
+ VEC_KERNEL_DISPATCH_(k, minmax, r, a, b, cells, n, 0)
+ generic_minmax_(r, a, b, cells, n, 0, k);
+}
+
+void vec_kernel_max(UInt *r, const UInt *a, const UInt *b, buint_size_t cells, buint_size_t n) {
+ buint_size_t k = 0;
+ VEC_KERNEL_DISPATCH_(k, minmax, r, a, b, cells, n, 1)
+ generic_minmax_(r, a, b, cells, n, 1, k);
+}
+
+void vec_kernel_and(UInt *r, const UInt *a, const UInt *b, buint_size_t len) {
+ buint_size_t k = 0;
+ VEC_KERNEL_DISPATCH_(k, bitwise, r, a, b, len, '&')
+ generic_bitwise_(r, a, b, len, '&', k);
+}
+
+void vec_kernel_or(UInt *r, const UInt *a, const UInt *b, buint_size_t len) {
+ buint_size_t k = 0;
+ VEC_KERNEL_DISPATCH_(k, bitwise, r, a, b, len, '|')
+ generic_bitwise_(r, a, b, len, '|', k);
+}
+
+void vec_kernel_xor(UInt *r, const UInt *a, const UInt *b, buint_size_t len) {
+ buint_size_t k = 0;
+ VEC_KERNEL_DISPATCH_(k, bitwise, r, a, b, len, '^')
+ generic_bitwise_(r, a, b, len, '^', k);
+}
+
+void vec_kernel_not(UInt *r, const UInt *a, buint_size_t len) {
+ buint_size_t k = 0;
+ VEC_KERNEL_DISPATCH_(k, bitwise, r, a, a, len, '~')
+ generic_bitwise_(r, a, a, len, '~', k);
+}
@@ -0,0 +1,120 @@
+/*****************************************************************************
+
+    Copyright 2020 SZIGETI János
+
+    This file is part of biguint library (Big Unsigned Integers).
+
+    Biguint is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Biguint is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+*****************************************************************************/
+#ifndef _VEC_KERNEL_H_
+#define _VEC_KERNEL_H_
+
+#include "uint_types.h"
+
+/**
+ Elementwise kernels of the struct-of-arrays vectors (see BigUIntVec128).
+
+ The operands are cell arrays of n elements: cell i of element k is at index i * n + k,
+ thus the same cell of consecutive elements is contiguous, and a SIMD register holds the same cell of several elements.
+ The carries (borrows) are computed across the cells vertically, in each lane separately:
+ the carry out of s = a + b + c is the most significant bit of (a & b) | ((a | b) & ~s),
+ which needs only addition, bitwise operations and shift (SSE2 has no 64 bit comparison).
+ The elements that do not fill a whole register are processed by the narrower kernels (SSE2, then generic code).
+ The kernel is selected at load time by means of cpuid; it can be overridden by vec_kernel_set().
+ Unless stated otherwise, the output may be the same as (but must not partially overlap with) an input.
+*/
+
+/**
+ Identifiers of the vector kernels.
+*/
+typedef enum {
+ VEC_KERNEL_AUTO = 0,	///< Best kernel supported by the CPU (as selected at load time).
+ VEC_KERNEL_GENERIC = 1,	///< Portable C code, one element after the other.
+ VEC_KERNEL_SSE2 = 2,	///< x86-64 SSE2, 128 bit registers.
+ VEC_KERNEL_AVX2 = 3	///< x86-64 AVX2, 256 bit registers.
+} VecKernel;
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define VEC_KERNEL_HAVE_X86 1
+#endif
+
+/**
+ Currently active kernel (never VEC_KERNEL_AUTO), read by the kernel functions.
+*/
+extern VecKernel vec_kernel_active;
+
+/**
+ @brief Checks whether a kernel can be used on this CPU.
+ @param k Kernel identifier.
+ @return k can be selected by vec_kernel_set().
+*/
+buint_bool vec_kernel_supported(VecKernel k);
+
+/**
+ @brief Selects the vector kernel.
+ Not thread-safe: call it before starting threads that use the vectors.
+ @param k Kernel identifier; VEC_KERNEL_AUTO restores the choice made at load time.
+ @return The kernel is supported and has been selected (otherwise the active kernel is unchanged).
+*/
+buint_bool vec_kernel_set(VecKernel k);
+
+/**
+ @brief Human-readable name of a kernel.
+*/
+const char *vec_kernel_name(VecKernel k);
+
+/**
+ @brief Elementwise addition: r = a + b (modulo 2^(cells * UINT_BITS)).
+ @param cells Number of cells of an element.
+ @param n Number of elements.
+*/
+void vec_kernel_add(UInt *r, const UInt *a, const UInt *b, buint_size_t cells, buint_size_t n);
+
+/**
+ @brief Elementwise subtraction: r = a - b (modulo 2^(cells * UINT_BITS)).
+*/
+void vec_kernel_sub(UInt *r, const UInt *a, const UInt *b, buint_size_t cells, buint_size_t n);
+
+/**
+ @brief Elementwise 'less than' relation: r[k] = a[k] < b[k] (the borrow out of a[k] - b[k]).
+ @param r Output: n values.
+*/
+void vec_kernel_lt(buint_bool *r, const UInt *a, const UInt *b, buint_size_t cells, buint_size_t n);
+
+/**
+ @brief Elementwise equality: r[k] = a[k] == b[k].
+ @param r Output: n values.
+*/
+void vec_kernel_eq(buint_bool *r, const UInt *a, const UInt *b, buint_size_t cells, buint_size_t n);
+
+/**
+ @brief Elementwise minimum: r = a < b ? a : b (branch-free selection by the borrow).
+*/
+void vec_kernel_min(UInt *r, const UInt *a, const UInt *b, buint_size_t cells, buint_size_t n);
+
+/**
+ @brief Elementwise maximum: r = a < b ? b : a.
+*/
+void vec_kernel_max(UInt *r, const UInt *a, const UInt *b, buint_size_t cells, buint_size_t n);
+
+/**
+ @brief Bitwise operations of len cells (the layout does not matter).
+*/
+void vec_kernel_and(UInt *r, const UInt *a, const UInt *b, buint_size_t len);
+void vec_kernel_or(UInt *r, const UInt *a, const UInt *b, buint_size_t len);
+void vec_kernel_xor(UInt *r, const UInt *a, const UInt *b, buint_size_t len);
+void vec_kernel_not(UInt *r, const UInt *a, buint_size_t len);
+
+#endif
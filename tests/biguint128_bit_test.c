@@ -168,6 +168,113 @@ bool test_lzx_no_bits() {
  return check_lzx(&a, 0, res_cell, 0, res_bit);
 }
 
+static bool check_bitscan_(const BigUInt128 *a, buint_size_t exp_msb, buint_size_t exp_clz, buint_size_t exp_ctz, buint_size_t exp_popcount) {
+ bool pass = true;
+ const char *funname[] = {"msb", "clz", "ctz", "popcount"};
+ buint_size_t expected[] = {exp_msb, exp_clz, exp_ctz, exp_popcount};
+ buint_size_t actual[] = {biguint128_msb(a), biguint128_clz(a), biguint128_ctz(a), biguint128_popcount(a)};
+ ArgType paramt = BUINT_XROREF;
+ ArgType rest = BUINT_TSIZE;
+ GenArgU arg = {.x=*a};
+ for (unsigned int i = 0; i < ARRAYSIZE(funname); ++i) {
+  if (expected[i] != actual[i]) {
+   GenArgU exp_r = {.sz = expected[i]};
+   GenArgU act_r = {.sz = actual[i]};
+   fprintf_biguint128_genfun0_testresult(stderr, funname[i], &arg, &act_r, &exp_r, 1, &paramt, 1, &rest, FMT_HEX);
+   pass = false;
+  }
+ }
+ return pass;
+}
+
+bool test_bitscan() {
+ bool pass = true;
+ BigUInt128 a = biguint128_ctor_default();
+ BigUInt128 unit = biguint128_ctor_unit();
+ pass &= check_bitscan_(&a, 0, BIGUINT_BITS, BIGUINT_BITS, 0);
+ for (buint_size_t i = 0; i < BIGUINT_BITS; ++i) {
+  BigUInt128 single = biguint128_ctor_default();
+  biguint128_sbit(&single, i);
+  BigUInt128 below = biguint128_sub(&single, &unit);
+  biguint128_or_assign(&below, &single);
+  BigUInt128 above = biguint128_sub(&a, &single);
+  pass &= check_bitscan_(&single, i, BIGUINT_BITS - 1 - i, i, 1);
+  pass &= check_bitscan_(&below, i, BIGUINT_BITS - 1 - i, 0, i + 1);
+  pass &= check_bitscan_(&above, BIGUINT_BITS - 1, 0, i, BIGUINT_BITS - i);
+ }
+ return pass;
+}
+
+/**
+ * Reference shift / rotation, bit by bit.
+ * @param rotate Rotation, otherwise shift.
+ * @param left Left, otherwise right.
+ */
+static BigUInt128 shift_ref_(const BigUInt128 *a, buint_size_t shift, bool rotate, bool left) {
+ BigUInt128 retv = biguint128_ctor_default();
+ if (rotate) shift %= BIGUINT_BITS;
+ for (buint_size_t i = 0; i < BIGUINT_BITS; ++i) {
+  buint_size_t src;
+  if (rotate) {
+   src = left ? (i + BIGUINT_BITS - shift) % BIGUINT_BITS : (i + shift) % BIGUINT_BITS;
+  } else if (left) {
+   if (i < shift) continue;
+   src = i - shift;
+  } else {
+   if (BIGUINT_BITS <= i + shift) continue;
+   src = i + shift;
+  }
+  biguint128_obit(&retv, i, biguint128_gbit(a, src));
+ }
+ return retv;
+}
+
+bool test_shift_all_amounts() {
+ bool pass = true;
+ BigUInt128 samples[3];
+ samples[0] = biguint128_ctor_default();
+ biguint128_sub_tiny(&samples[0], 1);
+ samples[1] = samples[0];
+ for (buint_size_t i = 0; i < BIGUINT128_CELLS; ++i) {
+  samples[1].dat[i] = (UInt)0x9E3779B97F4A7C15ULL * (UInt)(i + 1);
+ }
+ samples[2] = biguint128_ctor_unit();
+ biguint128_sbit(&samples[2], BIGUINT_BITS - 1);
+ const char *funname[] = {"shl", "shr", "rol", "ror", "shl_assign", "shr_assign", "rol_assign"};
+ for (unsigned int si = 0; si < ARRAYSIZE(samples); ++si) {
+  for (buint_size_t shift = 0; shift <= BIGUINT_BITS + UINT_BITS + 1; ++shift) {
+   const BigUInt128 *a = &samples[si];
+   BigUInt128 res[7];
+   res[0] = biguint128_shl(a, shift);
+   res[1] = biguint128_shr(a, shift);
+   res[2] = biguint128_rol(a, shift);
+   res[3] = biguint128_ror(a, shift);
+   res[4] = *a;
+   biguint128_shl_assign(&res[4], shift);
+   res[5] = *a;
+   biguint128_shr_assign(&res[5], shift);
+   res[6] = *a;
+   biguint128_rol_assign(&res[6], shift);
+   BigUInt128 expected[7] = {
+    shift_ref_(a, shift, false, true),
+    shift_ref_(a, shift, false, false),
+    shift_ref_(a, shift, true, true),
+    shift_ref_(a, shift, true, false)
+   };
+   expected[4] = expected[0];
+   expected[5] = expected[1];
+   expected[6] = expected[2];
+   for (unsigned int fi = 0; fi < ARRAYSIZE(funname); ++fi) {
+    if (!biguint128_eq(&res[fi], &expected[fi])) {
+     fprintf(stderr, "%s failed: sample #%u, shift %u\n", funname[fi], si, (unsigned int)shift);
+     pass = false;
+    }
+   }
+  }
+ }
+ return pass;
+}
+
 // composition
 static void create_rotated_(CStr *dst, char *buf, unsigned int buflen, const CStr src, buint_size_t shl) {
  BigUInt128 a = biguint128_ctor_hexcstream(src.str, src.len);
@@ -258,6 +365,8 @@ int main() {
  assert(test_genfun(&shxsamples[0][0], SHXSAMPLES_W, shsamples_n, FMT_HEX, rol_params, XBFUN1(biguint128_rol), "rol", NULL) == 0);
  assert(test_genfun(&shxsamples[0][0], SHXSAMPLES_W, shsamples_n, FMT_HEX, ror_params, XBFUN1(biguint128_ror), "ror", NULL) == 0);
  assert(test_genfun(&shxsamples[0][0], SHXSAMPLES_W, shsamples_n, FMT_HEX, shr_params, XBFUN1A(biguint128_shr_assign), "shr_assign", NULL) == 0);
+ assert(test_genfun(&shxsamples[0][0], SHXSAMPLES_W, shsamples_n, FMT_HEX, shl_params, XBFUN1A(biguint128_shl_assign), "shl_assign", NULL) == 0);
+ assert(test_genfun(&shxsamples[0][0], SHXSAMPLES_W, shsamples_n, FMT_HEX, rol_params, XBFUN1A(biguint128_rol_assign), "rol_assign", NULL) == 0);
  assert(test_genfun(&shxsamples[0][0], SHXSAMPLES_W, shsamples_n, FMT_HEX, shl_params, XBFUN1A(biguint128_shl_tiny), "shl_tiny", check_tiny_) == 0);
  assert(test_genfun(&shxsamples[0][0], SHXSAMPLES_W, shsamples_n, FMT_HEX, shr_params, XBFUN1A(biguint128_shr_tiny), "shr_tiny", check_tiny_) == 0);
 
@@ -270,5 +379,7 @@ int main() {
 
  assert(test_lzx_single_bit());
  assert(test_lzx_no_bits());
+ assert(test_bitscan());
+ assert(test_shift_all_amounts());
  return 0;
 }
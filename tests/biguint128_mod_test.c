@@ -0,0 +1,192 @@
+#include "biguint128.h"
+#include "test_common.h"
+#include "test_common128.h"
+#include <stdio.h>
+#include <stdbool.h>
+#include <string.h>
+#include <assert.h>
+
+#define MODULI_N 7U
+#define VALUES_N 6U
+
+BigUInt128 moduli[MODULI_N];
+BigUInt128 values[VALUES_N];
+
+/**
+ * Reference modular addition.
+ * @return (a + b) mod n, where a and b are less than n.
+ */
+static BigUInt128 addmod_ref(const BigUInt128 *a, const BigUInt128 *b, const BigUInt128 *n) {
+ BigUInt128 t = biguint128_sub(n, b);
+ return biguint128_lt(a, &t) ? biguint128_add(a, b) : biguint128_sub(a, &t);
+}
+
+/**
+ * Reference modular multiplication (double and add).
+ * @return (a * b) mod n, where a and b are less than n.
+ */
+static BigUInt128 mulmod_ref(const BigUInt128 *a, const BigUInt128 *b, const BigUInt128 *n) {
+ BigUInt128 r = biguint128_ctor_default();
+ for (buint_size_t i = biguint128_lzb(b); 0 < i; --i) {
+  r = addmod_ref(&r, &r, n);
+  if (biguint128_gbit(b, i - 1)) r = addmod_ref(&r, a, n);
+ }
+ return r;
+}
+
+/**
+ * Reference modular exponentiation (square and multiply).
+ * @return (a ^ e) mod n, where a is less than n.
+ */
+static BigUInt128 powmod_ref(const BigUInt128 *a, const BigUInt128 *e, const BigUInt128 *n) {
+ BigUInt128 r = biguint128_div(&one, n).second; // 1 mod n
+ for (buint_size_t i = biguint128_lzb(e); 0 < i; --i) {
+  r = mulmod_ref(&r, &r, n);
+  if (biguint128_gbit(e, i - 1)) r = mulmod_ref(&r, a, n);
+ }
+ return r;
+}
+
+static void init_samples() {
+ // odd moduli, including primes
+ moduli[0] = max;
+ moduli[1] = biguint128_shr(&max, BIGUINT_BITS - 61); // Mersenne prime
+ moduli[2] = biguint128_value_of_uint(1000000007U); // prime
+ moduli[3] = biguint128_value_of_uint(3U);
+ moduli[4] = biguint128_value_of_uint(1U);
+ moduli[5] = biguint128_ctor_unit();
+ biguint128_sbit(&moduli[5], BIGUINT_BITS - 1); // 2^(n-1) + 1
+ moduli[6] = max;
+ biguint128_cbit(&moduli[6], BIGUINT_BITS / 2);
+ biguint128_cbit(&moduli[6], BIGUINT_BITS / 3);
+
+ values[0] = biguint128_ctor_default();
+ values[1] = biguint128_ctor_unit();
+ values[2] = biguint128_value_of_uint(2U);
+ values[3] = maxbutone;
+ values[4] = biguint128_shr(&max, BIGUINT_BITS / 2);
+ values[5] = biguint128_shr(&max, 1);
+ biguint128_cbit(&values[5], BIGUINT_BITS / 5);
+}
+
+bool test_mont_mul() {
+ bool fail = false;
+ for (unsigned int ni = 0; ni < MODULI_N; ++ni) {
+  MontCtx128 ctx = biguint128_mont_ctor(&moduli[ni]);
+  BigUIntDivisor128 d = biguint128_divisor_ctor(&moduli[ni]);
+  for (unsigned int ai = 0; ai < VALUES_N; ++ai) {
+   BigUInt128 a = biguint128_mod_pre(&values[ai], &d);
+   BigUInt128 am = biguint128_to_mont(&ctx, &a);
+   BigUInt128 aback = biguint128_from_mont(&ctx, &am);
+   if (!biguint128_eq(&a, &aback)) {
+    fprintf(stderr, "from_mont(to_mont(a)) failed: modulus #%u, a #%u\n", ni, ai);
+    fail = true;
+   }
+   BigUInt128 sqr_exp = mulmod_ref(&a, &a, &moduli[ni]);
+   BigUInt128 sqr = biguint128_mont_sqr(&ctx, &am);
+   sqr = biguint128_from_mont(&ctx, &sqr);
+   if (!biguint128_eq(&sqr, &sqr_exp)) {
+    fprintf(stderr, "mont_sqr failed: modulus #%u, a #%u\n", ni, ai);
+    fail = true;
+   }
+   for (unsigned int bi = 0; bi < VALUES_N; ++bi) {
+    BigUInt128 b = biguint128_mod_pre(&values[bi], &d);
+    BigUInt128 bm = biguint128_to_mont(&ctx, &b);
+    BigUInt128 prod_exp = mulmod_ref(&a, &b, &moduli[ni]);
+    BigUInt128 prod = biguint128_mont_mul(&ctx, &am, &bm);
+    prod = biguint128_from_mont(&ctx, &prod);
+    if (!biguint128_eq(&prod, &prod_exp)) {
+     fprintf(stderr, "mont_mul failed: modulus #%u, a #%u, b #%u\n", ni, ai, bi);
+     fail = true;
+    }
+   }
+  }
+ }
+ return !fail;
+}
+
+bool test_modpow() {
+ bool fail = false;
+ for (unsigned int ni = 0; ni < MODULI_N; ++ni) {
+  MontCtx128 ctx = biguint128_mont_ctor(&moduli[ni]);
+  BigUIntDivisor128 d = biguint128_divisor_ctor(&moduli[ni]);
+  for (unsigned int ai = 0; ai < VALUES_N; ++ai) {
+   BigUInt128 a = biguint128_mod_pre(&values[ai], &d);
+   for (unsigned int ei = 0; ei < VALUES_N; ++ei) {
+    BigUInt128 res_exp = powmod_ref(&a, &values[ei], &moduli[ni]);
+    BigUInt128 res = biguint128_modpow(&ctx, &a, &values[ei]);
+    if (!biguint128_eq(&res, &res_exp)) {
+     fprintf(stderr, "modpow failed: modulus #%u, a #%u, exp #%u\n", ni, ai, ei);
+     fail = true;
+    }
+   }
+  }
+ }
+ return !fail;
+}
+
+bool test_modpow_fermat() {
+ // a^(p-1) == 1 (mod p), if p is prime
+ bool fail = false;
+ for (unsigned int ni = 1; ni < 3; ++ni) {
+  MontCtx128 ctx = biguint128_mont_ctor(&moduli[ni]);
+  BigUInt128 e = biguint128_sub(&moduli[ni], &one);
+  for (UInt a0 = 2; a0 < 50; a0 += 7) {
+   BigUInt128 a = biguint128_value_of_uint(a0);
+   BigUInt128 res = biguint128_modpow(&ctx, &a, &e);
+   if (!biguint128_eq(&res, &one)) {
+    fprintf(stderr, "modpow(%u, p - 1) failed: modulus #%u\n", (unsigned int)a0, ni);
+    fail = true;
+   }
+  }
+ }
+ return !fail;
+}
+
+bool test_barrett() {
+ bool fail = false;
+ BigUInt128 even_moduli[] = {
+  biguint128_shl(&one, BIGUINT_BITS / 2),
+  biguint128_value_of_uint(1000000000U),
+  maxbutone,
+  biguint128_value_of_uint(2U)
+ };
+ for (unsigned int ni = 0; ni < MODULI_N + ARRAYSIZE(even_moduli); ++ni) {
+  const BigUInt128 *m = ni < MODULI_N ? &moduli[ni] : &even_moduli[ni - MODULI_N];
+  BarrettCtx128 ctx = biguint128_barrett_ctor(m);
+  BigUIntDivisor128 d = biguint128_divisor_ctor(m);
+  for (unsigned int ai = 0; ai < VALUES_N; ++ai) {
+   // single-width input
+   BigUIntPair128 x = {values[ai], zero};
+   BigUInt128 res = biguint128_barrett_reduce(&ctx, &x);
+   BigUInt128 res_exp = biguint128_div(&values[ai], m).second;
+   if (!biguint128_eq(&res, &res_exp)) {
+    fprintf(stderr, "barrett_reduce failed: modulus #%u, a #%u\n", ni, ai);
+    fail = true;
+   }
+   // double-width input
+   BigUInt128 a = biguint128_mod_pre(&values[ai], &d);
+   for (unsigned int bi = 0; bi < VALUES_N; ++bi) {
+    BigUInt128 b = biguint128_mod_pre(&values[bi], &d);
+    x = biguint128_dmul(&values[ai], &values[bi]);
+    res = biguint128_barrett_reduce(&ctx, &x);
+    res_exp = mulmod_ref(&a, &b, m);
+    if (!biguint128_eq(&res, &res_exp)) {
+     fprintf(stderr, "barrett_reduce(a * b) failed: modulus #%u, a #%u, b #%u\n", ni, ai, bi);
+     fail = true;
+    }
+   }
+  }
+ }
+ return !fail;
+}
+
+int main() {
+ init_testvalues();
+ init_samples();
+ assert(test_mont_mul());
+ assert(test_modpow());
+ assert(test_modpow_fermat());
+ assert(test_barrett());
+ return 0;
+}
@@ -113,6 +113,217 @@ bool test_dmul0() {
  return !fail;
 }
 
+bool test_dmul1() {
+ bool fail = false;
+
+ for (buint_size_t i = 1; i < BIGUINT_BITS; ++i) {
+  BigUInt128 b = biguint128_shl(&one, i);
+  BigUIntPair128 result = biguint128_dmul(&max, &b);
+  BigUInt128 exp_lo = biguint128_shl(&max, i);
+  BigUInt128 exp_hi = biguint128_shr(&max, BIGUINT_BITS - i);
+  BigUInt128 result_mul = biguint128_mul(&max, &b);
+
+  if (!biguint128_eq(&result.first, &exp_lo) || !biguint128_eq(&result.second, &exp_hi)) {
+   fprintf(stderr, "dmul(max, 1<<%u) failed\n", (unsigned int)i);
+   fail = true;
+  }
+  if (!biguint128_eq(&result_mul, &exp_lo)) {
+   fprintf(stderr, "mul(max, 1<<%u) failed\n", (unsigned int)i);
+   fail = true;
+  }
+ }
+ return !fail;
+}
+
+bool test_dmul2() {
+ bool fail = false;
+ // (2^n - 1) * (2^m - 1) = 2^(n+m) - 2^n - 2^m + 1
+ for (buint_size_t n = 1; n <= BIGUINT_BITS; n+=7) {
+  for (buint_size_t m = 1; m <= BIGUINT_BITS; m+=5) {
+   BigUInt128 a = biguint128_shr(&max, BIGUINT_BITS - n);
+   BigUInt128 b = biguint128_shr(&max, BIGUINT_BITS - m);
+   BigUIntPair128 result = biguint128_dmul(&a, &b);
+   BigUInt128 result_mul = biguint128_mul(&a, &b);
+   // expected value: (2^(n+m) + 1) - (2^n + 2^m) in double length
+   BigUIntPair128 exp = {biguint128_ctor_unit(), biguint128_ctor_default()};
+   BigUIntPair128 sub = {zero, zero};
+   biguint128_sbit(n + m < BIGUINT_BITS ? &exp.first : &exp.second, (n + m) % BIGUINT_BITS);
+   biguint128_sbit(n < BIGUINT_BITS ? &sub.first : &sub.second, n % BIGUINT_BITS);
+   BigUInt128 tmp = biguint128_ctor_default();
+   biguint128_sbit(m < BIGUINT_BITS ? &tmp : &sub.second, m % BIGUINT_BITS);
+   buint_bool carry = 0;
+   biguint128_adc_replace(&sub.first, &sub.first, &tmp, &carry);
+   biguint128_add_tiny(&sub.second, carry);
+   carry = 0;
+   biguint128_sbc_replace(&exp.first, &exp.first, &sub.first, &carry);
+   biguint128_sbc_replace(&exp.second, &exp.second, &sub.second, &carry);
+
+   if (!biguint128_eq(&result.first, &exp.first) || !biguint128_eq(&result.second, &exp.second)) {
+    fprintf(stderr, "dmul(2^%u-1, 2^%u-1) failed\n", (unsigned int)n, (unsigned int)m);
+    fail = true;
+   }
+   if (!biguint128_eq(&result_mul, &exp.first)) {
+    fprintf(stderr, "mul(2^%u-1, 2^%u-1) failed\n", (unsigned int)n, (unsigned int)m);
+    fail = true;
+   }
+  }
+ }
+ return !fail;
+}
+
+/**
+ * Checks the a == q * b + r, r < b invariant of division
+ * with multi-cell dividends and divisors.
+ */
+bool test_sqr1() {
+ bool fail = false;
+ for (buint_size_t n = 1; n <= BIGUINT_BITS; n+=3) {
+  // a: 2^n - 1 - 2^(n/2) - 2^(n/3)
+  BigUInt128 a = biguint128_shr(&max, BIGUINT_BITS - n);
+  biguint128_cbit(&a, n / 2);
+  biguint128_cbit(&a, n / 3);
+  BigUIntPair128 exp = biguint128_dmul(&a, &a);
+  BigUIntPair128 result = biguint128_dsqr(&a);
+  BigUInt128 result_sqr = biguint128_sqr(&a);
+  if (!biguint128_eq(&result.first, &exp.first) || !biguint128_eq(&result.second, &exp.second)) {
+   fprintf(stderr, "dsqr(2^%u-1-2^%u-2^%u) failed\n", (unsigned int)n, (unsigned int)(n / 2), (unsigned int)(n / 3));
+   fail = true;
+  }
+  if (!biguint128_eq(&result_sqr, &exp.first)) {
+   fprintf(stderr, "sqr(2^%u-1-2^%u-2^%u) failed\n", (unsigned int)n, (unsigned int)(n / 2), (unsigned int)(n / 3));
+   fail = true;
+  }
+ }
+ return !fail;
+}
+
+bool test_div1() {
+ bool fail = false;
+ for (buint_size_t n = 1; n <= BIGUINT_BITS; n+=3) {
+  for (buint_size_t m = 1; m <= BIGUINT_BITS; m+=5) {
+   // a: 2^n - 1 - 2^(n/2); b: 2^m - 1 - 2^(m/3)
+   BigUInt128 a = biguint128_shr(&max, BIGUINT_BITS - n);
+   BigUInt128 b = biguint128_shr(&max, BIGUINT_BITS - m);
+   biguint128_cbit(&a, n / 2);
+   biguint128_cbit(&b, m / 3);
+   if (biguint128_eqz(&b)) continue;
+   BigUIntPair128 res = biguint128_div(&a, &b);
+   BigUIntPair128 prod = biguint128_dmul(&res.first, &b);
+   BigUInt128 sum = biguint128_add(&prod.first, &res.second);
+   if (!biguint128_eqz(&prod.second) || !biguint128_eq(&sum, &a) || !biguint128_lt(&res.second, &b)) {
+    fprintf(stderr, "div(2^%u-1-2^%u, 2^%u-1-2^%u) failed\n", (unsigned int)n, (unsigned int)(n / 2), (unsigned int)m, (unsigned int)(m / 3));
+    fail = true;
+   }
+  }
+ }
+ return !fail;
+}
+
+bool test_div_pre1() {
+ bool fail = false;
+ for (buint_size_t m = 1; m <= BIGUINT_BITS; m+=5) {
+  // b: 2^m - 1 - 2^(m/3), a: 2^n - 1 - 2^(n/2)
+  BigUInt128 b = biguint128_shr(&max, BIGUINT_BITS - m);
+  biguint128_cbit(&b, m / 3);
+  if (biguint128_eqz(&b)) continue;
+  BigUIntDivisor128 d = biguint128_divisor_ctor(&b);
+  for (buint_size_t n = 1; n <= BIGUINT_BITS; n+=3) {
+   BigUInt128 a = biguint128_shr(&max, BIGUINT_BITS - n);
+   biguint128_cbit(&a, n / 2);
+   BigUIntPair128 res = biguint128_div_pre(&a, &d);
+   BigUInt128 rem = biguint128_mod_pre(&a, &d);
+   BigUIntPair128 prod = biguint128_dmul(&res.first, &b);
+   BigUInt128 sum = biguint128_add(&prod.first, &res.second);
+   if (!biguint128_eqz(&prod.second) || !biguint128_eq(&sum, &a) || !biguint128_lt(&res.second, &b) || !biguint128_eq(&rem, &res.second)) {
+    fprintf(stderr, "div_pre(2^%u-1-2^%u, 2^%u-1-2^%u) failed\n", (unsigned int)n, (unsigned int)(n / 2), (unsigned int)m, (unsigned int)(m / 3));
+    fail = true;
+   }
+  }
+ }
+ return !fail;
+}
+
+bool test_div_pre2() {
+ static const UInt divisors[] = {1, 3, 10, 1000, (UInt)-1};
+ bool fail = false;
+ for (unsigned int i = 0; i < sizeof(divisors) / sizeof(UInt); ++i) {
+  BigUIntDivisor128 d = biguint128_divisor_ctor_uint(divisors[i]);
+  BigUInt128 b = biguint128_value_of_uint(divisors[i]);
+  for (buint_size_t n = 1; n <= BIGUINT_BITS; n+=7) {
+   BigUInt128 a = biguint128_shr(&max, BIGUINT_BITS - n);
+   BigUIntPair128 expected = biguint128_div(&a, &b);
+   BigUIntPair128 res = biguint128_div_pre(&a, &d);
+   BigUInt128 rem = biguint128_mod_pre(&a, &d);
+   if (!biguint128_eq(&res.first, &expected.first) || !biguint128_eq(&res.second, &expected.second) || !biguint128_eq(&rem, &expected.second)) {
+    fprintf(stderr, "div_pre(2^%u-1, %" PRIuint ") failed\n", (unsigned int)n, divisors[i]);
+    fail = true;
+   }
+  }
+ }
+ // divisor 0: quotient 0, remainder a
+ BigUIntDivisor128 d0 = biguint128_divisor_ctor_uint(0);
+ BigUIntPair128 res0 = biguint128_div_pre(&max, &d0);
+ BigUInt128 rem0 = biguint128_mod_pre(&max, &d0);
+ if (!biguint128_eqz(&res0.first) || !biguint128_eq(&res0.second, &max) || !biguint128_eq(&rem0, &max)) {
+  fprintf(stderr, "div_pre(max, 0) failed\n");
+  fail = true;
+ }
+ return !fail;
+}
+
+bool test_div_uint1() {
+ const UInt MAX = -1;
+ const UInt HALF = (UInt)1 << (sizeof(UInt) * 4);
+ static const UInt small_divisors[] = {1, 2, 3, 7, 10, 1000};
+ const UInt large_divisors[] = {HALF - 1, HALF, HALF + 1, MAX / 3, MAX - 1, MAX};
+ bool fail = false;
+ for (unsigned int i = 0; i < 12; ++i) {
+  UInt bu = i < 6 ? small_divisors[i] : large_divisors[i - 6];
+  BigUInt128 b = biguint128_value_of_uint(bu);
+  for (buint_size_t n = 1; n <= BIGUINT_BITS; n+=3) {
+   // a: 2^n - 1 - 2^(n/2)
+   BigUInt128 a = biguint128_shr(&max, BIGUINT_BITS - n);
+   biguint128_cbit(&a, n / 2);
+   BigUIntPair128 expected = biguint128_div(&a, &b);
+   BigUIntTinyPair128 res = biguint128_div_uint(&a, bu);
+   UInt rem = biguint128_mod_uint(&a, bu);
+   if (!biguint128_eq(&res.first, &expected.first) || res.second != expected.second.dat[0] || rem != res.second) {
+    fprintf(stderr, "div_uint(2^%u-1-2^%u, %" PRIuint ") failed\n", (unsigned int)n, (unsigned int)(n / 2), bu);
+    fail = true;
+   }
+  }
+ }
+ return !fail;
+}
+
+bool test_divexact1() {
+ bool fail = false;
+ for (buint_size_t m = 1; m <= BIGUINT_BITS; m+=5) {
+  // b: (2^m - 1 - 2^(m/3)) * 2^(m/4), q: 2^n - 1 - 2^(n/2)
+  BigUInt128 b = biguint128_shr(&max, BIGUINT_BITS - m);
+  biguint128_cbit(&b, m / 3);
+  b = biguint128_shl(&b, m / 4);
+  if (biguint128_eqz(&b)) continue;
+  for (buint_size_t n = 1; n <= BIGUINT_BITS; n+=3) {
+   BigUInt128 q = biguint128_shr(&max, BIGUINT_BITS - n);
+   biguint128_cbit(&q, n / 2);
+   BigUIntPair128 a = biguint128_dmul(&q, &b);
+   if (!biguint128_eqz(&a.second)) continue; // the product must fit
+   BigUInt128 res = biguint128_divexact(&a.first, &b);
+   buint_bool uint_fail = false;
+   if (biguint128_lzc(&b) <= 1) {
+    BigUInt128 resu = biguint128_divexact_uint(&a.first, b.dat[0]);
+    uint_fail = !biguint128_eq(&resu, &q);
+   }
+   if (!biguint128_eq(&res, &q) || uint_fail) {
+    fprintf(stderr, "divexact((2^%u-1-2^%u) * b, b) failed, m = %u\n", (unsigned int)n, (unsigned int)(n / 2), (unsigned int)m);
+    fail = true;
+   }
+  }
+ }
+ return !fail;
+}
+
 bool test_div10_a() {
  static const char *fnname[]={
   "div1000(mul100(x))",
@@ -222,6 +433,9 @@ int main() {
  assert(test_mul2());
 
  assert(test_dmul0());
+ assert(test_dmul1());
+ assert(test_dmul2());
+ assert(test_sqr1());
 
  {
   unsigned int mul_params[] = {0, 1, 2};
@@ -234,6 +448,11 @@ int main() {
 #endif
  }
 
+ assert(test_div1());
+ assert(test_div_pre1());
+ assert(test_div_pre2());
+ assert(test_div_uint1());
+ assert(test_divexact1());
  assert(test_div10_a());
  assert(test_div3_a());
  return 0;
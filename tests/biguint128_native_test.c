@@ -0,0 +1,116 @@
+#include <stdio.h>
+#include <stdbool.h>
+#include <string.h>
+#include <assert.h>
+#include "biguint128.h"
+#include "biguintn.h"
+#include "test_common.h"
+
+/*
+ * Compares the whole-width operations of BigUInt128 with the generic runtime-length layer (biguintn).
+ * With configure --enable-native-uint128, the former run on the native double-width type.
+ */
+
+#define TEST_N 2000U
+#define CELLS BIGUINT128_CELLS
+#define BITS (8U * sizeof(UInt) * CELLS)
+
+/**
+ * Pseudo-random values, with some special values (0, all bits set) and random bit length.
+ */
+static BigUInt128 random_operand_(unsigned int i) {
+ BigUInt128 retv;
+ fill_random(retv.dat, CELLS);
+ switch (i % 8) {
+ case 0:
+  memset(retv.dat, 0, sizeof(retv.dat));
+  break;
+ case 1:
+  memset(retv.dat, 0xFF, sizeof(retv.dat));
+  break;
+ case 2:
+  biguint128_shr_assign(&retv, next_random() % BITS);
+  break;
+ }
+ return retv;
+}
+
+static bool check_(const char *fun, unsigned int i, const BigUInt128 *expected, const BigUInt128 *actual) {
+ if (memcmp(expected->dat, actual->dat, sizeof(expected->dat)) != 0) {
+  fprintf(stderr, "%s failed: #%u\n", fun, i);
+  return false;
+ }
+ return true;
+}
+
+bool test_native_vs_generic() {
+ bool pass = true;
+ for (unsigned int i = 0; i < TEST_N && pass; ++i) {
+  BigUInt128 a = random_operand_(i);
+  BigUInt128 b = random_operand_(i / 8);
+  buint_size_t shift = i % (BITS + 2);
+  UInt u = b.dat[0] >> (i % 32) | (UInt)(i % 3 == 0);
+  BigUInt128 expected;
+  BigUInt128 actual;
+  UInt prod[2 * CELLS];
+  UInt scratch[BIGUINTN_MUL_SCRATCH(CELLS, CELLS)];
+
+  biguintn_add(expected.dat, a.dat, CELLS, b.dat, CELLS);
+  actual = biguint128_add(&a, &b);
+  pass &= check_("biguint128_add", i, &expected, &actual);
+  actual = a;
+  biguint128_add_assign(&actual, &b);
+  pass &= check_("biguint128_add_assign", i, &expected, &actual);
+  biguint128_add_replace(&actual, &a, &b);
+  pass &= check_("biguint128_add_replace", i, &expected, &actual);
+
+  biguintn_sub(expected.dat, a.dat, CELLS, b.dat, CELLS);
+  actual = biguint128_sub(&a, &b);
+  pass &= check_("biguint128_sub", i, &expected, &actual);
+  actual = a;
+  biguint128_sub_assign(&actual, &b);
+  pass &= check_("biguint128_sub_assign", i, &expected, &actual);
+  biguint128_sub_replace(&actual, &a, &b);
+  pass &= check_("biguint128_sub_replace", i, &expected, &actual);
+
+  biguintn_mul(prod, a.dat, CELLS, b.dat, CELLS, scratch);
+  memcpy(expected.dat, prod, sizeof(expected.dat));
+  actual = biguint128_mul(&a, &b);
+  pass &= check_("biguint128_mul", i, &expected, &actual);
+  biguintn_mul(prod, a.dat, CELLS, a.dat, CELLS, scratch);
+  memcpy(expected.dat, prod, sizeof(expected.dat));
+  actual = biguint128_sqr(&a);
+  pass &= check_("biguint128_sqr", i, &expected, &actual);
+
+  biguintn_shl(expected.dat, a.dat, CELLS, shift);
+  actual = biguint128_shl(&a, shift);
+  pass &= check_("biguint128_shl", i, &expected, &actual);
+  actual = a;
+  biguint128_shl_assign(&actual, shift);
+  pass &= check_("biguint128_shl_assign", i, &expected, &actual);
+  biguintn_shr(expected.dat, a.dat, CELLS, shift);
+  actual = biguint128_shr(&a, shift);
+  pass &= check_("biguint128_shr", i, &expected, &actual);
+  actual = a;
+  biguint128_shr_assign(&actual, shift);
+  pass &= check_("biguint128_shr_assign", i, &expected, &actual);
+
+  bool rel = !biguint128_lt(&a, &b) == !biguintn_lt(a.dat, CELLS, b.dat, CELLS);
+  rel &= !biguint128_lt(&b, &a) == !biguintn_lt(b.dat, CELLS, a.dat, CELLS);
+  rel &= !biguint128_eq(&a, &b) == !biguintn_eq(a.dat, CELLS, b.dat, CELLS);
+  rel &= biguint128_eq(&a, &a) && !biguint128_lt(&a, &a);
+
+  UInt r = biguintn_div_uint(expected.dat, a.dat, CELLS, u);
+  BigUIntTinyPair128 qr = biguint128_div_uint(&a, u);
+  pass &= check_("biguint128_div_uint", i, &expected, &qr.first);
+  rel &= qr.second == r && biguint128_mod_uint(&a, u) == r;
+  if (!rel) fprintf(stderr, "relations or remainder failed: #%u\n", i);
+  pass &= rel;
+ }
+ return pass;
+}
+
+int main() {
+ assert(test_native_vs_generic());
+ return 0;
+}
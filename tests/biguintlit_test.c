@@ -0,0 +1,65 @@
+#include <stdio.h>
+#include <stdbool.h>
+#include <string.h>
+#include <assert.h>
+#include "biguint128.h"
+#include "bigdecimal128.h"
+#include "biguintlit.h"
+#include "test_common.h"
+// generated by biguintlit (see Makefile.am)
+#include "biguintlit_test_values.h"
+
+static const BigUInt128 max_lit = LIT_MAX;
+static const BigUInt128 pow10_lit = LIT_POW10_38;
+static const BigUInt128 hex_lit = LIT_HEX;
+static const BigUInt128 zero_lit = LIT_ZERO;
+static const BigUInt128 neg_lit = LIT_NEG;
+static const BigUInt128 min_lit = LIT_MIN;
+static const BigDecimal128 dec_lit = LIT_DEC;
+static const BigDecimal128 negdec_lit = LIT_NEGDEC;
+static const BigUInt128 table_lit[] = {LIT_POW10_38, LIT_HEX, LIT_ZERO};
+
+static const CStr max_str = STR("FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFF");
+static const CStr pow10_str = STR("100000000000000000000000000000000000000");
+static const CStr hex_str = STR("0123456789ABCDEF0FEDCBA987654321");
+static const CStr neg_str = STR("-12345678901234567890123");
+static const CStr min_str = STR("80000000000000000000000000000000");
+static const CStr dec_str = STR("170141183460469231731687303715884.105727");
+static const CStr negdec_str = STR("-3.14159265358979323846");
+
+static bool dec_eq_(const BigDecimal128 *expected, const BigDecimal128 *actual) {
+ return biguint128_eq(&expected->val, &actual->val) && expected->prec == actual->prec;
+}
+
+bool test_uint_literals() {
+ BigUInt128 max = biguint128_ctor_hexcstream(max_str.str, max_str.len);
+ BigUInt128 pow10 = biguint128_ctor_deccstream(pow10_str.str, pow10_str.len);
+ BigUInt128 hex = biguint128_ctor_hexcstream(hex_str.str, hex_str.len);
+ BigUInt128 zero = biguint128_ctor_default();
+ bool pass = true;
+ pass &= biguint128_eq(&max, &max_lit);
+ pass &= biguint128_eq(&pow10, &pow10_lit);
+ pass &= biguint128_eq(&hex, &hex_lit);
+ pass &= biguint128_eq(&zero, &zero_lit);
+ pass &= biguint128_eq(&pow10, &table_lit[0]) && biguint128_eq(&hex, &table_lit[1]) && biguint128_eqz(&table_lit[2]);
+ return pass;
+}
+
+bool test_int_literals() {
+ BigUInt128 neg = bigint128_ctor_deccstream(neg_str.str, neg_str.len);
+ BigUInt128 min = biguint128_ctor_hexcstream(min_str.str, min_str.len);
+ return biguint128_eq(&neg, &neg_lit) && biguint128_eq(&min, &min_lit);
+}
+
+bool test_decimal_literals() {
+ BigDecimal128 dec = bigdecimal128_ctor_cstream(dec_str.str, dec_str.len);
+ BigDecimal128 negdec = bigdecimal128_ctor_cstream(negdec_str.str, negdec_str.len);
+ return dec_eq_(&dec, &dec_lit) && dec_eq_(&negdec, &negdec_lit);
+}
+
+int main() {
+ assert(test_uint_literals());
+ assert(test_int_literals());
+ assert(test_decimal_literals());
+ return 0;
+}
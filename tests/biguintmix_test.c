@@ -0,0 +1,105 @@
+#include <stdio.h>
+#include <stdbool.h>
+#include <string.h>
+#include <assert.h>
+#include "biguint128.h"
+#include "biguint256.h"
+#include "biguintmix.h"
+#include "test_common.h"
+
+const CStr wide_in[] = {
+ STR("0"),
+ STR("1"),
+ STR("FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFF"),
+ STR("8000000000000000000000000000000000000000000000000000000000000000"),
+ STR("123456789ABCDEF0FEDCBA98765432100F1E2D3C4B5A69788796A5B4C3D2E1F0"),
+ STR("FEDCBA9876543210"),
+ STR("10000000000000000000000000000000F")
+};
+
+const CStr narrow_in[] = {
+ STR("0"),
+ STR("1"),
+ STR("FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFF"),
+ STR("80000000000000000000000000000001"),
+ STR("FEDCBA9876543210"),
+ STR("10000000000000000"),
+ STR("3")
+};
+
+#define WIDE_N ARRAYSIZE(wide_in)
+#define NARROW_N ARRAYSIZE(narrow_in)
+
+static bool eq256_(const char *fun, size_t ai, size_t bi, const BigUInt256 *expected, const BigUInt256 *actual) {
+ if (!biguint256_eq(expected, actual)) {
+  fprintf(stderr, "%s failed: a #%u, b #%u\n", fun, (unsigned int)ai, (unsigned int)bi);
+  return false;
+ }
+ return true;
+}
+
+bool test_widen_narrow() {
+ bool pass = true;
+ for (size_t i = 0; i < NARROW_N; ++i) {
+  BigUInt128 b = biguint128_ctor_hexcstream(narrow_in[i].str, narrow_in[i].len);
+  BigUInt256 bw = biguint128_widen_256(&b);
+  BigUInt256 expected = biguint256_ctor_hexcstream(narrow_in[i].str, narrow_in[i].len);
+  BigUInt128 bn = biguint256_narrow_128(&bw);
+  pass &= eq256_("biguint128_widen_256", 0, i, &expected, &bw);
+  pass &= biguint128_eq(&b, &bn);
+ }
+ // truncation
+ BigUInt256 a = biguint256_ctor_hexcstream(wide_in[4].str, wide_in[4].len);
+ BigUInt128 an = biguint256_narrow_128(&a);
+ BigUInt128 expected = biguint128_ctor_hexcstream(wide_in[4].str + 32, wide_in[4].len - 32);
+ pass &= biguint128_eq(&expected, &an);
+ return pass;
+}
+
+bool test_mixed_ops() {
+ bool pass = true;
+ for (size_t ai = 0; ai < WIDE_N; ++ai) {
+  BigUInt256 a = biguint256_ctor_hexcstream(wide_in[ai].str, wide_in[ai].len);
+  for (size_t bi = 0; bi < NARROW_N; ++bi) {
+   BigUInt128 b = biguint128_ctor_hexcstream(narrow_in[bi].str, narrow_in[bi].len);
+   BigUInt256 bw = biguint128_widen_256(&b);
+
+   BigUInt256 expected = biguint256_add(&a, &bw);
+   BigUInt256 actual = biguint256_add_128(&a, &b);
+   pass &= eq256_("biguint256_add_128", ai, bi, &expected, &actual);
+
+   expected = biguint256_sub(&a, &bw);
+   actual = biguint256_sub_128(&a, &b);
+   pass &= eq256_("biguint256_sub_128", ai, bi, &expected, &actual);
+
+   expected = biguint256_mul(&a, &bw);
+   actual = biguint256_mul_128(&a, &b);
+   pass &= eq256_("biguint256_mul_128", ai, bi, &expected, &actual);
+
+   BigUIntPair256 dexpected = biguint256_dmul(&a, &bw);
+   BigUIntPair256 dactual = biguint256_dmul_128(&a, &b);
+   pass &= eq256_("biguint256_dmul_128 (low)", ai, bi, &dexpected.first, &dactual.first);
+   pass &= eq256_("biguint256_dmul_128 (high)", ai, bi, &dexpected.second, &dactual.second);
+
+   BigUIntPair256_128 qr = biguint256_div_128(&a, &b);
+   BigUInt128 r = biguint256_mod_128(&a, &b);
+   BigUInt256 qrw = biguint128_widen_256(&qr.second);
+   if (biguint128_eqz(&b)) {
+    BigUInt128 an = biguint256_narrow_128(&a);
+    pass &= biguint256_eqz(&qr.first) && biguint128_eq(&an, &qr.second);
+   } else {
+    dexpected = biguint256_div(&a, &bw);
+    pass &= eq256_("biguint256_div_128 (quotient)", ai, bi, &dexpected.first, &qr.first);
+    pass &= eq256_("biguint256_div_128 (remainder)", ai, bi, &dexpected.second, &qrw);
+   }
+   pass &= biguint128_eq(&qr.second, &r);
+  }
+ }
+ return pass;
+}
+
+int main() {
+ assert(test_widen_narrow());
+ assert(test_mixed_ops());
+ return 0;
+}
@@ -0,0 +1,307 @@
+#include <stdio.h>
+#include <stdbool.h>
+#include <string.h>
+#include <assert.h>
+#include "biguintn.h"
+#include "test_common.h"
+
+#define MAX_CELLS 300U
+#define BUFLEN (MAX_CELLS * 20U + 2U)
+
+UInt fa[MAX_CELLS];
+UInt fb[MAX_CELLS];
+UInt expected[2 * MAX_CELLS];
+UInt actual[2 * MAX_CELLS];
+UInt rem[2 * MAX_CELLS];
+UInt scratch[BIGUINTN_MUL_SCRATCH(MAX_CELLS, MAX_CELLS)];
+char buf[BUFLEN];
+
+// 2^256-1
+const CStr max256_hex = STR("FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFF");
+const CStr max256_dec = STR("115792089237316195423570985008687907853269984665640564039457584007913129639935");
+// 10^40
+const CStr pow40_hex = STR("1D6329F1C35CA4BFABB9F5610000000000");
+const CStr pow40_dec = STR("10000000000000000000000000000000000000000");
+
+bool test_mul() {
+ const buint_size_t sizes[][2] = {
+  {0, 3}, {1, 1}, {5, 3}, {31, 32}, {32, 32}, {40, 33}, {33, 100}, {75, 40}, {200, 64}, {65, 64}, {MAX_CELLS, 33}, {MAX_CELLS, MAX_CELLS}
+ };
+ bool pass = true;
+ for (unsigned int i = 0; i < ARRAYSIZE(sizes); ++i) {
+  buint_size_t na = sizes[i][0];
+  buint_size_t nb = sizes[i][1];
+  for (unsigned int k = 0; k < 2; ++k) {
+   if (k == 0) {
+    fill_random(fa, na);
+    fill_random(fb, nb);
+   } else {
+    memset(fa, 0xFF, na * sizeof(UInt));
+    memset(fb, 0xFF, nb * sizeof(UInt));
+   }
+   mul_ref(expected, fa, na, fb, nb, na + nb);
+   biguintn_mul(actual, fa, na, fb, nb, scratch);
+   if (memcmp(expected, actual, (na + nb) * sizeof(UInt)) != 0) {
+    fprintf(stderr, "biguintn_mul failed: %" PRIbuint_size_t " x %" PRIbuint_size_t " cells\n", na, nb);
+    pass = false;
+   }
+   for (buint_size_t n = na / 2; n <= na + nb; n += (na + nb) / 2 + 1) {
+    biguintn_mul_low(actual, fa, na, fb, nb, n);
+    if (memcmp(expected, actual, n * sizeof(UInt)) != 0) {
+     fprintf(stderr, "biguintn_mul_low failed: %" PRIbuint_size_t " x %" PRIbuint_size_t " cells, %" PRIbuint_size_t " result cells\n", na, nb, n);
+     pass = false;
+    }
+   }
+   mul_ref(expected, fa, na, fa, na, 2 * na);
+   biguintn_sqr(actual, fa, na, scratch);
+   if (memcmp(expected, actual, 2 * na * sizeof(UInt)) != 0) {
+    fprintf(stderr, "biguintn_sqr failed: %" PRIbuint_size_t " cells\n", na);
+    pass = false;
+   }
+  }
+ }
+ return pass;
+}
+
+/**
+ * Checks q * b + r == a and r < b.
+ */
+static bool check_div_(const UInt *a, buint_size_t na, const UInt *b, buint_size_t nb) {
+ UInt q[MAX_CELLS];
+ UInt r[MAX_CELLS];
+ UInt div_scratch[BIGUINTN_DIV_SCRATCH(MAX_CELLS, MAX_CELLS)];
+ bool pass = biguintn_div(q, r, a, na, b, nb, div_scratch) != 0;
+ biguintn_mul(actual, q, na, b, nb, scratch);
+ pass &= biguintn_add(actual, actual, na + nb, r, nb) == 0;
+ pass &= biguintn_eq(actual, na + nb, a, na);
+ pass &= biguintn_lt(r, nb, b, nb);
+ // remainder only
+ memset(rem, 0xAA, nb * sizeof(UInt));
+ pass &= biguintn_div(NULL, rem, a, na, b, nb, div_scratch) != 0;
+ pass &= memcmp(rem, r, nb * sizeof(UInt)) == 0;
+ if (!pass) {
+  fprintf(stderr, "biguintn_div failed: %" PRIbuint_size_t " / %" PRIbuint_size_t " cells\n", na, nb);
+ }
+ return pass;
+}
+
+bool test_div() {
+ const buint_size_t sizes[][2] = {
+  {1, 1}, {5, 1}, {5, 2}, {2, 5}, {40, 33}, {100, 3}, {MAX_CELLS, 77}
+ };
+ bool pass = true;
+ for (unsigned int i = 0; i < ARRAYSIZE(sizes); ++i) {
+  buint_size_t na = sizes[i][0];
+  buint_size_t nb = sizes[i][1];
+  fill_random(fa, na);
+  fill_random(fb, nb);
+  pass &= check_div_(fa, na, fb, nb);
+  // short divisor in a long array
+  if (1 < nb) {
+   fb[nb - 1] = 0;
+   pass &= check_div_(fa, na, fb, nb);
+  }
+  // the divisor has its most significant bit set
+  fb[nb - 1] = (UInt)-1;
+  pass &= check_div_(fa, na, fb, nb);
+ }
+ // division by 0
+ memset(fb, 0, sizeof(fb));
+ pass &= biguintn_div(actual, rem, fa, 5, fb, 3, scratch) == 0;
+ return pass;
+}
+
+bool test_div_uint() {
+ const UInt divs[] = {1, 3, 10, 1000, (UInt)-1, ((UInt)1 << (8 * sizeof(UInt) - 1)) + 1};
+ bool pass = true;
+ fill_random(fa, 50);
+ for (unsigned int i = 0; i < ARRAYSIZE(divs); ++i) {
+  UInt q[50];
+  UInt r = biguintn_div_uint(q, fa, 50, divs[i]);
+  bool ok = r < divs[i];
+  memcpy(actual, q, sizeof(q));
+  ok &= biguintn_muladd_uint(actual, 50, divs[i], r) == 0;
+  ok &= memcmp(actual, fa, sizeof(q)) == 0;
+  // in place, and without quotient
+  memcpy(actual, fa, sizeof(q));
+  ok &= biguintn_div_uint(actual, actual, 50, divs[i]) == r;
+  ok &= memcmp(actual, q, sizeof(q)) == 0;
+  ok &= biguintn_div_uint(NULL, fa, 50, divs[i]) == r;
+  if (!ok) {
+   fprintf(stderr, "biguintn_div_uint failed: divisor #%u\n", i);
+   pass = false;
+  }
+ }
+ // division by 0
+ pass &= biguintn_div_uint(actual, fa, 50, 0) == fa[0];
+ pass &= biguintn_eqz(actual, 50);
+ return pass;
+}
+
+bool test_add_sub() {
+ bool pass = true;
+ fill_random(fa, 40);
+ fill_random(fb, 20);
+ UInt carry = biguintn_add(actual, fa, 40, fb, 20);
+ pass &= biguintn_sub(actual, actual, 40, fb, 20) == carry;
+ pass &= memcmp(actual, fa, 40 * sizeof(UInt)) == 0;
+ // carry through all the cells
+ memset(fa, 0xFF, 40 * sizeof(UInt));
+ pass &= biguintn_add_uint(actual, fa, 40, 1) == 1;
+ pass &= biguintn_eqz(actual, 40);
+ pass &= biguintn_sub_uint(actual, actual, 40, 1) == 1;
+ pass &= memcmp(actual, fa, 40 * sizeof(UInt)) == 0;
+ pass &= biguintn_add(actual, fa, 40, fa, 1) == 1;
+ pass &= actual[0] == (UInt)-2 && actual[39] == 0;
+ return pass;
+}
+
+bool test_shift_rel() {
+ bool pass = true;
+ const buint_size_t n = 10;
+ const buint_size_t bits = n * 8 * sizeof(UInt);
+ const buint_size_t shifts[] = {0, 1, 8 * sizeof(UInt), 8 * sizeof(UInt) + 7, bits - 1, bits, bits + 3};
+ for (unsigned int i = 0; i < ARRAYSIZE(shifts); ++i) {
+  memset(fa, 0xFF, n * sizeof(UInt));
+  biguintn_shl(actual, fa, n, shifts[i]);
+  biguintn_shr(actual, actual, n, shifts[i]);
+  biguintn_shr(expected, fa, n, shifts[i]);
+  pass &= memcmp(actual, expected, n * sizeof(UInt)) == 0;
+  pass &= shifts[i] < bits || biguintn_eqz(actual, n);
+ }
+ // relations of different lengths
+ memset(fa, 0, 10 * sizeof(UInt));
+ memset(fb, 0, 10 * sizeof(UInt));
+ fa[0] = 5;
+ fb[0] = 5;
+ pass &= biguintn_eq(fa, 10, fb, 1) && biguintn_eq(fa, 1, fb, 10);
+ pass &= !biguintn_lt(fa, 10, fb, 1) && !biguintn_lt(fa, 1, fb, 10);
+ fb[3] = 1;
+ pass &= !biguintn_eq(fa, 10, fb, 10) && biguintn_lt(fa, 10, fb, 10) && !biguintn_lt(fb, 10, fa, 1);
+ pass &= biguintn_lzc(fb, 10) == 4 && biguintn_lzc(fa, 10) == 1 && biguintn_lzc(fb, 0) == 0;
+ return pass;
+}
+
+static bool check_io_(const CStr *hex, const CStr *dec, buint_size_t n, bool fits) {
+ bool pass = true;
+ UInt a[MAX_CELLS];
+ UInt b[MAX_CELLS];
+ pass &= biguintn_ctor_hexcstream(a, n, hex->str, hex->len) == !fits;
+ pass &= biguintn_ctor_deccstream(b, n, dec->str, dec->len) == !fits;
+ pass &= biguintn_eq(a, n, b, n);
+ if (fits) {
+  buint_size_t len = biguintn_print_hex(a, n, buf, BUFLEN);
+  buf[len] = 0;
+  pass &= check_cstr("biguintn_print_hex", hex, len, buf);
+  len = biguintn_print_dec(a, n, buf, BUFLEN, b);
+  buf[len] = 0;
+  pass &= check_cstr("biguintn_print_dec", dec, len, buf);
+  // the buffer is too short
+  pass &= biguintn_print_dec(a, n, buf, dec->len - 1, b) == 0;
+  pass &= biguintn_print_hex(a, n, buf, hex->len - 1) == 0;
+  // any base
+  pass &= biguintn_ctor_basecstream(b, n, 10, dec->str, dec->len) == 0;
+  len = biguintn_print_base(b, n, 10, 0, buf, BUFLEN, scratch);
+  buf[len] = 0;
+  pass &= biguintn_eq(a, n, b, n) && check_cstr("biguintn_print_base", dec, len, buf);
+  len = biguintn_print_base(a, n, 16, 0, buf, BUFLEN, scratch);
+  pass &= len == hex->len && biguintn_ctor_hexcstream(b, n, buf, len) == 0 && biguintn_eq(a, n, b, n);
+  pass &= biguintn_print_base(a, n, 16, 0, buf, hex->len - 1, scratch) == 0;
+ } else {
+  pass &= biguintn_ctor_basecstream(b, n, 10, dec->str, dec->len) != 0;
+ }
+ return pass;
+}
+
+static bool check_print_base_(const char *expected, const UInt *a, buint_size_t n, unsigned int base, buint_size_t point) {
+ buint_size_t len = biguintn_print_base(a, n, base, point, buf, BUFLEN, scratch);
+ buf[len] = 0;
+ if (strcmp(expected, buf) != 0) {
+  fprintf(stderr, "biguintn_print_base (base %u, point %u) failed: expected %s, actual %s\n", base, (unsigned int)point, expected, buf);
+  return false;
+ }
+ return true;
+}
+
+bool test_base() {
+ const buint_size_t n = 40;
+ bool pass = true;
+ fa[0] = 255;
+ pass &= check_print_base_("11111111", fa, 1, 2, 0);
+ pass &= check_print_base_("73", fa, 1, 36, 0);
+ pass &= check_print_base_("2.55", fa, 1, 10, 2);
+ pass &= check_print_base_("0.255", fa, 1, 10, 3);
+ pass &= check_print_base_("0.00255", fa, 1, 10, 5);
+ pass &= check_print_base_("0", fa, 0, 7, 0);
+ pass &= check_print_base_("0.0", fa, 0, 10, 1);
+ pass &= biguintn_print_base(fa, 1, 1, 0, buf, BUFLEN, scratch) == 0;
+ pass &= biguintn_print_base(fa, 1, 37, 0, buf, BUFLEN, scratch) == 0;
+ pass &= biguintn_print_base(fa, 1, 10, 3, buf, 4, scratch) == 0;
+ pass &= biguintn_ctor_basecstream(fb, 1, 16, "fF", 2) == 0 && fb[0] == 255;
+ // round trip of long random values
+ for (unsigned int base = 2; base <= 36; ++base) {
+  fill_random(fa, n);
+  buint_size_t len = biguintn_print_base(fa, n, base, 0, buf, BUFLEN, scratch);
+  pass &= len != 0 && buf[0] != '0';
+  pass &= biguintn_ctor_basecstream(fb, n, base, buf, len) == 0;
+  pass &= biguintn_eq(fa, n, fb, n);
+  pass &= biguintn_ctor_basecstream(fb, n - 1, base, buf, len) != 0;
+  if (!pass) {
+   fprintf(stderr, "biguintn_print_base / biguintn_ctor_basecstream failed: base %u\n", base);
+   return false;
+  }
+ }
+ return pass;
+}
+
+bool test_io() {
+ const CStr zero = STR("0");
+ const buint_size_t cells256 = 256 / (8 * sizeof(UInt));
+ const buint_size_t cells133 = (133 + 8 * sizeof(UInt) - 1) / (8 * sizeof(UInt)); // 10^40 is 133 bits long
+ bool pass = true;
+ pass &= check_io_(&zero, &zero, 3, true);
+ pass &= check_io_(&max256_hex, &max256_dec, cells256, true);
+ pass &= check_io_(&max256_hex, &max256_dec, cells256 + 3, true);
+ pass &= check_io_(&max256_hex, &max256_dec, cells256 - 1, false);
+ pass &= check_io_(&pow40_hex, &pow40_dec, cells133, true);
+ pass &= check_io_(&pow40_hex, &pow40_dec, cells133 - 1, false);
+ // round trip of long random values
+ fill_random(fa, MAX_CELLS);
+ buint_size_t len = biguintn_print_dec(fa, MAX_CELLS, buf, BUFLEN, actual);
+ pass &= len != 0;
+ pass &= biguintn_ctor_deccstream(fb, MAX_CELLS, buf, len) == 0;
+ pass &= biguintn_eq(fa, MAX_CELLS, fb, MAX_CELLS);
+ len = biguintn_print_hex(fa, MAX_CELLS, buf, BUFLEN);
+ pass &= biguintn_ctor_hexcstream(fb, MAX_CELLS, buf, len) == 0;
+ pass &= biguintn_eq(fa, MAX_CELLS, fb, MAX_CELLS);
+ return pass;
+}
+
+/**
+ * BIGUINTN_DEC_DIGITS(n) against the printed length of the largest value of n cells.
+ */
+bool test_dec_digits() {
+ bool pass = true;
+ for (buint_size_t n = 1; n <= MAX_CELLS; ++n) {
+  memset(fa, 0xFF, n * sizeof(UInt));
+  buint_size_t len = biguintn_print_dec(fa, n, buf, BUFLEN, actual);
+  if (len == 0 || BIGUINTN_DEC_DIGITS(n) < len || len + 2 < BIGUINTN_DEC_DIGITS(n)) {
+   fprintf(stderr, "BIGUINTN_DEC_DIGITS(%" PRIbuint_size_t ") = %" PRIbuint_size_t ", printed length: %" PRIbuint_size_t "\n",
+    n, (buint_size_t)BIGUINTN_DEC_DIGITS(n), len);
+   pass = false;
+  }
+ }
+ return pass;
+}
+
+int main() {
+ assert(test_mul());
+ assert(test_div());
+ assert(test_div_uint());
+ assert(test_add_sub());
+ assert(test_shift_rel());
+ assert(test_io());
+ assert(test_base());
+ assert(test_dec_digits());
+ return 0;
+}
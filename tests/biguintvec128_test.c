@@ -0,0 +1,161 @@
+#include <stdio.h>
+#include <stdbool.h>
+#include <string.h>
+#include <assert.h>
+#include "biguintvec128.h"
+#include "vec_kernel.h"
+#include "test_common.h"
+
+#define MAX_LEN 41U
+
+BigUInt128 va[MAX_LEN];
+BigUInt128 vb[MAX_LEN];
+BigUInt128 vr[MAX_LEN];
+UInt sa[BIGUINTVEC128_SIZE(MAX_LEN)];
+UInt sb[BIGUINTVEC128_SIZE(MAX_LEN)];
+UInt sr[BIGUINTVEC128_SIZE(MAX_LEN)];
+buint_bool res[MAX_LEN];
+
+/**
+ * Operands exercising the carry and borrow propagation:
+ * equal values, values differing only in the lowest cell, all ones, and random values.
+ */
+static void init_operands_(buint_size_t len) {
+ for (buint_size_t k = 0; k < len; ++k) {
+  fill_random(va[k].dat, BIGUINT128_CELLS);
+  fill_random(vb[k].dat, BIGUINT128_CELLS);
+  switch (k % 5) {
+   case 0: vb[k] = va[k]; break;
+   case 1: memcpy(vb[k].dat + 1, va[k].dat + 1, (BIGUINT128_CELLS - 1) * sizeof(UInt)); break;
+   case 2: memset(va[k].dat, 0xFF, sizeof(va[k].dat)); vb[k].dat[0] |= 1u; break;
+   case 3: memset(vb[k].dat, 0xFF, sizeof(vb[k].dat)); break;
+  }
+ }
+}
+
+static bool check_vec_(const BigUIntVec128 *v, const BigUInt128 *expected, const char *op, buint_size_t len) {
+ for (buint_size_t k = 0; k < len; ++k) {
+  BigUInt128 x = biguintvec128_get(v, k);
+  if (!biguint128_eq(&x, &expected[k])) {
+   fprintf(stderr, "%s failed: kernel %s, length %u, element %u\n", op, vec_kernel_name(vec_kernel_active), (unsigned int)len, (unsigned int)k);
+   return false;
+  }
+ }
+ return true;
+}
+
+static bool check_res_(buint_bool (*ref)(const BigUInt128 *, const BigUInt128 *), const char *op, buint_size_t len) {
+ for (buint_size_t k = 0; k < len; ++k) {
+  if (res[k] != ref(&va[k], &vb[k])) {
+   fprintf(stderr, "%s failed: kernel %s, length %u, element %u\n", op, vec_kernel_name(vec_kernel_active), (unsigned int)len, (unsigned int)k);
+   return false;
+  }
+ }
+ return true;
+}
+
+bool test_kernel_selection() {
+ bool pass = true;
+ VecKernel loaded = vec_kernel_active;
+ pass &= loaded != VEC_KERNEL_AUTO;
+ pass &= vec_kernel_supported(VEC_KERNEL_GENERIC);
+ pass &= vec_kernel_supported(loaded);
+ pass &= vec_kernel_set(VEC_KERNEL_GENERIC) && vec_kernel_active == VEC_KERNEL_GENERIC;
+ pass &= vec_kernel_set(VEC_KERNEL_AUTO) && vec_kernel_active == loaded;
+ if (!vec_kernel_supported(VEC_KERNEL_AVX2)) {
+  pass &= !vec_kernel_set(VEC_KERNEL_AVX2) && vec_kernel_active == loaded;
+ }
+ if (!pass) fprintf(stderr, "kernel selection failed\n");
+ return pass;
+}
+
+bool test_gather_scatter() {
+ bool pass = true;
+ for (buint_size_t len = 0; len <= MAX_LEN; ++len) {
+  init_operands_(len);
+  BigUIntVec128 a = biguintvec128_ctor(sa, len);
+  biguintvec128_gather(&a, va);
+  pass &= check_vec_(&a, va, "gather", len);
+  biguintvec128_scatter(&a, vr);
+  pass &= memcmp(va, vr, len * sizeof(BigUInt128)) == 0;
+  if (len != 0) {
+   biguintvec128_set(&a, len - 1, &vb[0]);
+   BigUInt128 x = biguintvec128_get(&a, len - 1);
+   pass &= biguint128_eq(&x, &vb[0]);
+   BigUInt128 y = biguintvec128_get(&a, 0);
+   pass &= len == 1 || biguint128_eq(&y, &va[0]);
+  }
+ }
+ if (!pass) fprintf(stderr, "gather / scatter failed\n");
+ return pass;
+}
+
+/**
+ * Elementwise operations of all kernels, against the BigUInt128 functions.
+ */
+static bool test_kernel_(VecKernel kernel) {
+ bool pass = true;
+ if (!vec_kernel_set(kernel)) {
+  fprintf(stderr, "%s kernel not supported by the CPU, not tested\n", vec_kernel_name(kernel));
+  return true;
+ }
+ for (buint_size_t len = 0; len <= MAX_LEN; ++len) {
+  init_operands_(len);
+  BigUIntVec128 a = biguintvec128_ctor(sa, len);
+  BigUIntVec128 b = biguintvec128_ctor(sb, len);
+  BigUIntVec128 r = biguintvec128_ctor(sr, len);
+  biguintvec128_gather(&a, va);
+  biguintvec128_gather(&b, vb);
+
+#define CHECK_BINARY_(OP, REF) \
+  biguintvec128_##OP(&r, &a, &b); \
+  for (buint_size_t k = 0; k < len; ++k) vr[k] = REF; \
+  pass &= check_vec_(&r, vr, #OP, len);
+
+  CHECK_BINARY_(add, biguint128_add(&va[k], &vb[k]))
+  CHECK_BINARY_(sub, biguint128_sub(&va[k], &vb[k]))
+  CHECK_BINARY_(min, biguint128_lt(&va[k], &vb[k]) ? va[k] : vb[k])
+  CHECK_BINARY_(max, biguint128_lt(&va[k], &vb[k]) ? vb[k] : va[k])
+  CHECK_BINARY_(and, biguint128_and(&va[k], &vb[k]))
+  CHECK_BINARY_(or, biguint128_or(&va[k], &vb[k]))
+  CHECK_BINARY_(xor, biguint128_xor(&va[k], &vb[k]))
+#undef CHECK_BINARY_
+
+  biguintvec128_not(&r, &a);
+  for (buint_size_t k = 0; k < len; ++k) vr[k] = biguint128_not(&va[k]);
+  pass &= check_vec_(&r, vr, "not", len);
+
+  biguintvec128_lt(res, &a, &b);
+  pass &= check_res_(biguint128_lt, "lt", len);
+  biguintvec128_lt(res, &b, &a);
+  for (buint_size_t k = 0; k < len; ++k) pass &= res[k] == biguint128_lt(&vb[k], &va[k]);
+  biguintvec128_eq(res, &a, &b);
+  pass &= check_res_(biguint128_eq, "eq", len);
+
+  // output same as input
+  biguintvec128_max(&a, &a, &b);
+  for (buint_size_t k = 0; k < len; ++k) vr[k] = biguint128_lt(&va[k], &vb[k]) ? vb[k] : va[k];
+  pass &= check_vec_(&a, vr, "max (in place)", len);
+  biguintvec128_gather(&a, va);
+  biguintvec128_add(&b, &a, &b);
+  for (buint_size_t k = 0; k < len; ++k) vr[k] = biguint128_add(&va[k], &vb[k]);
+  pass &= check_vec_(&b, vr, "add (in place)", len);
+ }
+ vec_kernel_set(VEC_KERNEL_AUTO);
+ return pass;
+}
+
+bool test_kernels() {
+ bool pass = true;
+ pass &= test_kernel_(VEC_KERNEL_GENERIC);
+ pass &= test_kernel_(VEC_KERNEL_SSE2);
+ pass &= test_kernel_(VEC_KERNEL_AVX2);
+ return pass;
+}
+
+int main() {
+ assert(test_kernel_selection());
+ assert(test_gather_scatter());
+ assert(test_kernels());
+ return 0;
+}
@@ -0,0 +1,174 @@
+#include <stdio.h>
+#include <stdbool.h>
+#include <string.h>
+#include <assert.h>
+#include "biguintn.h"
+#include "cells.h"
+#include "test_common.h"
+
+#define MAX_CELLS 260U
+#define KCELLS BIGUINTN_KARATSUBA_CELLS
+
+UInt fa[MAX_CELLS];
+UInt fb[MAX_CELLS];
+UInt expected[2 * MAX_CELLS];
+UInt actual[2 * MAX_CELLS];
+UInt scratch[BIGUINTN_MUL_SCRATCH(MAX_CELLS, MAX_CELLS) + CELLS_KARATSUBA_SCRATCH(MAX_CELLS)];
+
+static bool check_product_(const char *op, buint_size_t na, buint_size_t nb, buint_size_t ncols) {
+ if (memcmp(expected, actual, ncols * sizeof(UInt)) != 0) {
+  fprintf(stderr, "%s failed: %" PRIbuint_size_t " x %" PRIbuint_size_t " cells\n", op, na, nb);
+  return false;
+ }
+ return true;
+}
+
+static UInt get_bit_(const UInt *a, buint_size_t n, buint_size_t bit) {
+ return bit < n * 8u * sizeof(UInt) ? (a[bit / (8u * sizeof(UInt))] >> (bit % (8u * sizeof(UInt)))) & 1u : 0u;
+}
+
+/**
+ * Reference shift (bit by bit): r = a << shift (left) or a >> shift.
+ */
+static void shift_ref_(UInt *r, const UInt *a, buint_size_t n, buint_size_t shift, bool left) {
+ memset(r, 0, n * sizeof(UInt));
+ for (buint_size_t bit = 0; bit < n * 8u * sizeof(UInt); ++bit) {
+  UInt x = left ? (bit < shift ? 0u : get_bit_(a, n, bit - shift)) : get_bit_(a, n, bit + shift);
+  r[bit / (8u * sizeof(UInt))] |= x << (bit % (8u * sizeof(UInt)));
+ }
+}
+
+/**
+ * Straight-line kernels of constant length N (as the BigUInt types call them)
+ * against plain reference loops: addition and subtraction with comparison based carries,
+ * relations cell by cell, and bit-by-bit shifts.
+ * From CELLS_STRAIGHT_DEFAULT + 1 cells, the straight-line head is followed by the loop.
+ */
+#define CHECK_STRAIGHT_(N) do { \
+  const buint_size_t n = (N); \
+  bool ok = true; \
+  fill_random(fa, n); \
+  fill_random(fb, n); \
+  if (n % 3 == 0) memset(fa, 0xFF, n * sizeof(UInt));	/* carry / borrow through all cells */ \
+  if (n % 4 == 0) memcpy(fb, fa, (n - 1) * sizeof(UInt));	/* differ only in the highest cell */ \
+  for (unsigned int c0 = 0; c0 < 2; ++c0) { \
+   UInt c = c0; \
+   for (buint_size_t i = 0; i < n; ++i) { \
+    UInt s = fa[i] + fb[i]; \
+    UInt t = s + c; \
+    c = (s < fa[i]) | (t < s); \
+    expected[i] = t; \
+   } \
+   expected[n] = c; \
+   actual[n] = cells_adc(actual, fa, fb, (N), CELLS_STRAIGHT_DEFAULT, c0 != 0); \
+   ok &= memcmp(expected, actual, (n + 1) * sizeof(UInt)) == 0; \
+   c = c0; \
+   for (buint_size_t i = 0; i < n; ++i) { \
+    UInt d = fa[i] - fb[i]; \
+    UInt t = d - c; \
+    c = (fa[i] < fb[i]) | (d < c); \
+    expected[i] = t; \
+   } \
+   expected[n] = c; \
+   memcpy(actual, fa, n * sizeof(UInt)); \
+   actual[n] = cells_sbb(actual, actual, fb, (N), CELLS_STRAIGHT_DEFAULT, c0 != 0);	/* in place */ \
+   ok &= memcmp(expected, actual, (n + 1) * sizeof(UInt)) == 0; \
+  } \
+  buint_bool lt = 0, eq = 1; \
+  for (buint_size_t i = n; 0 < i--;) { \
+   if (fa[i] != fb[i]) { lt = fa[i] < fb[i]; eq = 0; break; } \
+  } \
+  ok &= cells_lt(fa, fb, (N), CELLS_STRAIGHT_DEFAULT) == lt; \
+  ok &= cells_eq(fa, fb, (N), CELLS_STRAIGHT_DEFAULT) == eq; \
+  ok &= cells_eq(fa, fa, (N), CELLS_STRAIGHT_DEFAULT) && !cells_lt(fa, fa, (N), CELLS_STRAIGHT_DEFAULT); \
+  const buint_size_t shifts[] = {0, 1, 8u * sizeof(UInt) - 1, 8u * sizeof(UInt), 8u * sizeof(UInt) + 3, \
+   n * 8u * sizeof(UInt) / 2 + 1, n * 8u * sizeof(UInt) - 1, n * 8u * sizeof(UInt), (n + 1) * 8u * sizeof(UInt)}; \
+  for (unsigned int j = 0; j < ARRAYSIZE(shifts); ++j) { \
+   shift_ref_(expected, fa, n, shifts[j], true); \
+   cells_shl(actual, fa, (N), CELLS_STRAIGHT_DEFAULT, shifts[j]); \
+   ok &= memcmp(expected, actual, n * sizeof(UInt)) == 0; \
+   shift_ref_(expected, fa, n, shifts[j], false); \
+   memcpy(actual, fa, n * sizeof(UInt)); \
+   cells_shr(actual, actual, (N), CELLS_STRAIGHT_DEFAULT, shifts[j]);	/* in place */ \
+   ok &= memcmp(expected, actual, n * sizeof(UInt)) == 0; \
+  } \
+  if (!ok) fprintf(stderr, "straight-line kernels failed: %" PRIbuint_size_t " cells\n", n); \
+  pass &= ok; \
+ } while (0);
+
+bool test_straight() {
+ bool pass = true;
+ CELLS_REP16_(CHECK_STRAIGHT_, 1u)
+ CELLS_REP4_(CHECK_STRAIGHT_, 17u)
+ return pass;
+}
+
+/**
+ * Karatsuba multiplication and squaring against the schoolbook (column) method,
+ * at, just above and well above the cutoff.
+ * The unbalanced products have a second factor padded with zero cells.
+ */
+bool test_karatsuba() {
+ bool pass = true;
+ const buint_size_t lengths[] = {KCELLS, KCELLS + 1, KCELLS + 15, 2 * KCELLS, 2 * KCELLS + 1, 4 * KCELLS + 3, MAX_CELLS};
+ for (unsigned int l = 0; l < ARRAYSIZE(lengths); ++l) {
+  const buint_size_t n = lengths[l];
+  const buint_size_t nbs[] = {n, n - 1, n / 2 + 1, KCELLS, 1};
+  for (unsigned int j = 0; j < ARRAYSIZE(nbs); ++j) {
+   const buint_size_t nb = nbs[j];
+   fill_random(fa, n);
+   fill_random(fb, nb);
+   memset(fb + nb, 0, (n - nb) * sizeof(UInt));
+   cells_mul_cols(expected, fa, n, fb, nb, 2 * n);
+   cells_kara_mul(actual, fa, fb, n, scratch, KCELLS);
+   pass &= check_product_("cells_kara_mul", n, nb, 2 * n);
+  }
+  for (unsigned int k = 0; k < 2; ++k) {
+   if (k == 0) {
+    fill_random(fa, n);
+   } else {
+    memset(fa, 0xFF, n * sizeof(UInt));	// maximal carries in the combination step
+   }
+   cells_sqr_cols(expected, fa, n, 2 * n);
+   cells_kara_sqr(actual, fa, n, scratch, KCELLS);
+   pass &= check_product_("cells_kara_sqr", n, n, 2 * n);
+   cells_mul_cols(expected, fa, n, fa, n, 2 * n);
+   cells_kara_mul(actual, fa, fa, n, scratch, KCELLS);
+   pass &= check_product_("cells_kara_mul", n, n, 2 * n);
+  }
+ }
+ return pass;
+}
+
+/**
+ * Unbalanced products of biguintn_mul() (the long factor is processed in slices of the short one).
+ */
+bool test_biguintn_karatsuba() {
+ bool pass = true;
+ const buint_size_t sizes[][2] = {
+  {KCELLS, KCELLS}, {KCELLS + 1, KCELLS}, {3 * KCELLS + 5, KCELLS}, {MAX_CELLS, KCELLS + 1},
+  {MAX_CELLS, 2 * KCELLS + 7}, {2 * KCELLS + 1, 2 * KCELLS}, {MAX_CELLS, MAX_CELLS}
+ };
+ for (unsigned int l = 0; l < ARRAYSIZE(sizes); ++l) {
+  const buint_size_t na = sizes[l][0];
+  const buint_size_t nb = sizes[l][1];
+  fill_random(fa, na);
+  fill_random(fb, nb);
+  cells_mul_cols(expected, fa, na, fb, nb, na + nb);
+  biguintn_mul(actual, fa, na, fb, nb, scratch);
+  pass &= check_product_("biguintn_mul", na, nb, na + nb);
+  biguintn_mul(actual, fb, nb, fa, na, scratch);
+  pass &= check_product_("biguintn_mul (swapped)", nb, na, na + nb);
+  cells_sqr_cols(expected, fa, na, 2 * na);
+  biguintn_sqr(actual, fa, na, scratch);
+  pass &= check_product_("biguintn_sqr", na, na, 2 * na);
+ }
+ return pass;
+}
+
+int main() {
+ assert(test_straight());
+ assert(test_karatsuba());
+ assert(test_biguintn_karatsuba());
+ return 0;
+}
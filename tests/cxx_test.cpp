@@ -0,0 +1,276 @@
+#include <cstdio>
+#include <cstring>
+#include <string_view>
+#include <cassert>
+
+extern "C" {
+#include "biguint128.h"
+#if __has_include("biguint256.h")
+#include "biguint256.h"
+#endif
+#include "test_common.h"
+}
+#include "biguint.hpp"
+
+using biguint::Cell;
+using U128 = biguint::UInt<128>;
+using U192 = biguint::UInt<192>;
+using U256 = biguint::UInt<256>;
+
+// ### Constant expressions (evaluated by the compiler)
+constexpr U128 max128 = U128(-1);
+constexpr U128 max64 = U128(0xFFFFFFFFFFFFFFFFull);
+static_assert(max128 + 1 == 0, "overflow of addition");
+static_assert(U128(0) - 1 == max128, "underflow of subtraction");
+static_assert(max64 + 1 == U128(1) << 64, "carry over cells");
+static_assert(max64 * max64 == -(U128(1) << 65) + 1, "(2^64-1)^2 = 2^128-2^65+1");
+static_assert(max128 * max128 == 1, "(2^128-1)^2 = 1 (mod 2^128)");
+static_assert((U128(1) << 127) >> 127 == 1, "shift over the whole width");
+static_assert((U128(1) << 128) == 0 && (max128 >> 128) == 0, "shift out");
+static_assert((max128 >> 64) == max64 && (max128 << 64 >> 64) == max64, "cell-aligned shift");
+static_assert(U128(1) < max64 && max64 < max128 && !(max128 < max128) && max128 <= max128, "relations");
+static_assert(((max128 & max64) | (U128(1) << 100)) == (max64 ^ (U128(1) << 100)), "bitwise operations");
+static_assert(~max64 == max128 << 64, "bitwise not");
+static_assert(max64 * max64 + (U128(1) << 65) == 1 && (U128(1) << 65) + max64 * max64 == 1, "multiply-add");
+static_assert(U128(1) - max64 * max64 == U128(1) << 65 && max128 - max128 * max128 == max128 - 1, "multiply-subtract");
+static_assert(((max64 << 64) | max64) == max128 && (U128(0x5A) | (U128(0xA5) << 120)) == (U128(0xA5) << 120) + 0x5A, "shift-or");
+static_assert(max64 * max64 * max64 == max64 * (max64 * max64) && U128(3) * 5 + 7 * U128(2) == 29, "chained expressions");
+static_assert(std::is_same<decltype((max64 + 1) * max64), U128>::value && std::is_same<decltype(max64 * U128(3)), U128>::value
+ && std::is_same<decltype((max64 + 1) << 3), U128>::value, "temporary operands are evaluated");
+static_assert(!std::is_copy_constructible<biguint::MulExpr<U128>>::value && !std::is_copy_constructible<biguint::ShlExpr<U128>>::value, "expression objects are not copyable");
+
+constexpr U128 num = U128(0x123456789ABCDEFull) << 70 | 12345u;
+constexpr U128 den = U128(0xFEDCBA987ull);
+static_assert((num / den) * den + num % den == num && num % den < den, "division identity");
+static_assert(max128 / max64 == max64 + 2 && max128 % max64 == 0, "(2^128-1)/(2^64-1) = 2^64+1");
+static_assert(U128(5) / 0 == 0 && U128(5) % 0 == 5, "division by zero");
+static_assert(U192(max128) + 1 == U192(1) << 128 && U128(U192(-1)) == max128, "width conversions");
+static_assert(U256(-1) * U256(-1) == 1 && U256(-1) / U256(max128) == U256(max128) + 2, "wider types");
+#if defined(__SIZEOF_INT128__) && !defined(__STRICT_ANSI__)
+constexpr unsigned __int128 big128 = (unsigned __int128)0x0123456789ABCDEFull << 64 | 0xFEDCBA9876543210ull;
+static_assert(U128(big128) == (U128(0x0123456789ABCDEFull) << 64 | 0xFEDCBA9876543210ull) && U192(~(unsigned __int128)0) == U192(max128), "conversion from unsigned __int128");
+static_assert(U256(-(__int128)big128) == -U256(big128) && U256((__int128)1 << 100) == U256(1) << 100, "conversion from __int128");
+#endif
+
+// ### Literals
+using namespace biguint::literals;
+static_assert(340282366920938463463374607431768211455_u128 == max128, "decimal literal");
+static_assert(0xFFFF'FFFF'FFFF'FFFF_u128 == max64 && 0b1000_u128 == 8 && 0777_u128 == 511, "hexadecimal, binary and octal literals");
+static_assert(0x1'0000000000000000'0000000000000000_u256 == U256(1) << 128, "literal wider than 128 bits");
+static_assert(100000000000000000000000000000000000000_u128 == U128(10000000000000000000ull) * U128(10000000000000000000ull), "10^38");
+static_assert(123456789_u512 * 1000000000_u512 + 123456789_u512 == 123456789123456789_u512, "arithmetic on literals");
+constexpr BigDecimal128 pi = 3.14159265358979323846_d128;
+static_assert(pi.prec == 20 && U128(pi.val) == 314159265358979323846_u128, "decimal literal");
+static_assert((1.5e3_d128).prec == 0 && U128((1.5e3_d128).val) == 1500, "positive exponent");
+static_assert((2.5e-3_d128).prec == 4 && U128((2.5e-3_d128).val) == 25, "negative exponent");
+static_assert((170141183460469231731687303715884.105727_d128).prec == 6, "largest decimal value");
+// literals that do not compile
+static_assert(!biguint::detail::parse_literal<128>("340282366920938463463374607431768211456", 39, false).valid, "overflow");
+static_assert(!biguint::detail::parse_literal<128>("170141183460469231731687303715884105728", 39, true).valid, "overflow of signed value");
+static_assert(!biguint::detail::parse_literal<128>("1e39", 4, true).valid, "overflow by exponent");
+static_assert(!biguint::detail::parse_literal<128>("09", 2, false).valid, "invalid octal digit");
+static_assert(!biguint::detail::parse_literal<128>("1.5", 3, false).valid, "fraction in integer literal");
+
+#define TEST_N 200U
+
+/**
+ * Pseudo-random values with random bit length.
+ */
+template <unsigned int Bits>
+static biguint::UInt<Bits> random_() {
+ biguint::UInt<Bits> retv;
+ fill_random(retv.c().dat, retv.cells);
+ return retv >> (next_random() % Bits);
+}
+
+/**
+ * Compares the runtime results of the operators with the generic (constant expression) code.
+ */
+template <unsigned int Bits>
+static bool test_runtime_vs_generic() {
+ using U = biguint::UInt<Bits>;
+ bool pass = true;
+ for (unsigned int i = 0; i < TEST_N; ++i) {
+  U a = random_<Bits>();
+  U b = i % 7 == 0 ? U() : random_<Bits>();
+  U expected;
+  U q;
+  U r;
+  biguint::detail::add(expected.c().dat, a.c().dat, b.c().dat, false);
+  pass &= a + b == expected;
+  biguint::detail::sub(expected.c().dat, a.c().dat, b.c().dat, false);
+  pass &= a - b == expected && (a < b) == biguint::detail::lt(a.c().dat, b.c().dat);
+  biguint::detail::mul(expected.c().dat, a.c().dat, b.c().dat);
+  pass &= a * b == expected;
+  U c = random_<Bits>();
+  U prod = a * b;
+  U shifted = a << (i % Bits);
+  pass &= a * b + c == prod + c && c + a * b == prod + c && c - a * b == c - prod;
+  biguint::detail::mul_add(expected.c().dat, a.c().dat, b.c().dat, c.c().dat);
+  pass &= a * b + c == expected;
+  biguint::detail::mul_sub(expected.c().dat, a.c().dat, b.c().dat, c.c().dat);
+  pass &= c - a * b == expected;
+  pass &= (a << (i % Bits) | c) == (shifted | c) && (c | a << (i % Bits)) == (shifted | c);
+  biguint::detail::divmod(q.c().dat, r.c().dat, a.c().dat, b.c().dat);
+  pass &= a / b == q && a % b == r;
+  buint_size_t shift = i % (Bits + 1);
+  biguint::detail::shl(expected.c().dat, a.c().dat, shift);
+  pass &= (a << shift) == expected;
+  biguint::detail::shr(expected.c().dat, a.c().dat, shift);
+  pass &= (a >> shift) == expected;
+  if (b) pass &= q * b + r == a && r < b;
+  if (!pass) {
+   fprintf(stderr, "UInt<%u> failed: #%u\n", Bits, i);
+   return false;
+  }
+ }
+ return pass;
+}
+
+#define TEST_CAPI(W) \
+static bool test_capi##W() { \
+ bool pass = true; \
+ for (unsigned int i = 0; i < TEST_N; ++i) { \
+  biguint::UInt<W> a = random_<W>(); \
+  biguint::UInt<W> b = i % 7 == 0 ? biguint::UInt<W>() : random_<W>(); \
+  buint_size_t shift = i % (W + 1); \
+  const BigUInt##W &ac = a.c(); \
+  const BigUInt##W &bc = b.c(); \
+  BigUInt##W sum = biguint##W##_add(&ac, &bc); \
+  BigUInt##W diff = biguint##W##_sub(&ac, &bc); \
+  BigUInt##W prod = biguint##W##_mul(&ac, &bc); \
+  BigUIntPair##W qr = biguint##W##_div(&ac, &bc); \
+  BigUInt##W sl = biguint##W##_shl(&ac, shift); \
+  BigUInt##W sr = biguint##W##_shr(&ac, shift); \
+  pass &= biguint##W##_eq(&sum, &(a + b).c()); \
+  pass &= biguint##W##_eq(&diff, &(a - b).c()); \
+  pass &= biguint##W##_eq(&prod, &(a * b).eval().c()); \
+  pass &= biguint##W##_eq(&qr.first, &(a / b).c()); \
+  pass &= biguint##W##_eq(&qr.second, &(a % b).c()); \
+  pass &= biguint##W##_eq(&sl, &(a << shift).eval().c()); \
+  pass &= biguint##W##_eq(&sr, &(a >> shift).c()); \
+  pass &= (a < b) == (0 != biguint##W##_lt(&ac, &bc)); \
+  pass &= (a == b) == (0 != biguint##W##_eq(&ac, &bc)); \
+  if (!pass) { \
+   fprintf(stderr, "UInt<%u> vs. C API failed: #%u\n", W, i); \
+   return false; \
+  } \
+ } \
+ return pass; \
+}
+
+TEST_CAPI(128)
+#ifdef _BIGUINT256_H_
+TEST_CAPI(256)
+#endif
+
+bool test_zero_copy() {
+ BigUInt128 a = biguint128_value_of_uint(7);
+ U128 &av = U128::view(a);
+ av *= 6;
+ av <<= 100;
+ U128 b(a);
+ BigUInt128 expected = biguint128_value_of_uint(42);
+ biguint128_shl_assign(&expected, 100);
+ return &av.c() == &a && biguint128_eq(&expected, &a) && b == av && b.cell(0) == 0;
+}
+
+bool test_decimal_literal() {
+ const char str[] = "-3.14159265358979323846";
+ BigDecimal128 expected = bigdecimal128_ctor_cstream(str, sizeof(str) - 1);
+ BigDecimal128 actual = 3.14159265358979323846_d128;
+ bigint128_negate_assign(&actual.val);
+ return biguint128_eq(&expected.val, &actual.val) && expected.prec == actual.prec;
+}
+
+/**
+ * to_chars / from_chars round trips in every base, signed values, BigDecimal and the error codes.
+ */
+template <unsigned int Bits>
+static bool test_charconv() {
+ using U = biguint::UInt<Bits>;
+ char buf[Bits + 2];
+ bool pass = true;
+ for (unsigned int i = 0; i < TEST_N; ++i) {
+  U a = random_<Bits>();
+  int base = 2 + int(i % 35u);
+  auto [end, ec] = biguint::to_chars(buf, buf + sizeof(buf), a, base);
+  U b;
+  auto [pend, pec] = biguint::from_chars(buf, end, b, base);
+  pass &= ec == std::errc() && pec == std::errc() && pend == end && a == b;
+  biguint::Int<Bits> sa{-a};
+  biguint::Int<Bits> sb{};
+  end = biguint::to_chars(buf, buf + sizeof(buf), sa, base).ptr;
+  pass &= (buf[0] == '-') == bool(sa.val >> (Bits - 1)) || !a;
+  pass &= biguint::from_chars(buf, end, sb, base).ptr == end && sa.val == sb.val;
+  if (!pass) {
+   fprintf(stderr, "to_chars / from_chars (UInt<%u>) failed: #%u\n", Bits, i);
+   return false;
+  }
+ }
+ return pass;
+}
+
+bool test_charconv_c() {
+ bool pass = true;
+ char buf[48];
+ const char max_str[] = "340282366920938463463374607431768211455";
+ const char min_str[] = "-170141183460469231731687303715884105728";
+ BigUInt128 a = biguint128_ctor_deccstream(max_str, sizeof(max_str) - 1);
+ auto r = biguint::to_chars(buf, buf + sizeof(buf), a);
+ pass &= r.ec == std::errc() && std::string_view(buf, r.ptr - buf) == max_str;
+ pass &= biguint::to_chars(buf, buf + 4, a, 16).ec == std::errc::value_too_large;
+ r = biguint::to_chars(buf, buf + sizeof(buf), a, 16);
+ pass &= std::string_view(buf, r.ptr - buf) == "ffffffffffffffffffffffffffffffff";
+ // from_chars: the pattern, the error codes, the value is not modified on error
+ BigUInt128 b = biguint128_value_of_uint(42);
+ const char in1[] = "340282366920938463463374607431768211456 ";
+ auto p = biguint::from_chars(in1, in1 + sizeof(in1) - 1, b);
+ pass &= p.ec == std::errc::result_out_of_range && p.ptr == in1 + sizeof(in1) - 2 && U128::view(b) == 42;
+ const char in2[] = "-1";
+ p = biguint::from_chars(in2, in2 + 2, b);
+ pass &= p.ec == std::errc::invalid_argument && p.ptr == in2 && U128::view(b) == 42;
+ const char in3[] = "7fZz";
+ p = biguint::from_chars(in3, in3 + 4, b, 16);
+ pass &= p.ec == std::errc() && p.ptr == in3 + 2 && U128::view(b) == 0x7f;
+ // signed limits
+ biguint::Int<128> s;
+ p = biguint::from_chars(min_str, min_str + sizeof(min_str) - 1, s);
+ pass &= p.ec == std::errc() && s.val == U128(1) << 127;
+ r = biguint::to_chars(buf, buf + sizeof(buf), s);
+ pass &= std::string_view(buf, r.ptr - buf) == min_str;
+ p = biguint::from_chars(min_str + 1, min_str + sizeof(min_str) - 1, s);
+ pass &= p.ec == std::errc::result_out_of_range && s.val == U128(1) << 127;
+ // BigDecimal, compared with bigdecimal128_print()
+ const char *decs[] = {"0", "-3.3", "0.0000007", "-17014118346046923173168730371588410572.7", "12.500"};
+ for (const char *str : decs) {
+  BigDecimal128 d = bigdecimal128_ctor_cstream(str, strlen(str));
+  BigDecimal128 e = 7.5_d128;
+  char expected[48];
+  buint_size_t len = bigdecimal128_print(&d, expected, sizeof(expected));
+  r = biguint::to_chars(buf, buf + sizeof(buf), d);
+  pass &= std::string_view(buf, r.ptr - buf) == std::string_view(expected, len);
+  p = biguint::from_chars(buf, r.ptr, e);
+  pass &= p.ec == std::errc() && p.ptr == r.ptr && biguint128_eq(&d.val, &e.val) && d.prec == e.prec;
+ }
+ return pass;
+}
+
+int main() {
+ assert(test_runtime_vs_generic<128>());
+ assert(test_runtime_vs_generic<192>());
+ assert(test_runtime_vs_generic<256>());
+ assert(test_runtime_vs_generic<1024>());
+ assert(test_runtime_vs_generic<4096>());
+ assert(test_capi128());
+#ifdef _BIGUINT256_H_
+ assert(test_capi256());
+#endif
+ assert(test_zero_copy());
+ assert(test_decimal_literal());
+ assert(test_charconv<128>());
+ assert(test_charconv<192>());
+ assert(test_charconv<1024>());
+ assert(test_charconv_c());
+ return 0;
+}
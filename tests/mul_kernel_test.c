@@ -0,0 +1,80 @@
+#include <stdio.h>
+#include <stdbool.h>
+#include <string.h>
+#include <assert.h>
+#include "mul_kernel.h"
+#include "test_common.h"
+
+#define MAX_CELLS 40U
+
+UInt fa[MAX_CELLS];
+UInt fb[MAX_CELLS];
+UInt expected[2 * MAX_CELLS];
+UInt actual[2 * MAX_CELLS];
+
+bool test_kernel_selection() {
+ bool pass = true;
+ MulKernel loaded = mul_kernel_active;
+ pass &= loaded != MUL_KERNEL_AUTO;
+ pass &= mul_kernel_supported(MUL_KERNEL_GENERIC);
+ pass &= mul_kernel_supported(loaded);
+ pass &= mul_kernel_set(MUL_KERNEL_GENERIC) && mul_kernel_active == MUL_KERNEL_GENERIC;
+ pass &= mul_kernel_set(MUL_KERNEL_AUTO) && mul_kernel_active == loaded;
+ if (!mul_kernel_supported(MUL_KERNEL_MULX_ADX)) {
+  pass &= !mul_kernel_set(MUL_KERNEL_MULX_ADX) && mul_kernel_active == loaded;
+ }
+ if (!pass) fprintf(stderr, "kernel selection failed\n");
+ return pass;
+}
+
+#ifdef MUL_KERNEL_HAVE_MULX_ADX
+static bool check_mulx_(const UInt *a, buint_size_t na, const UInt *b, buint_size_t nb, buint_size_t ncols, const char *desc) {
+ bool pass = true;
+ mul_ref(expected, a, na, b, nb, ncols);
+ mul_kernel_mulx_mul(actual, a, na, b, nb, ncols);
+ if (memcmp(expected, actual, ncols * sizeof(UInt)) != 0) {
+  fprintf(stderr, "mul_kernel_mulx_mul failed: %s, %u x %u cells, %u columns\n", desc, (unsigned int)na, (unsigned int)nb, (unsigned int)ncols);
+  pass = false;
+ }
+ if (a == b && na == nb) {
+  mul_kernel_mulx_sqr(actual, a, na, ncols);
+  if (memcmp(expected, actual, ncols * sizeof(UInt)) != 0) {
+   fprintf(stderr, "mul_kernel_mulx_sqr failed: %s, %u cells, %u columns\n", desc, (unsigned int)na, (unsigned int)ncols);
+   pass = false;
+  }
+ }
+ return pass;
+}
+#endif
+
+bool test_mulx_adx() {
+ bool pass = true;
+#ifdef MUL_KERNEL_HAVE_MULX_ADX
+ if (!mul_kernel_supported(MUL_KERNEL_MULX_ADX)) {
+  fprintf(stderr, "MULX / ADX not supported by the CPU, kernel not tested\n");
+  return true;
+ }
+ for (buint_size_t na = 0; na <= MAX_CELLS; na += na < 10 ? 1 : 7) {
+  for (buint_size_t nb = 0; nb <= MAX_CELLS; nb += nb < 10 ? 1 : 11) {
+   fill_random(fa, MAX_CELLS);
+   fill_random(fb, MAX_CELLS);
+   const buint_size_t ncols[] = {na + nb, (na + nb) / 2, na < nb ? nb : na};
+   for (unsigned int k = 0; k < ARRAYSIZE(ncols); ++k) {
+    pass &= check_mulx_(fa, na, fb, nb, ncols[k], "random");
+    pass &= check_mulx_(fa, na, fa, na, ncols[k], "random");
+   }
+   memset(fa, 0xFF, sizeof(fa));
+   memset(fb, 0xFF, sizeof(fb));
+   pass &= check_mulx_(fa, na, fb, nb, na + nb, "max");
+   pass &= check_mulx_(fa, na, fa, na, 2 * na, "max");
+  }
+ }
+#endif
+ return pass;
+}
+
+int main() {
+ assert(test_kernel_selection());
+ assert(test_mulx_adx());
+ return 0;
+}
@@ -0,0 +1,58 @@
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include "ntt.h"
+#include "test_common.h"
+
+#define MAX_CELLS 1200U
+
+UInt fa[MAX_CELLS];
+UInt fb[MAX_CELLS];
+UInt expected[2 * MAX_CELLS];
+UInt actual[2 * MAX_CELLS];
+uint32_t scratch[NTT_SCRATCH_WORDS(MAX_CELLS * sizeof(UInt))];
+
+static bool check_mul_(const UInt *a, buint_size_t na, const UInt *b, buint_size_t nb, const char *desc) {
+ mul_ref(expected, a, na, b, nb, na + nb);
+ ntt_mul(actual, a, na, b, nb, scratch);
+ if (memcmp(expected, actual, (na + nb) * sizeof(UInt)) != 0) {
+  fprintf(stderr, "ntt_mul failed: %s, %" PRIbuint_size_t " x %" PRIbuint_size_t " cells\n", desc, na, nb);
+  return false;
+ }
+ return true;
+}
+
+bool test_ntt_mul() {
+ const buint_size_t sizes[][2] = {
+  {1, 1}, {1, 5}, {3, 7}, {2, 2}, {17, 16}, {64, 64}, {100, 37}, {257, 300}, {MAX_CELLS, MAX_CELLS}
+ };
+ bool pass = true;
+ for (unsigned int i = 0; i < ARRAYSIZE(sizes); ++i) {
+  buint_size_t na = sizes[i][0];
+  buint_size_t nb = sizes[i][1];
+  fill_random(fa, na);
+  fill_random(fb, nb);
+  pass &= check_mul_(fa, na, fb, nb, "random");
+  pass &= check_mul_(fa, na, fa, na, "random square");
+  // the largest convolution terms
+  memset(fa, 0xFF, na * sizeof(UInt));
+  memset(fb, 0xFF, nb * sizeof(UInt));
+  pass &= check_mul_(fa, na, fb, nb, "max");
+  pass &= check_mul_(fa, na, fa, na, "max square");
+  // sparse values
+  memset(fa, 0, na * sizeof(UInt));
+  memset(fb, 0, nb * sizeof(UInt));
+  fa[na - 1] = 1;
+  fb[0] = (UInt)-1;
+  fb[nb - 1] = (UInt)-1;
+  pass &= check_mul_(fa, na, fb, nb, "sparse");
+ }
+ return pass;
+}
+
+int main() {
+ assert(test_ntt_mul());
+ return 0;
+}
@@ -6,6 +6,10 @@
  (uint_add() / uint_add_assign() /
  uint_sub()) as external and as inline
  functions.
+ The uint_*2 variants are the portable
+ (comparison based) implementations,
+ uint_* use the carry propagation layer
+ selected by configure.
 ***************************************/
 
 #include <stdio.h>
@@ -52,7 +56,7 @@ static inline UInt *_uint_add_assign2(UInt *a, UInt b, buint_bool *carry) {
 
 static void print_result(clock_t t_begin, clock_t t_end, const char *op, int cnt) {
  clock_t dt = t_end - t_begin;
- fprintf(stdout, "=== %d %s() operations ===\n", cnt, op);
+ fprintf(stdout, "=== %d %s() operations (%u bit UInt cells) ===\n", cnt, op, (unsigned int)(8 * sizeof(UInt)));
  fprintf(stdout, "Elapsed time: %ld us,\t%.1f op/s\n", dt, (1000000.0 * cnt) / dt);
 }
 
@@ -127,6 +131,7 @@ int main(int argc, const char *argv[]) {
  UInt buf_step[]={29,29,-29};
  const char *title[]={"low","medium","high"};
 
+ fprintf(stderr, "*** carry propagation: %s ***\n", UINT_CARRY_LAYER);
  for (int i=0; i<3; ++i) {
   fprintf(stderr, "*** uint functions on %s numbers ***\n", title[i]);
   exec_uint_test_(SUB, buf_init[i], buf_step[i]);
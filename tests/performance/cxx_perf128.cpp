@@ -0,0 +1,132 @@
+extern "C" {
+#include "biguint128.h"
+#include "perf_common.h"
+#include "perf_common128.h"
+}
+#include "biguint.hpp"
+
+using U128 = biguint::UInt<128>;
+
+// ### Constraints and default values
+const StandardConstraints LIMITS = {
+ 8,
+ (1<<26) // 64M loops
+};
+// INIT_FUN2ARGS is a C compound literal
+const StandardArgs ARGS_DEFAULT = {
+ (1<<20), // 1M loops
+ false, false,
+ 3U,
+ {~0U, ~0U},
+ {37, 29},
+ ~0U, 0, 0};
+
+typedef enum {
+ FUN_ADD_C = 0,
+ FUN_ADD_CXX,
+ FUN_SUB_C,
+ FUN_SUB_CXX,
+ FUN_MUL_C,
+ FUN_MUL_CXX,
+ FUN_DIV_C,
+ FUN_DIV_CXX,
+ FUN_SHL_C,
+ FUN_SHL_CXX,
+ FUN_LT_C,
+ FUN_LT_CXX,
+ FUN_MULADD_C,
+ FUN_MULADD_CXX,
+ FUN_MULSUB_C,
+ FUN_MULSUB_CXX,
+ FUN_SHLOR_C,
+ FUN_SHLOR_C_FUSED,
+ FUN_SHLOR_CXX
+} CxxFun;
+
+const char *funname[]={
+ "add",
+ "operator+",
+ "sub",
+ "operator-",
+ "mul",
+ "operator*",
+ "div",
+ "divmod",
+ "shl",
+ "operator<<",
+ "lt",
+ "operator<",
+ "add(mul(a,b),r)",
+ "a * b + r",
+ "sub(r,mul(a,b))",
+ "r - a * b",
+ "or(shl(a,b%128),r)",
+ "shl_or(r,a,b%128)",
+ "(a << b%128) | r"
+};
+
+static unsigned int exec_function_loop_(unsigned int ai, unsigned int bi, unsigned int fun, const StandardArgs *args, UInt *chkval) {
+ BigUInt128 a = get_value_by_level(ai, args->levels);
+ BigUInt128 b = get_value_by_level(bi, args->levels);
+ U128 &ax = U128::view(a);
+ U128 &bx = U128::view(b);
+ BigUInt128 res = biguint128_ctor_default();
+ BigUInt128 rem = biguint128_ctor_default();
+ U128 &resx = U128::view(res);
+ U128 &remx = U128::view(rem);
+
+ for (unsigned int i = 0; i < args->loops; ++i) {
+  if (fun == FUN_ADD_C) {
+   res = biguint128_add(&a, &b);
+  } else if (fun == FUN_ADD_CXX) {
+   resx = ax + bx;
+  } else if (fun == FUN_SUB_C) {
+   res = biguint128_sub(&a, &b);
+  } else if (fun == FUN_SUB_CXX) {
+   resx = ax - bx;
+  } else if (fun == FUN_MUL_C) {
+   res = biguint128_mul(&a, &b);
+  } else if (fun == FUN_MUL_CXX) {
+   resx = ax * bx;
+  } else if (fun == FUN_DIV_C) {
+   BigUIntPair128 qr = biguint128_div(&a, &b);
+   res = qr.first;
+   rem = qr.second;
+  } else if (fun == FUN_DIV_CXX) {
+   U128::divmod(resx, remx, ax, bx);
+  } else if (fun == FUN_SHL_C) {
+   res = biguint128_shl(&a, b.dat[0] % 128U);
+  } else if (fun == FUN_SHL_CXX) {
+   resx = ax << bx.cell(0) % 128U;
+  } else if (fun == FUN_LT_C) {
+   rem.dat[0] += biguint128_lt(&a, &b);
+  } else if (fun == FUN_LT_CXX) {
+   rem.dat[0] += ax < bx;
+  } else if (fun == FUN_MULADD_C) {
+   BigUInt128 p = biguint128_mul(&a, &b);
+   res = biguint128_add(&p, &res);
+  } else if (fun == FUN_MULADD_CXX) {
+   resx = ax * bx + resx;
+  } else if (fun == FUN_MULSUB_C) {
+   BigUInt128 p = biguint128_mul(&a, &b);
+   res = biguint128_sub(&res, &p);
+  } else if (fun == FUN_MULSUB_CXX) {
+   resx = resx - ax * bx;
+  } else if (fun == FUN_SHLOR_C) {
+   BigUInt128 p = biguint128_shl(&a, b.dat[0] % 128U);
+   res = biguint128_or(&p, &res);
+  } else if (fun == FUN_SHLOR_C_FUSED) {
+   biguint128_shl_or(&res, &a, b.dat[0] % 128U);
+  } else if (fun == FUN_SHLOR_CXX) {
+   resx = (ax << bx.cell(0) % 128U) | resx;
+  }
+  process_result_v1(&res, chkval+0);
+  process_result_v1(&rem, chkval+1);
+  inc_operands_v1(&a, &b, (UInt) args->diff[0], (UInt) args->diff[1]);
+ }
+ return args->loops;
+}
+
+int main(int argc, const char *argv[]) {
+ return fun2_main(argc, argv, 128, ARGS_DEFAULT, &LIMITS, ARRAYSIZE(funname), funname, &exec_function_loop_, 2);
+}
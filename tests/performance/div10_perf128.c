@@ -17,7 +17,8 @@ typedef enum {
  VARIANT_DIV1000_MUL100_X,
  VARIANT_DIV30_MUL3_X,
  VARIANT_DIV10_X,
- VARIANT_DIV_TINY_X_10
+ VARIANT_DIV_TINY_X_10,
+ VARIANT_MOD_TINY_X_10
 } Div10Variant;
 
 const char *funname[] = {
@@ -25,7 +26,8 @@ const char *funname[] = {
  "d1000(m100(x))",
  "div30(mul3(x))",
  "div10(x)",
- "div_uint(x,10)"
+ "div_uint(x,10)",
+ "mod_uint(x,10)"
 };
 
 static unsigned int exec_function_loop_(unsigned int ai, unsigned int fun, const StandardArgs *args, UInt *chkval) {
@@ -33,9 +35,10 @@ static unsigned int exec_function_loop_(unsigned int ai, unsigned int fun, const
  BigUInt128 a = get_value_by_level(ai, args->levels);
  BigUInt128 res0;
  BigUIntPair128 res;
- BigUIntTinyPair128 rest;
- BigUInt128 *procref1 = fun == VARIANT_DIV10_X || fun == VARIANT_DIV_TINY_X_10?&rest.first:&res.first;
- UInt *procref2 = fun == VARIANT_DIV10_X || fun == VARIANT_DIV_TINY_X_10?&rest.second:&res.second.dat[0];
+ BigUIntTinyPair128 rest = {biguint128_ctor_default(), 0};
+ buint_bool tiny = fun == VARIANT_DIV10_X || fun == VARIANT_DIV_TINY_X_10 || fun == VARIANT_MOD_TINY_X_10;
+ BigUInt128 *procref1 = tiny?&rest.first:&res.first;
+ UInt *procref2 = tiny?&rest.second:&res.second.dat[0];
  unsigned int loop_cnt;
 
  for (loop_cnt = 0; loop_cnt < args->loops; ++loop_cnt) {
@@ -51,6 +54,8 @@ static unsigned int exec_function_loop_(unsigned int ai, unsigned int fun, const
    res.second.dat[0]/=3;
   } else if (fun == VARIANT_DIV_TINY_X_10) {
    rest = biguint128_div_uint(&a,10);
+  } else if (fun == VARIANT_MOD_TINY_X_10) {
+   rest.second = biguint128_mod_uint(&a,10);
   } else {
    rest = biguint128_div10(&a);
   }
@@ -0,0 +1,53 @@
+#include "biguint128.h"
+#include "perf_common.h"
+#include "perf_common128.h"
+
+
+// ### Constraints and default values
+const StandardConstraints LIMITS = {
+ 8,
+ (1<<26) // 64M loops
+};
+const StandardArgs ARGS_DEFAULT = INIT_FUN2ARGS(
+ (1<<20), // 1M loops
+ 3U,
+ 37U,
+ 0U); // the divisor is invariant by default
+
+typedef enum {
+ FUN_DIV = 0,
+ FUN_DIV_PRE,
+ FUN_MOD_PRE
+} DivisorFun;
+
+const char *funname[]={
+ "div",
+ "div_pre",
+ "mod_pre"
+};
+
+static unsigned int exec_function_loop_(unsigned int ai, unsigned int bi, unsigned int fun, const StandardArgs *args, UInt *chkval) {
+ BigUInt128 a = get_value_by_level(ai, args->levels);
+ BigUInt128 b = get_value_by_level(bi, args->levels);
+ BigUIntDivisor128 d = biguint128_divisor_ctor(&b);
+ BigUIntPair128 resp = {biguint128_ctor_default(), biguint128_ctor_default()};
+
+ for (unsigned int i = 0; i < args->loops; ++i) {
+  if (fun == FUN_DIV) {
+   resp = biguint128_div(&a, &b);
+  } else if (fun == FUN_DIV_PRE) {
+   resp = biguint128_div_pre(&a, &d);
+  } else if (fun == FUN_MOD_PRE) {
+   resp.second = biguint128_mod_pre(&a, &d);
+  }
+  process_result_v1(&resp.second, chkval+0);
+  process_result_v1(&resp.first, chkval+1);
+  inc_operands_v1(&a, &b, (UInt) args->diff[0], (UInt) args->diff[1]);
+  if (fun != FUN_DIV && args->diff[1] != 0) d = biguint128_divisor_ctor(&b);
+ }
+ return args->loops;
+}
+
+int main(int argc, const char *argv[]) {
+ return fun2_main(argc, argv, 128, ARGS_DEFAULT, &LIMITS, ARRAYSIZE(funname), funname, &exec_function_loop_, 2);
+}
@@ -0,0 +1,75 @@
+#include "biguint128.h"
+#include "biguintn.h"
+#include <string.h>
+#include "perf_common.h"
+#include "perf_common128.h"
+
+
+// ### Constraints and default values
+const StandardConstraints LIMITS = {
+ 8,
+ (1<<26) // 64M loops
+};
+const StandardArgs ARGS_DEFAULT = INIT_FUN2ARGS(
+ (1<<20), // 1M loops
+ 3U,
+ 37U,
+ 0U); // the modulus is invariant by default
+
+typedef enum {
+ FUN_DIV = 0,
+ FUN_MOD_PRE,
+ FUN_BARRETT,
+ FUN_DMUL_DIV,
+ FUN_DMUL_BARRETT
+} ModRedFun;
+
+const char *funname[]={
+ "div",
+ "mod_pre",
+ "barrett",
+ "dmul_div",
+ "dmul_barrett"
+};
+
+static unsigned int exec_function_loop_(unsigned int ai, unsigned int bi, unsigned int fun, const StandardArgs *args, UInt *chkval) {
+ BigUInt128 a = get_value_by_level(ai, args->levels);
+ BigUInt128 b = get_value_by_level(bi, args->levels);
+ BigUIntDivisor128 d = biguint128_divisor_ctor(&b);
+ BarrettCtx128 ctx = biguint128_barrett_ctor(&b);
+ BigUIntPair128 x = {biguint128_ctor_default(), biguint128_ctor_default()};
+ BigUInt128 res;
+ UInt prod[2 * BIGUINT128_CELLS];
+ UInt scratch[BIGUINTN_DIV_SCRATCH(2 * BIGUINT128_CELLS, BIGUINT128_CELLS)];
+
+ for (unsigned int i = 0; i < args->loops; ++i) {
+  if (fun == FUN_DIV) {
+   res = biguint128_div(&a, &b).second;
+  } else if (fun == FUN_MOD_PRE) {
+   res = biguint128_mod_pre(&a, &d);
+  } else if (fun == FUN_BARRETT) {
+   x.first = a;
+   res = biguint128_barrett_reduce(&ctx, &x);
+  } else if (fun == FUN_DMUL_DIV) {
+   // double-width product, reduced by long division
+   x = biguint128_dmul(&a, &a);
+   memcpy(prod, x.first.dat, sizeof(x.first.dat));
+   memcpy(prod + BIGUINT128_CELLS, x.second.dat, sizeof(x.second.dat));
+   biguintn_div(NULL, res.dat, prod, 2 * BIGUINT128_CELLS, b.dat, BIGUINT128_CELLS, scratch);
+  } else if (fun == FUN_DMUL_BARRETT) {
+   x = biguint128_dmul(&a, &a);
+   res = biguint128_barrett_reduce(&ctx, &x);
+  }
+  process_result_v1(&res, chkval+0);
+  inc_operands_v1(&a, &b, (UInt) args->diff[0], (UInt) args->diff[1]);
+  if (args->diff[1] != 0) {
+   if (fun == FUN_MOD_PRE) d = biguint128_divisor_ctor(&b);
+   if (fun == FUN_BARRETT || fun == FUN_DMUL_BARRETT) ctx = biguint128_barrett_ctor(&b);
+  }
+ }
+ return args->loops;
+}
+
+int main(int argc, const char *argv[]) {
+ return fun2_main(argc, argv, 128, ARGS_DEFAULT, &LIMITS, ARRAYSIZE(funname), funname, &exec_function_loop_, 1);
+}
@@ -15,18 +15,24 @@ const StandardArgs ARGS_DEFAULT = INIT_FUN1ARGS(
 typedef enum {
  FUN_MSB = 0,
  FUN_LZB,
- FUN_LZC
+ FUN_LZC,
+ FUN_CLZ,
+ FUN_CTZ,
+ FUN_POPCOUNT
 } MsbFun;
 
 const char *funname[]={
  "msb",
  "lzb",
- "lzc"
+ "lzc",
+ "clz",
+ "ctz",
+ "popcount"
 };
 
 static unsigned int exec_function_loop_(unsigned int ai, unsigned int fun, const StandardArgs *args, UInt *chkval) {
  BigUInt128 a = get_value_by_level(ai, args->levels);
- buint_size_t res;
+ buint_size_t res = 0;
 
  for (unsigned int i = 0; i < args->loops; ++i) {
   if (fun == FUN_MSB) {
@@ -35,6 +41,12 @@ static unsigned int exec_function_loop_(unsigned int ai, unsigned int fun, const
    res = biguint128_lzb(&a);
   } else if (fun == FUN_LZC) {
    res = biguint128_lzc(&a);
+  } else if (fun == FUN_CLZ) {
+   res = biguint128_clz(&a);
+  } else if (fun == FUN_CTZ) {
+   res = biguint128_ctz(&a);
+  } else if (fun == FUN_POPCOUNT) {
+   res = biguint128_popcount(&a);
   }
   *chkval+=res;
   biguint128_add_tiny(&a, args->diff[0]);
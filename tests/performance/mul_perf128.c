@@ -17,13 +17,17 @@ const StandardArgs ARGS_DEFAULT = INIT_FUN2ARGS(
 typedef enum {
  FUN_MUL = 0,
  FUN_DMUL,
- FUN_DIV
+ FUN_DIV,
+ FUN_SQR,
+ FUN_DSQR
 } MultiplicativeFun;
 
 const char *funname[]={
  "mul",
  "dmul",
- "div"
+ "div",
+ "sqr",
+ "dsqr"
 };
 
 static unsigned int exec_function_loop_(unsigned int ai, unsigned int bi, unsigned int fun, const StandardArgs *args, UInt *chkval) {
@@ -31,8 +35,8 @@ static unsigned int exec_function_loop_(unsigned int ai, unsigned int bi, unsign
  BigUInt128 b = get_value_by_level(bi, args->levels);
  BigUInt128 res;
  BigUIntPair128 resp;
- BigUInt128 *procref1 = fun == FUN_MUL ? &res : &resp.first;
- BigUInt128 *procref2 = fun == FUN_MUL ? &res : &resp.second;
+ BigUInt128 *procref1 = fun == FUN_MUL || fun == FUN_SQR ? &res : &resp.first;
+ BigUInt128 *procref2 = fun == FUN_MUL || fun == FUN_SQR ? &res : &resp.second;
 
  for (unsigned int i = 0; i < args->loops; ++i) {
   if (fun == FUN_MUL) {
@@ -41,6 +45,10 @@ static unsigned int exec_function_loop_(unsigned int ai, unsigned int bi, unsign
    resp = biguint128_dmul(&a, &b);
   } else if (fun == FUN_DIV) {
    resp = biguint128_div(&a, &b);
+  } else if (fun == FUN_SQR) {
+   res = biguint128_sqr(&a);
+  } else if (fun == FUN_DSQR) {
+   resp = biguint128_dsqr(&a);
   }
   process_result_v1(procref2, chkval+0);
   process_result_v1(procref1, chkval+1);
@@ -0,0 +1,63 @@
+#include <string.h>
+#include "biguint128.h"
+#include "ntt.h"
+#include "perf_common.h"
+#include "perf_common128.h"
+
+
+// ### Constraints and default values
+const StandardConstraints LIMITS = {
+ 8,
+ (1<<26) // 64M loops
+};
+const StandardArgs ARGS_DEFAULT = INIT_FUN2ARGS(
+ (1<<12), // 4k loops
+ 8U,
+ 1U,
+ 1U);
+
+typedef enum {
+ FUN_DMUL = 0,
+ FUN_DSQR,
+ FUN_NTT_MUL,
+ FUN_NTT_SQR
+} NttFun;
+
+const char *funname[]={
+ "dmul",
+ "dsqr",
+ "ntt_mul",
+ "ntt_sqr"
+};
+
+// The transforms are always used by the ntt_* functions, the library selects them above BIGUINT128_NTT_CELLS cells.
+static uint32_t scratch[NTT_SCRATCH_WORDS(BIGUINT128_CELLS * sizeof(UInt))];
+
+static unsigned int exec_function_loop_(unsigned int ai, unsigned int bi, unsigned int fun, const StandardArgs *args, UInt *chkval) {
+ BigUInt128 a = get_value_by_level(ai, args->levels);
+ BigUInt128 b = get_value_by_level(bi, args->levels);
+ BigUIntPair128 resp = {biguint128_ctor_default(), biguint128_ctor_default()};
+
+ for (unsigned int i = 0; i < args->loops; ++i) {
+  if (fun == FUN_DMUL) {
+   resp = biguint128_dmul(&a, &b);
+  } else if (fun == FUN_DSQR) {
+   resp = biguint128_dsqr(&a);
+  } else {
+   buint_size_t na = biguint128_lzc(&a);
+   buint_size_t nb = fun == FUN_NTT_SQR ? na : biguint128_lzc(&b);
+   if (0 < na && 0 < nb) {
+    memset(&resp, 0, sizeof(resp));
+    ntt_mul(resp.first.dat, a.dat, na, fun == FUN_NTT_SQR ? a.dat : b.dat, nb, scratch);
+   }
+  }
+  process_result_v1(&resp.first, chkval+0);
+  process_result_v1(&resp.second, chkval+1);
+  inc_operands_v1(&a, &b, (UInt) args->diff[0], (UInt) args->diff[1]);
+ }
+ return args->loops;
+}
+
+int main(int argc, const char *argv[]) {
+ return fun2_main(argc, argv, 128, ARGS_DEFAULT, &LIMITS, ARRAYSIZE(funname), funname, &exec_function_loop_, 2);
+}
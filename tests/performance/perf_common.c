@@ -3,6 +3,7 @@
 #include <time.h>
 
 #include "perf_common.h"
+#include "mul_kernel.h"
 
 static inline bool set_aorb(char sel, unsigned int *store, unsigned int val) {
  if (sel<'a' || 'b'<sel) return true;
@@ -57,6 +58,10 @@ StandardArgs parse_args(int argc, const char *argv[], const StandardArgs res_ini
     retv.fexmask = val;
     if (c2) retv.error |= true;
     break;
+   case 'k':
+    retv.kernel = val;
+    if (c2) retv.error |= true;
+    break;
    default:
     retv.error |= true;
   }
@@ -76,6 +81,7 @@ void print_help(const char *prgname, unsigned int argmask) {
  if (argmask&ARGMASK_DIFFB) fprintf(stderr, "%s[-db <step of operand b>]", OPTSEP);
  if (argmask&ARGMASK_FMASK) fprintf(stderr, "%s[-f <mask of included function checks>]", OPTSEP);
  if (argmask&ARGMASK_FEXMASK) fprintf(stderr, "%s[-F <mask of excluded function checks>]", OPTSEP);
+ if (argmask&ARGMASK_KERNEL) fprintf(stderr, "%s[-k <multiplication kernel>]", OPTSEP);
  fprintf(stderr, "%s[-h]\n", OPTSEP);
 }
 
@@ -85,11 +91,17 @@ void print_help_all(const char *prgname, unsigned int bits, unsigned int argmask
  for (unsigned int i=0; i<fun_n; ++i) {
   fprintf(stderr, " %6u: biguint%u_%s()\n", 1U<<i, bits, funname[i]);
  }
+ if (argmask&ARGMASK_KERNEL) {
+  fprintf(stderr, "and multiplication kernels are\n");
+  for (unsigned int k=MUL_KERNEL_AUTO; k<=MUL_KERNEL_MULX_ADX; ++k) {
+   fprintf(stderr, " %6u: %s%s\n", k, mul_kernel_name((MulKernel)k), mul_kernel_supported((MulKernel)k) ? "" : " (not supported)");
+  }
+ }
 }
 
 static inline void print_exec_time(clock_t t_begin, clock_t t_end, const char *op, int cnt, unsigned int bits) {
  clock_t dt = t_end - t_begin;
- fprintf(stdout, "=== %d BigUInt%u %s operations ===\n", cnt, bits, op);
+ fprintf(stdout, "=== %d BigUInt%u %s operations (%u bit UInt cells) ===\n", cnt, bits, op, (unsigned int)(8 * sizeof(UInt)));
  fprintf(stdout, " Elapsed time: %ld us,\t%.1f op/s\n", dt, (1000000.0 * cnt) / dt);
 }
 
@@ -125,6 +137,11 @@ static inline int check_args_(const char *prgname, StandardArgs *args,
   fprintf(stderr, "The maximal number of looops is %u.\n", max->loops);
   args->loops = max->loops;
  }
+ if (!mul_kernel_set((MulKernel)args->kernel)) {
+  fprintf(stderr, "The multiplication kernel %s is not supported.\n", mul_kernel_name((MulKernel)args->kernel));
+  return 1;
+ }
+ fprintf(stdout, "Multiplication kernel: %s\n", mul_kernel_name(mul_kernel_active));
  return 0;
 }
 
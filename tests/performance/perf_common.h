@@ -18,6 +18,7 @@ typedef struct {
  int diff[2];
  unsigned int fmask;
  unsigned int fexmask;
+ unsigned int kernel; // MulKernel; 0 (MUL_KERNEL_AUTO) if not given
 } StandardArgs;
 
 typedef unsigned int (*LoopFunction2)(unsigned int ai, unsigned int bi, unsigned int funidx, const StandardArgs *args, UInt *chkval);
@@ -32,10 +33,11 @@ typedef unsigned int (*LoopFunctionN)(unsigned int *xi, unsigned int funidx, con
 #define ARGMASK_DIFFB 32U
 #define ARGMASK_FMASK 64U
 #define ARGMASK_FEXMASK 128U
-#define ARGMASK_ALL 255U
+#define ARGMASK_KERNEL 256U
+#define ARGMASK_ALL 511U
 
-#define INIT_FUN1ARGS(LOOPS,LEVELS,INCA) (StandardArgs){LOOPS, false, false, LEVELS, {-1, 0}, {INCA, 0}, -1, 0}
-#define INIT_FUN2ARGS(LOOPS,LEVELS,INCA,INCB) (StandardArgs){LOOPS, false, false, LEVELS, {-1, -1}, {INCA, INCB}, -1, 0}
+#define INIT_FUN1ARGS(LOOPS,LEVELS,INCA) (StandardArgs){LOOPS, false, false, LEVELS, {-1, 0}, {INCA, 0}, -1, 0, 0}
+#define INIT_FUN2ARGS(LOOPS,LEVELS,INCA,INCB) (StandardArgs){LOOPS, false, false, LEVELS, {-1, -1}, {INCA, INCB}, -1, 0, 0}
 #define ARRAYSIZE(X) (sizeof(X)/sizeof(X[0]))
 
 StandardArgs parse_args(int argc, const char *argv[], const StandardArgs res_init);
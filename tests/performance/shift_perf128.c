@@ -22,7 +22,15 @@ typedef enum {
  VARIANT_ROR,
  VARIANT_SHL_OR,
  VARIANT_SHR_ASSIGN,
- VARIANT_SHR_TINY
+ VARIANT_SHR_TINY,
+ VARIANT_SHL_ASSIGN,
+ VARIANT_ROL_ASSIGN,
+ VARIANT_SHL_ALIGNED,
+ VARIANT_SHR_ALIGNED,
+ VARIANT_ROL_ALIGNED,
+ VARIANT_SHL_SUBLIMB,
+ VARIANT_SHR_SUBLIMB,
+ VARIANT_ROL_SUBLIMB
 } ShiftVariant;
 
 const char *funname[]={
@@ -35,69 +43,99 @@ const char *funname[]={
   "ror(x,i)",
   "shl_or(x,i)",
   "shr_assign(x,i)",
-  "shr_tiny(copy(x),i)"
+  "shr_tiny(copy(x),i)",
+  "shl_assign(x,i)",
+  "rol_assign(x,i)",
+  "shl(x,k*UINT_BITS)",
+  "shr(x,k*UINT_BITS)",
+  "rol(x,k*UINT_BITS)",
+  "shl(x,j<UINT_BITS)",
+  "shr(x,j<UINT_BITS)",
+  "rol(x,j<UINT_BITS)"
 };
 
+/**
+ * Shift amounts of a variant: mixed (all the bit positions),
+ * limb-aligned (whole cells), or sub-limb (less than a cell).
+ * @param fun Variant.
+ * @param n Output: number of shift amounts.
+ * @param step Output: difference of the shift amounts.
+ */
+static void shift_amounts_(unsigned int fun, buint_size_t *n, buint_size_t *step) {
+ if (VARIANT_SHL_ALIGNED <= fun && fun <= VARIANT_ROL_ALIGNED) {
+  *n = BIGUINT128_CELLS;
+  *step = UINT_BITS;
+ } else if (VARIANT_SHL_SUBLIMB <= fun) {
+  *n = UINT_BITS;
+  *step = 1;
+ } else {
+  *n = 128U;
+  *step = 1;
+ }
+}
+
 static unsigned int exec_function_loop_(unsigned int ai, unsigned int fun, const StandardArgs *args, UInt *chkval) {
  BigUInt128 a = get_value_by_level(ai, args->levels);
  uint32_t loop_cnt;
+ buint_size_t amount_n, step;
+ shift_amounts_(fun, &amount_n, &step);
 
  for (loop_cnt = 0; loop_cnt < args->loops;) {
-  if (fun == VARIANT_SHL) {
-   for (buint_size_t i = 0; i < 128U; ++i) {
-    BigUInt128 res = biguint128_shl(&a, i);
+  if (fun == VARIANT_SHL || fun == VARIANT_SHL_ALIGNED || fun == VARIANT_SHL_SUBLIMB) {
+   for (buint_size_t i = 0; i < amount_n; ++i) {
+    BigUInt128 res = biguint128_shl(&a, i * step);
     chkval[0]+=res.dat[BIGUINT128_CELLS-1]>>(UINT_BITS-1);
     ++loop_cnt;
    }
   } else if (fun == VARIANT_SHL_OR_NEW) {
-   for (buint_size_t i = 0; i < 128U; ++i) {
+   for (buint_size_t i = 0; i < amount_n; ++i) {
     BigUInt128 res = biguint128_ctor_default();
     biguint128_shl_or(&res, &a, i);
     chkval[0]+=res.dat[BIGUINT128_CELLS-1]>>(UINT_BITS-1);
     ++loop_cnt;
    }
   } else if (fun == VARIANT_SHL_TINY) {
-   for (buint_size_t i = 0; i < 128U; ++i) {
+   for (buint_size_t i = 0; i < amount_n; ++i) {
     BigUInt128 res = biguint128_ctor_copy(&a);
     biguint128_shl_tiny(&res, i);
     chkval[0]+=res.dat[BIGUINT128_CELLS-1]>>(UINT_BITS-1);
     ++loop_cnt;
    }
-  } else if (fun == VARIANT_SHR) {
-   for (buint_size_t i = 0; i < 128U; ++i) {
-    BigUInt128 res = biguint128_shr(&a, i);
+  } else if (fun == VARIANT_SHR || fun == VARIANT_SHR_ALIGNED || fun == VARIANT_SHR_SUBLIMB) {
+   for (buint_size_t i = 0; i < amount_n; ++i) {
+    BigUInt128 res = biguint128_shr(&a, i * step);
     chkval[0]+=res.dat[0]&1;
     ++loop_cnt;
    }
   } else if (fun == VARIANT_SHR_ASSIGN_CP) {
-   for (buint_size_t i = 0; i < 128U; ++i) {
+   for (buint_size_t i = 0; i < amount_n; ++i) {
     BigUInt128 res = biguint128_ctor_copy(&a);
     biguint128_shr_assign(&res, i);
     chkval[0]+=res.dat[0]&1;
     ++loop_cnt;
    }
   } else if (fun == VARIANT_SHR_TINY) {
-   for (buint_size_t i = 0; i < 128U; ++i) {
+   for (buint_size_t i = 0; i < amount_n; ++i) {
     BigUInt128 res = biguint128_ctor_copy(&a);
     biguint128_shr_tiny(&res, i);
     chkval[0]+=res.dat[0]&1;
     ++loop_cnt;
    }
-  } else if (fun == VARIANT_ROL) {
-   for (buint_size_t i = 0; i < 128U; ++i) {
-    BigUInt128 res = biguint128_rol(&a, i);
+  } else if (fun == VARIANT_ROL || fun == VARIANT_ROL_ALIGNED || fun == VARIANT_ROL_SUBLIMB) {
+   for (buint_size_t i = 0; i < amount_n; ++i) {
+    BigUInt128 res = biguint128_rol(&a, i * step);
     chkval[0]+=res.dat[0]&1;
     ++loop_cnt;
    }
   } else if (fun == VARIANT_ROR) {
-   for (buint_size_t i = 0; i < 128U; ++i) {
+   for (buint_size_t i = 0; i < amount_n; ++i) {
     BigUInt128 res = biguint128_ror(&a, i);
     chkval[0]+=res.dat[0]&1;
     ++loop_cnt;
    }
   } else if (fun == VARIANT_SHL_OR) {
    BigUInt128 res = biguint128_ctor_default();
-   for (buint_size_t i = 0; i < 128U; ++i) {
+   for (buint_size_t i = 0; i < amount_n; ++i) {
     biguint128_shl_or(&res, &a, i);
     chkval[0]+=res.dat[BIGUINT128_CELLS-1]>>(UINT_BITS-1);
     ++loop_cnt;
@@ -106,12 +144,27 @@ static unsigned int exec_function_loop_(unsigned int ai, unsigned int fun, const
    BigUInt128 res = biguint128_ctor_copy(&a);
    buint_size_t lzca = biguint128_lzc(&a);
    buint_size_t xc = lzca==0?0:lzca-1;
-   for (buint_size_t i = 0; i < 128U; ++i) {
+   for (buint_size_t i = 0; i < amount_n; ++i) {
     res.dat[xc]|=1;   // fill it with something similar to a
     biguint128_shr_assign(&res, i);
     chkval[0]+=res.dat[0]&1;
     ++loop_cnt;
    }
+  } else if (fun == VARIANT_SHL_ASSIGN) {
+   BigUInt128 res = biguint128_ctor_copy(&a);
+   for (buint_size_t i = 0; i < amount_n; ++i) {
+    res.dat[0]|=1;   // fill it with something similar to a
+    biguint128_shl_assign(&res, i);
+    chkval[0]+=res.dat[BIGUINT128_CELLS-1]>>(UINT_BITS-1);
+    ++loop_cnt;
+   }
+  } else if (fun == VARIANT_ROL_ASSIGN) {
+   BigUInt128 res = biguint128_ctor_copy(&a);
+   for (buint_size_t i = 0; i < amount_n; ++i) {
+    biguint128_rol_assign(&res, i);
+    chkval[0]+=res.dat[0]&1;
+    ++loop_cnt;
+   }
   }
   biguint128_add_tiny(&a, (UInt)args->diff[0]);
  }
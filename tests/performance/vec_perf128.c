@@ -0,0 +1,124 @@
+/***************************************
+ This program compares the elementwise
+ operations of BigUIntVec128 (struct of
+ arrays, SIMD kernels) with the loops of
+ the corresponding BigUInt128 functions
+ over arrays of values.
+ Each supported vector kernel is run.
+ Usage: vec_perf128 [elements [rounds]]
+***************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "biguintvec128.h"
+#include "vec_kernel.h"
+#include "test_common.h"
+
+#define ELEMENTS 4000U	// not a power of 2: the rows would map to the same cache sets
+#define ROUNDS 4096U
+
+typedef enum {
+ FUN_ADD = 0,
+ FUN_SUB,
+ FUN_LT,
+ FUN_MAX
+} VecFun;
+
+const char *funname[] = {
+ "add",
+ "sub",
+ "lt",
+ "max"
+};
+
+static void print_result(clock_t t_begin, clock_t t_end, const char *impl, const char *op, unsigned long cnt, UInt chk) {
+ clock_t dt = t_end - t_begin;
+ fprintf(stdout, "=== %lu %s() operations, %s (%u bit UInt cells) ===\n", cnt, op, impl, (unsigned int)(8 * sizeof(UInt)));
+ fprintf(stdout, "Elapsed time: %ld us,\t%.1f op/s\t(check: %u)\n", (long)dt, (1000000.0 * cnt) / dt, (unsigned int)chk);
+}
+
+static void exec_scalar_(VecFun fun, const BigUInt128 *a, const BigUInt128 *b, BigUInt128 *r, buint_bool *res, unsigned int n, unsigned int rounds) {
+ UInt chk = 0;
+ clock_t t0 = clock();
+ for (unsigned int j = 0; j < rounds; ++j) {
+  for (unsigned int k = 0; k < n; ++k) {
+   if (fun == FUN_ADD) {
+    r[k] = biguint128_add(&a[k], &b[k]);
+   } else if (fun == FUN_SUB) {
+    r[k] = biguint128_sub(&a[k], &b[k]);
+   } else if (fun == FUN_LT) {
+    res[k] = biguint128_lt(&a[k], &b[k]);
+   } else {
+    r[k] = biguint128_lt(&a[k], &b[k]) ? b[k] : a[k];
+   }
+  }
+  chk += fun == FUN_LT ? res[j % n] : r[j % n].dat[0];
+ }
+ clock_t t1 = clock();
+ print_result(t0, t1, "biguint128 loop", funname[fun], (unsigned long)n * rounds, chk);
+}
+
+static void exec_vector_(VecFun fun, const BigUIntVec128 *a, const BigUIntVec128 *b, BigUIntVec128 *r, buint_bool *res, unsigned int rounds) {
+ UInt chk = 0;
+ clock_t t0 = clock();
+ for (unsigned int j = 0; j < rounds; ++j) {
+  if (fun == FUN_ADD) {
+   biguintvec128_add(r, a, b);
+  } else if (fun == FUN_SUB) {
+   biguintvec128_sub(r, a, b);
+  } else if (fun == FUN_LT) {
+   biguintvec128_lt(res, a, b);
+  } else {
+   biguintvec128_max(r, a, b);
+  }
+  chk += fun == FUN_LT ? res[j % a->len] : r->dat[j % a->len];
+ }
+ clock_t t1 = clock();
+ char impl[32];
+ snprintf(impl, sizeof(impl), "vector, %s kernel", vec_kernel_name(vec_kernel_active));
+ print_result(t0, t1, impl, funname[fun], (unsigned long)a->len * rounds, chk);
+}
+
+int main(int argc, char *argv[]) {
+ unsigned int n = argc > 1 ? (unsigned int)atoi(argv[1]) : ELEMENTS;
+ unsigned int rounds = argc > 2 ? (unsigned int)atoi(argv[2]) : ROUNDS;
+ if (n == 0 || rounds == 0) {
+  fprintf(stderr, "Usage: %s [elements [rounds]]\n", argv[0]);
+  return 1;
+ }
+ BigUInt128 *a = malloc(n * sizeof(BigUInt128));
+ BigUInt128 *b = malloc(n * sizeof(BigUInt128));
+ BigUInt128 *r = malloc(n * sizeof(BigUInt128));
+ buint_bool *res = malloc(n * sizeof(buint_bool));
+ UInt *dat = malloc(3 * BIGUINTVEC128_SIZE(n) * sizeof(UInt));
+ if (!a || !b || !r || !res || !dat) {
+  fprintf(stderr, "Out of memory\n");
+  return 1;
+ }
+ for (unsigned int k = 0; k < n; ++k) {
+  fill_random(a[k].dat, BIGUINT128_CELLS);
+  fill_random(b[k].dat, BIGUINT128_CELLS);
+ }
+ BigUIntVec128 va = biguintvec128_ctor(dat, n);
+ BigUIntVec128 vb = biguintvec128_ctor(dat + BIGUINTVEC128_SIZE(n), n);
+ BigUIntVec128 vr = biguintvec128_ctor(dat + 2 * BIGUINTVEC128_SIZE(n), n);
+ biguintvec128_gather(&va, a);
+ biguintvec128_gather(&vb, b);
+
+ const VecKernel kernels[] = {VEC_KERNEL_GENERIC, VEC_KERNEL_SSE2, VEC_KERNEL_AVX2};
+ for (unsigned int fun = FUN_ADD; fun <= FUN_MAX; ++fun) {
+  exec_scalar_((VecFun)fun, a, b, r, res, n, rounds);
+  for (unsigned int j = 0; j < ARRAYSIZE(kernels); ++j) {
+   if (vec_kernel_set(kernels[j])) exec_vector_((VecFun)fun, &va, &vb, &vr, res, rounds);
+  }
+  vec_kernel_set(VEC_KERNEL_AUTO);
+ }
+
+ free(dat);
+ free(res);
+ free(r);
+ free(b);
+ free(a);
+ return 0;
+}
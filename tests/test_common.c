@@ -1,6 +1,7 @@
 #include <stdio.h>
 #include <string.h>
 #include "uint_types.h"
+#include "uint.h"
 #include "test_common.h"
 
 bool negate_strcpy(char *dest, size_t dest_size, const char *src, size_t src_len) {
@@ -39,3 +40,32 @@ bool check_cstr(const char *fun, const CStr *expected, size_t actual_n, const ch
  }
  return pass;
 }
+
+UInt next_random(void) {
+ static unsigned long long state = 88172645463325252ULL;
+ state ^= state << 13;
+ state ^= state >> 7;
+ state ^= state << 17;
+ return (UInt)state;
+}
+
+void fill_random(UInt *a, buint_size_t n) {
+ for (buint_size_t i = 0; i < n; ++i) a[i] = next_random();
+}
+
+void mul_ref(UInt *res, const UInt *a, buint_size_t na, const UInt *b, buint_size_t nb, buint_size_t ncols) {
+ memset(res, 0, ncols * sizeof(UInt));
+ for (buint_size_t i = 0; i < na && i < ncols; ++i) {
+  UInt carry = 0;
+  for (buint_size_t j = 0; j < nb && i + j < ncols; ++j) {
+   UIntPair p = uint_mul(a[i], b[j]);
+   buint_bool c = 0;
+   uint_add_assign(&res[i + j], p.second, &c);
+   uint_add_assign(&p.first, 0, &c);
+   c = 0;
+   uint_add_assign(&res[i + j], carry, &c);
+   carry = p.first + c;
+  }
+  if (i + nb < ncols) res[i + nb] = carry;
+ }
+}
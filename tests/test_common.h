@@ -3,6 +3,7 @@
 
 #include <stdbool.h>
 #include <stddef.h>
+#include "uint_types.h"
 
 #define NEG_SIGN '-'
 
@@ -29,5 +30,12 @@ static inline bool cstr_to_bool(const CStr *a) {
 
 bool check_cstr(const char *fun, const CStr *expected, size_t actual_n, const char *actual);
 
+// pseudo-random cell values (xorshift, the same sequence in each run)
+UInt next_random(void);
+void fill_random(UInt *a, buint_size_t n);
+
+// reference multiplication (operand scanning): the lowest ncols cells of a * b
+void mul_ref(UInt *res, const UInt *a, buint_size_t na, const UInt *b, buint_size_t nb, buint_size_t ncols);
+
 #endif /* TEST_COMMON_H */
 
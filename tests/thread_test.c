@@ -0,0 +1,126 @@
+#include <stdio.h>
+#include <stdbool.h>
+#include <string.h>
+#include <assert.h>
+#include <pthread.h>
+
+#include "biguint128.h"
+#include "bigdecimal128.h"
+#include "test_common.h"
+
+#define BIGUINT_BITS 128
+#define BIGDECCAP ((BIGUINT_BITS / 10 + 1) * 3 + 1)
+#define BUFLEN (BIGDECCAP + 3)
+#define DIGEST_LEN (6 * BUFLEN)
+
+#define THREADS_N 8U
+#define ROUNDS_N 50U
+
+const CStr input[] = {
+ STR("0"),
+ STR("1"),
+ STR("-3.3"),
+ STR("123456789.123"),
+ STR("-0.0000007"),
+ STR("98765432109876543210.98765"),
+ STR("170141183460469231731687303715884105727"),
+ STR("-17014118346046923173168730371588410572.7"),
+ STR("7.0000000000000000000000000000000000001")
+};
+
+#define INPUT_N ARRAYSIZE(input)
+#define JOBS_N (INPUT_N * INPUT_N)
+
+typedef char Digest[DIGEST_LEN];
+
+typedef struct {
+ Digest res[JOBS_N];
+ bool fail;
+} Worker;
+
+static BigDecimal128 values[INPUT_N];
+static Worker workers[THREADS_N];
+static Worker reference;
+
+/**
+ * Appends the printed form of a (and the validity flag) to the digest.
+ */
+static size_t append_dec_(char *buf, size_t len, const BigDecimal128 *a, buint_bool valid) {
+ len += bigdecimal128_print(a, buf + len, DIGEST_LEN - len - 2);
+ buf[len++] = valid ? ';' : '!';
+ return len;
+}
+
+/**
+ * Runs the operations with former lazily initialized state
+ * (decimal printing, safe division, precision tuning and safe addition) on every pair of inputs.
+ */
+static void run_jobs_(Digest *res) {
+ for (size_t ai = 0; ai < INPUT_N; ++ai) {
+  for (size_t bi = 0; bi < INPUT_N; ++bi) {
+   char *buf = res[ai * INPUT_N + bi];
+   size_t len = 0;
+   BigDecimal128 r;
+   memset(buf, 0, DIGEST_LEN);
+   if (!biguint128_eqz(&values[bi].val)) {
+    buint_bool valid = bigdecimal128_div_safe(&r, &values[ai], &values[bi], 9);
+    len = append_dec_(buf, len, &r, valid);
+   }
+   buint_bool valid = bigdecimal128_prec_safe(&r, &values[ai], values[bi].prec);
+   len = append_dec_(buf, len, &r, valid);
+   valid = bigdecimal128_prec_safe(&r, &values[ai], values[ai].prec + (UInt)bi);
+   len = append_dec_(buf, len, &r, valid);
+   valid = bigdecimal128_add_safe(&r, &values[ai], &values[bi]);
+   len = append_dec_(buf, len, &r, valid);
+   len += biguint128_print_dec(&values[ai].val, buf + len, DIGEST_LEN - len - 1);
+  }
+ }
+}
+
+static void *worker_main_(void *arg) {
+ Worker *w = (Worker *)arg;
+ Digest tmp[JOBS_N];
+ run_jobs_(w->res);
+ for (unsigned int ri = 1; ri < ROUNDS_N; ++ri) {
+  run_jobs_(tmp);
+  w->fail |= memcmp(tmp, w->res, sizeof(tmp)) != 0;
+ }
+ return NULL;
+}
+
+bool test_concurrent_calls() {
+ bool fail = false;
+ pthread_t threads[THREADS_N];
+ // the threads start on cold state: none of the tested functions has been called yet
+ for (unsigned int ti = 0; ti < THREADS_N; ++ti) {
+  if (pthread_create(&threads[ti], NULL, worker_main_, &workers[ti]) != 0) {
+   fprintf(stderr, "pthread_create failed: thread #%u\n", ti);
+   return false;
+  }
+ }
+ for (unsigned int ti = 0; ti < THREADS_N; ++ti) {
+  pthread_join(threads[ti], NULL);
+ }
+ run_jobs_(reference.res);
+ for (unsigned int ti = 0; ti < THREADS_N; ++ti) {
+  if (workers[ti].fail) {
+   fprintf(stderr, "thread #%u: results differ between rounds\n", ti);
+   fail = true;
+  }
+  for (size_t ji = 0; ji < JOBS_N; ++ji) {
+   if (memcmp(workers[ti].res[ji], reference.res[ji], DIGEST_LEN) != 0) {
+    fprintf(stderr, "thread #%u, job #%u: expected %s, actual %s\n", ti, (unsigned int)ji, reference.res[ji], workers[ti].res[ji]);
+    fail = true;
+   }
+  }
+ }
+ return !fail;
+}
+
+int main() {
+ for (size_t i = 0; i < INPUT_N; ++i) {
+  values[i] = bigdecimal128_ctor_cstream(input[i].str, input[i].len);
+ }
+ assert(test_concurrent_calls());
+ return 0;
+}
@@ -149,6 +149,95 @@ bool test_uint_mul() {
  return !fail;
 }
 
+bool test_uint_div() {
+ const UInt MAX = -1;
+ const UInt HIBIT = (UInt)1 << (sizeof(UInt) * 8 - 1);
+ UInt samples_b[] = {
+  HIBIT, HIBIT + 1, MAX - 1, MAX
+ };
+ UInt samples_ahi[] = {
+  0, 1, HIBIT - 1
+ };
+ UInt samples_alo[] = {
+  0, 1, HIBIT, MAX
+ };
+ bool fail = false;
+
+ // check: b * q + r == a && r < b
+ for (unsigned int b_i=0; b_i<sizeof(samples_b)/sizeof(UInt); ++b_i) {
+  for (unsigned int h_i=0; h_i<sizeof(samples_ahi)/sizeof(UInt); ++h_i) {
+   for (unsigned int l_i=0; l_i<sizeof(samples_alo)/sizeof(UInt); ++l_i) {
+    UIntPair a = {samples_ahi[h_i], samples_alo[l_i]};
+    UIntPair qr = uint_div(a, samples_b[b_i]);
+    UIntPair prod = uint_mul(qr.first, samples_b[b_i]);
+    buint_bool carry = 0;
+    prod.second = uint_add(prod.second, qr.second, &carry);
+    prod.first += carry;
+
+    if (!(prod.first == a.first && prod.second == a.second && qr.second < samples_b[b_i])) {
+     fprintf(stderr, "%s: uint_div([%" PRIuint ",%" PRIuint "],%" PRIuint ") returned invalid value: [%" PRIuint ",%" PRIuint "]\n",
+      __func__, a.first, a.second, samples_b[b_i], qr.first, qr.second);
+     fail = true;
+    }
+   }
+  }
+ }
+ return !fail;
+}
+
+bool test_uint_inverse() {
+ const UInt MAX = -1;
+ const UInt HIBIT = (UInt)1 << (sizeof(UInt) * 8 - 1);
+ UInt samples[] = {
+  1, 3, 5, 7, 10001, HIBIT - 1, HIBIT + 1, MAX - 2, MAX
+ };
+ bool fail = false;
+ for (unsigned int i=0; i<sizeof(samples)/sizeof(UInt); ++i) {
+  UInt inv = uint_inverse(samples[i]);
+  if ((UInt)(samples[i] * inv) != 1) {
+   fprintf(stderr, "%s: uint_inverse(%" PRIuint ") returned invalid value: %" PRIuint "\n", __func__, samples[i], inv);
+   fail = true;
+  }
+ }
+ return !fail;
+}
+
+bool test_uint_div_pre() {
+ const UInt MAX = -1;
+ const UInt HIBIT = (UInt)1 << (sizeof(UInt) * 8 - 1);
+ UInt samples_b[] = {
+  HIBIT, HIBIT + 1, MAX - 1, MAX
+ };
+ UInt samples_ahi[] = {
+  0, 1, HIBIT - 1
+ };
+ UInt samples_alo[] = {
+  0, 1, HIBIT, MAX
+ };
+ bool fail = false;
+
+ // check: b * q + r == a && r < b
+ for (unsigned int b_i=0; b_i<sizeof(samples_b)/sizeof(UInt); ++b_i) {
+  for (unsigned int h_i=0; h_i<sizeof(samples_ahi)/sizeof(UInt); ++h_i) {
+   for (unsigned int l_i=0; l_i<sizeof(samples_alo)/sizeof(UInt); ++l_i) {
+    UIntPair a = {samples_ahi[h_i], samples_alo[l_i]};
+    UIntPair qr = uint_div_pre(a, samples_b[b_i], uint_reciprocal(samples_b[b_i]));
+    UIntPair prod = uint_mul(qr.first, samples_b[b_i]);
+    buint_bool carry = 0;
+    prod.second = uint_add(prod.second, qr.second, &carry);
+    prod.first += carry;
+
+    if (!(prod.first == a.first && prod.second == a.second && qr.second < samples_b[b_i])) {
+     fprintf(stderr, "%s: uint_div_pre([%" PRIuint ",%" PRIuint "],%" PRIuint ") returned invalid value: [%" PRIuint ",%" PRIuint "]\n",
+      __func__, a.first, a.second, samples_b[b_i], qr.first, qr.second);
+     fail = true;
+    }
+   }
+  }
+ }
+ return !fail;
+}
+
 // This test assumes 32bit wide UInt type
 bool test_uint_spsh32() {
  if (sizeof(UInt)!=4) {
@@ -275,11 +364,51 @@ bool test_uint_spsh64() {
 }
 #endif
 
+bool test_uint_bitscan() {
+ bool fail = false;
+ const buint_size_t bits = 8 * sizeof(UInt);
+ // single bits, with all the bits below, resp. above it set, too
+ for (buint_size_t i = 0; i < bits; ++i) {
+  UInt single = (UInt)1 << i;
+  UInt below = single | (single - 1);
+  UInt above = ~(single - 1);
+  if (uint_msb(single) != i || uint_msb(below) != i || uint_msb(above) != bits - 1) {
+   fprintf(stderr, "%s: uint_msb failed at bit %u\n", __func__, (unsigned int)i);
+   fail = true;
+  }
+  if (uint_clz(single) != bits - 1 - i || uint_clz(below) != bits - 1 - i || uint_clz(above) != 0) {
+   fprintf(stderr, "%s: uint_clz failed at bit %u\n", __func__, (unsigned int)i);
+   fail = true;
+  }
+  if (uint_ctz(single) != i || uint_ctz(below) != 0 || uint_ctz(above) != i) {
+   fprintf(stderr, "%s: uint_ctz failed at bit %u\n", __func__, (unsigned int)i);
+   fail = true;
+  }
+  if (uint_popcount(single) != 1 || uint_popcount(below) != i + 1 || uint_popcount(above) != bits - i) {
+   fprintf(stderr, "%s: uint_popcount failed at bit %u\n", __func__, (unsigned int)i);
+   fail = true;
+  }
+ }
+ if (uint_msb(0) != 0 || uint_clz(0) != bits || uint_ctz(0) != bits || uint_popcount(0) != 0) {
+  fprintf(stderr, "%s: bit scanning of 0 failed\n", __func__);
+  fail = true;
+ }
+ if (uint_popcount((UInt)0xA5A5A5A5U) != 16 || uint_popcount((UInt)-1 / 3) != bits / 2) {
+  fprintf(stderr, "%s: uint_popcount of patterns failed\n", __func__);
+  fail = true;
+ }
+ return !fail;
+}
+
 int main(int argc, char **argv) {
  assert(test_uint_add());
  assert(test_uint_sub());
  assert(test_uint_mul());
+ assert(test_uint_div());
+ assert(test_uint_div_pre());
+ assert(test_uint_inverse());
  assert(test_uint_spsh32());
+ assert(test_uint_bitscan());
 #ifdef USE_UINT64_T
  assert(test_uint_spsh64());
 #endif